@@ -0,0 +1,305 @@
+// Benchmark suite of the message, array and DSP paths, run on the `offline`
+// backend so that no audio device is needed. Prints a JSON report, or writes
+// it to the file given as argument.
+//
+// node bench/index.js [--fast] [report.json]
+//
+// `--fast` processes audio as fast as possible instead of at the pace of the
+// sample rate, which measures the bindings rather than the audio scheduling.
+
+const path = require("path");
+const fs = require("fs");
+const os = require("os");
+const pd = require("../");
+
+const patchesPath = path.join(__dirname, "pd");
+
+const args = process.argv.slice(2);
+const fast = args.includes("--fast");
+const output = args.find((arg) => !arg.startsWith("--"));
+
+const config = {
+  numInputChannels: 0,
+  numOutputChannels: 2,
+  sampleRate: 48000,
+  ticks: 1,
+  backend: "offline",
+  realtime: !fast,
+};
+
+const NUM_MESSAGES = 10000;
+const NUM_ROUND_TRIPS = 1000;
+const NUM_OPEN_CLOSE = 200;
+const ARRAY_SIZES = [64, 1024, 16384, 262144, 1048576];
+// number of floats copied for each array size, bounds the duration
+const ARRAY_TOTAL = 1 << 25;
+const DSP_DURATION = 2000;
+
+function now() {
+  return Number(process.hrtime.bigint()) / 1e6; // ms
+}
+
+function sleep(ms) {
+  return new Promise((resolve) => setTimeout(resolve, ms));
+}
+
+function log(...msg) {
+  console.error("[bench]", ...msg);
+}
+
+// resolve with the `count`th message received on `channel`
+function receive(channel, count = 1) {
+  return new Promise((resolve) => {
+    let received = 0;
+
+    const callback = (value) => {
+      received += 1;
+
+      if (received === count) {
+        pd.unsubscribe(channel, callback);
+        resolve(value);
+      }
+    };
+
+    pd.subscribe(channel, callback);
+  });
+}
+
+function percentile(sorted, p) {
+  const index = Math.min(sorted.length - 1, Math.floor(sorted.length * p));
+  return sorted[index];
+}
+
+function summarize(durations) {
+  const sorted = durations.slice().sort((a, b) => a - b);
+  const sum = sorted.reduce((acc, value) => acc + value, 0);
+
+  return {
+    count: sorted.length,
+    mean: sum / sorted.length,
+    p50: percentile(sorted, 0.5),
+    p99: percentile(sorted, 0.99),
+    max: sorted[sorted.length - 1],
+  };
+}
+
+// -------------------------------------------------------------
+// MESSAGES
+// -------------------------------------------------------------
+
+async function sendThroughput(scheduled) {
+  const fence = receive("bench-float-echo");
+  const time = scheduled ? pd.currentTime + 0.1 : undefined;
+
+  const start = now();
+
+  for (let i = 0; i < NUM_MESSAGES; i++) {
+    pd.send("bench-sink", i, time);
+  }
+
+  const enqueued = now();
+  // echoed back once the messages above have been delivered
+  pd.send("bench-float", -1, scheduled ? time + 0.001 : undefined);
+  await fence;
+
+  const delivered = now();
+
+  return {
+    messages: NUM_MESSAGES,
+    enqueueRate: NUM_MESSAGES / ((enqueued - start) / 1000),
+    deliveryRate: NUM_MESSAGES / ((delivered - start) / 1000),
+    duration: delivered - start,
+  };
+}
+
+async function receiveThroughput() {
+  const done = receive("bench-out", NUM_MESSAGES);
+  const start = now();
+
+  // pd emits every message in a single tick
+  pd.send("bench-burst", NUM_MESSAGES);
+  await done;
+
+  const duration = now() - start;
+
+  return {
+    messages: NUM_MESSAGES,
+    rate: NUM_MESSAGES / (duration / 1000),
+    duration,
+  };
+}
+
+async function roundTrip() {
+  const durations = [];
+
+  for (let i = 0; i < NUM_ROUND_TRIPS; i++) {
+    const echo = receive("bench-float-echo");
+    const start = now();
+
+    pd.send("bench-float", i);
+    await echo;
+
+    durations.push(now() - start);
+  }
+
+  return summarize(durations);
+}
+
+// -------------------------------------------------------------
+// ARRAYS
+// -------------------------------------------------------------
+
+function arrayBandwidth() {
+  const results = [];
+
+  ARRAY_SIZES.forEach((size) => {
+    const data = new Float32Array(size);
+    const iterations = Math.max(10, Math.floor(ARRAY_TOTAL / size));
+    const bytes = size * Float32Array.BYTES_PER_ELEMENT * iterations;
+
+    for (let i = 0; i < size; i++) {
+      data[i] = Math.random();
+    }
+
+    let start = now();
+
+    for (let i = 0; i < iterations; i++) {
+      pd.writeArray("bench-array", data, size, 0);
+    }
+
+    const write = now() - start;
+    start = now();
+
+    for (let i = 0; i < iterations; i++) {
+      pd.readArray("bench-array", data, size, 0);
+    }
+
+    const read = now() - start;
+
+    results.push({
+      size,
+      iterations,
+      write: { mbps: bytes / 1e6 / (write / 1000), call: write / iterations },
+      read: { mbps: bytes / 1e6 / (read / 1000), call: read / iterations },
+    });
+  });
+
+  return results;
+}
+
+// -------------------------------------------------------------
+// PATCHES
+// -------------------------------------------------------------
+
+function openCloseRate() {
+  const durations = [];
+
+  for (let i = 0; i < NUM_OPEN_CLOSE; i++) {
+    const start = now();
+    const patch = pd.openPatch("dsp-sine.pd", patchesPath);
+    pd.closePatch(patch);
+    durations.push(now() - start);
+  }
+
+  const stats = summarize(durations);
+  stats.rate = 1000 / stats.mean;
+
+  return stats;
+}
+
+// -------------------------------------------------------------
+// DSP
+// -------------------------------------------------------------
+
+async function dspTime(filename) {
+  const patch = filename ? pd.openPatch(filename, patchesPath) : null;
+
+  // let the dsp graph settle before resetting the statistics
+  await sleep(100);
+  pd.resetDspLoad();
+  await sleep(DSP_DURATION);
+
+  const load = pd.getDspLoad();
+
+  if (patch) {
+    pd.closePatch(patch);
+  }
+
+  return {
+    patch: filename || null,
+    callbacks: load.callbacks,
+    mean: load.mean,
+    p50: load.p50,
+    p99: load.p99,
+    p999: load.p999,
+    maxDuration: load.maxDuration,
+    average: load.average,
+  };
+}
+
+// -------------------------------------------------------------
+// MAIN
+// -------------------------------------------------------------
+
+async function main() {
+  if (!pd.init(config, true)) {
+    throw new Error("pd.init failed");
+  }
+
+  const report = {
+    date: new Date().toISOString(),
+    node: process.version,
+    platform: `${os.platform()} ${os.arch()}`,
+    cpu: os.cpus().length > 0 ? os.cpus()[0].model : null,
+    config,
+    results: {},
+  };
+
+  const results = report.results;
+  const echo = pd.openPatch("echo.pd", patchesPath);
+  const array = pd.openPatch("array.pd", patchesPath);
+
+  log("send throughput");
+  results.send = {
+    immediate: await sendThroughput(false),
+    scheduled: await sendThroughput(true),
+  };
+
+  log("receive throughput");
+  results.receive = await receiveThroughput();
+
+  log("round trip latency");
+  results.roundTrip = await roundTrip();
+
+  log("array bandwidth");
+  results.arrays = arrayBandwidth();
+
+  pd.closePatch(array);
+  pd.closePatch(echo);
+
+  log("patch open / close rate");
+  results.openClose = openCloseRate();
+
+  log("dsp time");
+  results.dsp = [];
+
+  for (const filename of [null, "dsp-sine.pd", "dsp-bank.pd"]) {
+    results.dsp.push(await dspTime(filename));
+  }
+
+  pd.destroy();
+
+  const json = JSON.stringify(report, null, 2);
+
+  if (output) {
+    fs.writeFileSync(output, json + "\n");
+    log(`report written to ${output}`);
+  } else {
+    console.log(json);
+  }
+}
+
+main().catch((err) => {
+  console.error(err);
+  process.exit(1);
+});
@@ -0,0 +1,81 @@
+// Microbenchmark of the interleave / deinterleave conversions used by the
+// `processRaw` path, for one pd block (64 frames) and common channel counts.
+//
+// g++ -O2 -std=c++11 bench/interleave.cc src/Interleave.cc -o interleave-bench
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "../src/Interleave.h"
+
+using namespace node_lib_pd;
+
+typedef void (*convert_t)(const float *, float *, int, int);
+
+static const int BLOCK_SIZE = 64;
+static const int ITERATIONS = 200000;
+
+static double bench(convert_t convert, const float *src, float *dest,
+                    int numChannels) {
+  auto start = std::chrono::steady_clock::now();
+
+  for (int i = 0; i < ITERATIONS; i++) {
+    convert(src, dest, numChannels, BLOCK_SIZE);
+  }
+
+  std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / ITERATIONS;
+}
+
+int main() {
+  const int channels[] = { 1, 2, 4, 8, 16, 24, 32, 64 };
+
+  printf("implementation: %s, %d frames, ns per block\n\n",
+         interleave::implementation(), BLOCK_SIZE);
+  printf("%8s | %12s %12s | %12s %12s\n", "channels", "interleave",
+         "(scalar)", "deinterleave", "(scalar)");
+
+  for (int numChannels : channels) {
+    const int size = numChannels * BLOCK_SIZE;
+    std::vector<float> src(size);
+    std::vector<float> dest(size);
+    std::vector<float> expected(size);
+
+    for (int i = 0; i < size; i++) {
+      src[i] = (float)rand() / RAND_MAX;
+    }
+
+    // check the dispatched implementation against the scalar one
+    interleave::interleave(src.data(), dest.data(), numChannels, BLOCK_SIZE);
+    interleave::interleaveScalar(src.data(), expected.data(), numChannels,
+                                 BLOCK_SIZE);
+
+    if (dest != expected) {
+      printf("interleave mismatch for %d channels\n", numChannels);
+      return 1;
+    }
+
+    interleave::deinterleave(src.data(), dest.data(), numChannels, BLOCK_SIZE);
+    interleave::deinterleaveScalar(src.data(), expected.data(), numChannels,
+                                   BLOCK_SIZE);
+
+    if (dest != expected) {
+      printf("deinterleave mismatch for %d channels\n", numChannels);
+      return 1;
+    }
+
+    printf("%8d | %12.1f %12.1f | %12.1f %12.1f\n", numChannels,
+           bench(&interleave::interleave, src.data(), dest.data(), numChannels),
+           bench(&interleave::interleaveScalar, src.data(), dest.data(),
+                 numChannels),
+           bench(&interleave::deinterleave, src.data(), dest.data(),
+                 numChannels),
+           bench(&interleave::deinterleaveScalar, src.data(), dest.data(),
+                 numChannels));
+  }
+
+  return 0;
+}
@@ -9,6 +9,29 @@
         "./src/PaWrapper.cc",
         "./src/PdReceiver.cc",
         "./src/PdWrapper.cc",
+        "./src/TickScheduler.cc",
+        "./src/BlockAdapter.cc",
+        "./src/Interleave.cc",
+        "./src/ThreadSettings.cc",
+        "./src/MemoryLock.cc",
+        "./src/AudioStats.cc",
+        "./src/Histogram.cc",
+        "./src/DspLoad.cc",
+        "./src/LatencyTracer.cc",
+        "./src/ChannelFilters.cc",
+        "./src/SubscriptionTable.cc",
+        "./src/Mailboxes.cc",
+        "./src/LogRing.cc",
+        "./src/ArrayTasks.cc",
+        "./src/ArrayChangeTracker.cc",
+        "./src/PatchCache.cc",
+        "./src/PatchTasks.cc",
+        "./src/PatchWorkers.cc",
+        "./src/InitWorker.cc",
+        "./src/TaskCompletions.cc",
+        "./src/TickTaskWorker.cc",
+        "./src/SoundfileReader.cc",
+        "./src/SoundfileWorker.cc",
         "./src/BackgroundProcess.c",
       ],
       "include_dirs" : [
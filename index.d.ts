@@ -11,13 +11,54 @@ declare module "node-libpd" {
    * throttle the messages sent to and received by `pd`, i.e. more ticks means less
    * precision in the treatement of the messages. A value of 1 or 2 is generally
    * good enough even in constrained platforms such as the RPi.
+   * @member `timeout` Time (in ms) to wait for the audio stream to start before
+   * giving up.
+   * @member `inputDevice` Index of the input device, defaults to the default
+   * input device of the host API.
+   * @member `outputDevice` Index of the output device, defaults to the default
+   * output device of the host API.
+   * @member `inputLatency` Suggested input latency (in seconds), defaults to the
+   * device `defaultLowInputLatency`.
+   * @member `outputLatency` Suggested output latency (in seconds), defaults to
+   * the device `defaultLowOutputLatency`.
+   * @member `hostApi` Name or index of the host API whose default devices
+   * should be used.
+   * @member `streamFlags` `portaudio` stream flags.
+   * @member `framesPerBuffer` Size of the host audio buffers, defaults to
+   * `blockSize * ticks`. A multiple of the `pd` block size overrides `ticks`, any
+   * other value (or 0 to let `portaudio` choose) goes through an internal block
+   * adapter which adds one block of latency.
+   * @member `processRaw` Process `pd` with `libpd_process_raw`, converting between
+   * the interleaved `portaudio` buffers and the non-interleaved `pd` ones with SIMD
+   * instructions (AVX or SSE, selected at runtime). Mostly useful with large
+   * channel counts.
+   * @member `threads` Scheduling of the audio callback (`dsp`) and message
+   * (`message`) threads. Failures (e.g. missing permissions) leave the thread
+   * unchanged and are reported by `getThreadSettings`.
+   * @member `lockMemory` Lock the memory of the process (Linux only) and pre-fault
+   * the audio and message thread stacks. Use 'future' to lock every page as it is
+   * mapped, otherwise pages are locked again when patches are opened.
+   * @member `xrunEvents` Push the xruns reported by `portaudio` to the
+   * `PdInternalMessages.Xrun` channel, see {@link XrunEvent}.
+   * @member `receiveQueue` Bound the queue of messages received from `pd`,
+   * unbounded by default, see {@link QueueConfig}.
+   * @member `sendQueue` Bound the queue of messages sent to `pd`.
+   * @member `log` Options of the log ring delivering the lines printed by `pd`
+   * and the native messages on the `PdInternalMessages.Log` channel, see
+   * {@link LogConfig}.
+   * @member `backend` 'offline' runs the audio callback on silent buffers from a
+   * thread of its own instead of opening an audio device.
+   * @member `realtime` With the offline backend, process the buffers at the pace
+   * of the sample rate, false runs as fast as possible.
    *
    * @default
    * {
    *  numInputChannels: 1,
    *  numOutputChannels: 2,
    *  sampleRate: 4800,
-   *  ticks: 1
+   *  ticks: 1,
+   *  timeout: 5000,
+   *  streamFlags: ['clipOff']
    * }
    */
   interface PdInitConfig {
@@ -25,6 +66,219 @@ declare module "node-libpd" {
     numOutputChannels?: number;
     sampleRate?: number;
     ticks?: number;
+    timeout?: number;
+    inputDevice?: number;
+    outputDevice?: number;
+    inputLatency?: number;
+    outputLatency?: number;
+    hostApi?: string | number;
+    streamFlags?: Array<PaStreamFlag>;
+    framesPerBuffer?: number;
+    processRaw?: boolean;
+    threads?: {
+      dsp?: ThreadSettings;
+      message?: ThreadSettings;
+    };
+    lockMemory?: boolean | "future";
+    xrunEvents?: boolean;
+    receiveQueue?: QueueConfig;
+    sendQueue?: QueueConfig;
+    log?: LogConfig;
+    backend?: "portaudio" | "offline";
+    realtime?: boolean;
+  }
+
+  type LogLevel = "error" | "warn" | "info" | "debug";
+
+  /**
+   * Options of the log ring.
+   *
+   * @interface LogConfig
+   * @member `capacity` Maximum number of pending lines, the oldest are
+   * overwritten. Defaults to 256.
+   * @member `level` Minimum severity of the kept lines. Defaults to 'info'.
+   * @member `maxRate` Maximum number of lines per second and per source, 0 for
+   * unlimited. Defaults to 50.
+   * @member `console` Minimum severity of the native messages also written to
+   * stdout, or false. Defaults to 'warn'.
+   */
+  interface LogConfig {
+    capacity?: number;
+    level?: LogLevel;
+    maxRate?: number;
+    console?: LogLevel | false;
+  }
+
+  /**
+   * Line delivered on the `PdInternalMessages.Log` channel.
+   *
+   * @interface LogEntry
+   * @member `time` Time of the line in ms since epoch.
+   * @member `source` `pd`, `pd:<name>` for `[print <name>]`, `portaudio` or
+   * `node-libpd`.
+   */
+  interface LogEntry {
+    time: number;
+    level: LogLevel;
+    source: string;
+    message: string;
+  }
+
+  /**
+   * Bound of a message queue.
+   *
+   * @interface QueueConfig
+   * @member `capacity` Maximum number of queued messages, 0 for unbounded.
+   * @member `policy` Applied to a message pushed to a full queue: `dropNewest`
+   * discards it, `dropOldest` discards the oldest queued message and `coalesce`
+   * replaces the last queued message of the same channel (or discards the
+   * pushed message if there is none).
+   */
+  interface QueueConfig {
+    capacity?: number;
+    policy?: QueueOverflowPolicy;
+  }
+
+  type QueueOverflowPolicy = "dropNewest" | "dropOldest" | "coalesce";
+
+  interface QueueStats {
+    capacity: number | null;
+    policy: QueueOverflowPolicy;
+    depth: number;
+    highWater: number;
+    pushed: number;
+    dropped: number;
+    coalesced: number;
+  }
+
+  /**
+   * Xrun reported by `portaudio` to the audio callback.
+   *
+   * @interface XrunEvent
+   * @member `frame` Stream frame at the start of the callback.
+   * @member `time` Stream time (in seconds) at the start of the callback.
+   * @member `flags` Status flags of the callback.
+   */
+  interface XrunEvent {
+    frame: number;
+    time: number;
+    flags: Array<
+      "inputUnderflow" | "inputOverflow" | "outputUnderflow" | "outputOverflow"
+    >;
+  }
+
+  /**
+   * Counters of the status flags reported by `portaudio` since init.
+   *
+   * @interface AudioStats
+   * @member `xruns` Number of callbacks reporting an xrun.
+   * @member `events` Most recent (up to 64) xruns.
+   */
+  interface AudioStats {
+    callbacks: number;
+    frames: number;
+    inputUnderflows: number;
+    inputOverflows: number;
+    outputUnderflows: number;
+    outputOverflows: number;
+    primingOutputs: number;
+    xruns: number;
+    events: Array<XrunEvent>;
+  }
+
+  /**
+   * Scheduling of a thread.
+   *
+   * @interface ThreadSettings
+   * @member `policy` Scheduling policy.
+   * @member `priority` Priority, clamped to the range of the policy.
+   * @member `cpus` Cpus the thread may run on (Linux only).
+   */
+  interface ThreadSettings {
+    policy?: "fifo" | "rr" | "other";
+    priority?: number;
+    cpus?: Array<number>;
+  }
+
+  /**
+   * Scheduling of a thread as read back once the settings have been applied.
+   *
+   * @interface ThreadReport
+   * @member `priorityError` Why the policy or priority could not be applied.
+   * @member `affinityError` Why the cpus could not be applied.
+   */
+  interface ThreadReport {
+    policy: "fifo" | "rr" | "other" | number;
+    priority: number;
+    cpus: Array<number>;
+    priorityError: string | null;
+    affinityError: string | null;
+  }
+
+  type PaStreamFlag =
+    | "clipOff"
+    | "ditherOff"
+    | "neverDropInput"
+    | "primeOutputBuffersUsingStreamCallback";
+
+  /**
+   * Latencies and sample rate achieved by the audio stream.
+   *
+   * @interface PaStreamInfo
+   * @member `inputLatency` Input latency (in seconds).
+   * @member `outputLatency` Output latency (in seconds).
+   * @member `totalLatency` Sum of the input and output latencies.
+   * @member `sampleRate` Actual sample rate of the stream.
+   * @member `inputDevice` Index of the input device, -1 if none.
+   * @member `outputDevice` Index of the output device, -1 if none.
+   * @member `hostApi` Index of the host API of the stream.
+   * @member `framesPerBuffer` Requested host buffer size, 0 if unspecified.
+   * @member `blockAdapter` Whether host buffers are adapted to `pd` blocks.
+   */
+  interface PaStreamInfo {
+    inputLatency: number;
+    outputLatency: number;
+    totalLatency: number;
+    sampleRate: number;
+    inputDevice: number;
+    outputDevice: number;
+    hostApi: number;
+    framesPerBuffer: number;
+    blockAdapter: boolean;
+  }
+
+  /**
+   * Filters applied to the messages of a channel before they reach js.
+   *
+   * @interface SubscribeOptions
+   * @member `coalesce` Only dispatch the last message received while the
+   * previous one waits for the event loop.
+   * @member `maxRate` Maximum number of messages per second, the last message
+   * received in between is dispatched once the interval has elapsed.
+   * @member `deadband` Drop float messages that differ from the last accepted
+   * value by less than `deadband`.
+   */
+  interface SubscribeOptions {
+    coalesce?: "latest" | "none";
+    maxRate?: number;
+    deadband?: number;
+  }
+
+  /**
+   * Durations (in ms) of each step of the initialization.
+   *
+   * @interface PdInitTimings
+   * @member `pdInit` Initialization of `pd`.
+   * @member `paInitialize` Call to `Pa_Initialize`.
+   * @member `streamOpen` Opening and starting the audio stream.
+   * @member `firstCallback` From the start of the stream to the end of the first
+   * audio callback.
+   */
+  interface PdInitTimings {
+    pdInit: number;
+    paInitialize: number;
+    streamOpen: number;
+    firstCallback: number;
   }
 
   /**
@@ -67,6 +321,8 @@ declare module "node-libpd" {
    */
   enum PdInternalMessages {
     Print = "print",
+    Log = "log",
+    Xrun = "xrun",
   }
 
   type PdCallback = (...args: any[]) => void;
@@ -89,6 +345,156 @@ declare module "node-libpd" {
    */
   function init(options?: PdInitConfig, computeAudio?: boolean): boolean;
 
+  /**
+   * Same as `init`, but `pd` and the audio stream are started from a worker
+   * thread so that the event loop is not blocked.
+   *
+   * @param { PdInitConfig | undefined } options
+   * @param { boolean } computeAudio Optional: enable `pd` audio computation. Default is `true`.
+   *
+   * @returns { Promise<PdInitTimings> } Resolved once the first audio callback has run,
+   * rejected if the stream does not start within `options.timeout`.
+   */
+  function initAsync(
+    options?: PdInitConfig,
+    computeAudio?: boolean
+  ): Promise<PdInitTimings>;
+
+  /**
+   * Retrieve the durations (in ms) of each step of the initialization.
+   *
+   * @returns { PdInitTimings }
+   */
+  function getInitTimings(): PdInitTimings;
+
+  /**
+   * Retrieve the latencies and sample rate achieved by the audio stream, as
+   * reported by `portaudio`.
+   *
+   * @returns { PaStreamInfo | undefined } `undefined` if the stream is not opened.
+   */
+  function getStreamInfo(): PaStreamInfo | undefined;
+
+  /**
+   * Retrieve the scheduling of the audio callback and message threads.
+   *
+   * @returns Each thread report is `null` until the thread is running.
+   */
+  function getThreadSettings(): {
+    dsp: ThreadReport | null;
+    message: ThreadReport | null;
+  };
+
+  /**
+   * Retrieve the counters of the status flags reported by `portaudio` to the
+   * audio callback since init, and the most recent xrun events.
+   */
+  function getAudioStats(): AudioStats;
+
+  /**
+   * Retrieve the load of the audio callback, i.e. the time spent processing a
+   * buffer relative to its duration (1 means the deadline is reached), and the
+   * distribution of the processing durations since init or `resetDspLoad`.
+   *
+   * @returns Durations are in ms, percentiles are precise to ~6%.
+   */
+  function getDspLoad(): {
+    current: number;
+    average: number;
+    max: number;
+    callbacks: number;
+    mean: number;
+    p50: number;
+    p99: number;
+    p999: number;
+    maxDuration: number;
+  };
+
+  /**
+   * Reset the statistics returned by `getDspLoad`. Applied by the next audio
+   * callback.
+   */
+  function resetDspLoad(): void;
+
+  /**
+   * Latency (in ms) of one stage of the traced messages.
+   *
+   * @interface LatencyStats
+   */
+  interface LatencyStats {
+    count: number;
+    mean: number;
+    p50: number;
+    p99: number;
+    p999: number;
+    max: number;
+  }
+
+  /**
+   * Enable or disable the tracing of the latency of the messages sent without
+   * scheduled time.
+   */
+  function enableLatencyTracing(enabled?: boolean): void;
+
+  /**
+   * Retrieve the latency of the traced messages for each stage of their journey:
+   * - `send`: from `pd.send` to the background thread taking the message out
+   *   of the send queue
+   * - `inject`: delivery of the message to libpd, including the wait for the
+   *   audio thread to release `pd`
+   * - `pd`: from the start of the injection of a message to the first
+   *   message `pd` sends back while delivering it, i.e. the reply of echo
+   *   patches. Replies sent later (e.g. after a `[delay]`) are not traced
+   * - `dispatch`: from the message received from `pd` to the js callback
+   */
+  function getLatencyStats(): {
+    enabled: boolean;
+    send: LatencyStats;
+    inject: LatencyStats;
+    pd: LatencyStats;
+    dispatch: LatencyStats;
+  };
+
+  /**
+   * Reset the statistics returned by `getLatencyStats`.
+   */
+  function resetLatencyStats(): void;
+
+  /**
+   * Retrieve the metrics of the queue of messages received from `pd` and of the
+   * queue of messages sent to `pd`.
+   */
+  function getQueueStats(): {
+    receive: QueueStats;
+    send: QueueStats;
+  };
+
+  /**
+   * Retrieve the metrics of the log ring, `dropped` counts the lines overwritten
+   * before being delivered and `suppressed` the lines discarded by the rate
+   * limit or the minimum level.
+   */
+  function getLogStats(): {
+    capacity: number;
+    depth: number;
+    pushed: number;
+    dropped: number;
+    suppressed: number;
+  };
+
+  /**
+   * Retrieve the state of the memory lock requested with `lockMemory`.
+   *
+   * @returns `lockedBytes` is the memory locked by the whole process (-1 if
+   * unknown), `error` the reason of a failed lock.
+   */
+  function getMemoryLock(): {
+    locked: boolean;
+    future: boolean;
+    lockedBytes: number;
+    error: string | null;
+  };
+
   /**
    * Destroy the `pd` instance. You basically want to do that when your program
    * exits to clean things up, be aware that any call to the `pd` instance after
@@ -111,7 +517,8 @@ declare module "node-libpd" {
   function getDevicesCount(): number;
 
   /**
-   * Get the audio devices descriptions.
+   * Get the audio devices descriptions. `portaudio` is initialized on first call
+   * (or when the audio stream is started) and the device list is cached.
    *
    * @returns { Array<PaDeviceDescription> } An `array` of audio devices descriptions.
    * See also {@link PaDeviceDescription}
@@ -160,6 +567,13 @@ declare module "node-libpd" {
    */
   function getDeviceAtIndex(index: number): PaDeviceDescription | undefined;
 
+  /**
+   * Initialize `portaudio` again to refresh the cached device list.
+   *
+   * @returns { boolean } `false` if the audio stream is running, `true` otherwise.
+   */
+  function refreshDevices(): boolean;
+
   /**
    * Open a `pd` patch instance. As the same patch can be opened several times,
    * think of it as a kind of poly with a nice API, be careful to use patch.$0
@@ -191,6 +605,93 @@ declare module "node-libpd" {
    */
   function closePatch(patch: Patch): Patch | undefined;
 
+  /**
+   * Open a `pd` patch instance from the audio thread, between two ticks, so
+   * that the event loop is not blocked while a large patch is loaded. When
+   * the patch cache is enabled, the file is read and parsed in a worker
+   * thread beforehand and the audio thread only instantiates it. The audio
+   * stream must be running.
+   *
+   * @param  { string } name Filename of the patch.
+   * @param { string } pathname Absolute path to the `pd` patches.
+   * @returns { Promise<Patch> } Instance of the patch.
+   */
+  function openPatchAsync(name: string, pathname: string): Promise<Patch>;
+  /**
+   * Open a `pd` patch instance from the audio thread, between two ticks.
+   *
+   * @param { string } pathname Absolute path to the `pd` patch
+   * @returns { Promise<Patch> } Instance of the patch.
+   * @overload
+   */
+  function openPatchAsync(pathname: string): Promise<Patch>;
+  function openPatchAsync(...args: string[]): Promise<Patch>;
+
+  /**
+   * Close a `pd` patch instance from the audio thread, between two ticks.
+   *
+   * @param { Patch } patch The patch to close.
+   *
+   * @returns { Promise<Patch> } The closed patch.
+   */
+  function closePatchAsync(patch: Patch): Promise<Patch>;
+
+  /**
+   * Options of `createPatchPool`.
+   *
+   * @interface PatchPoolOptions
+   * @member `grow` If > 0, number of instances opened in a worker thread when
+   * the pool runs out of free instances.
+   */
+  interface PatchPoolOptions {
+    grow?: number;
+  }
+
+  /**
+   * Pool of instances of a patch, as created by `createPatchPool`.
+   *
+   * @interface PatchPool
+   * @member `size` Number of instances in the pool.
+   * @member `available` Number of free instances in the pool.
+   */
+  interface PatchPool {
+    readonly size: number;
+    readonly available: number;
+    /**
+     * Take a free instance from the pool, `null` if none is available.
+     */
+    acquire(): Patch | null;
+    /**
+     * Give an instance back to the pool.
+     */
+    release(patch: Patch): boolean;
+    /**
+     * Open new instances in a worker thread and add them to the pool, the
+     * Promise is rejected if they can't all be opened.
+     */
+    grow(num: number): Promise<number>;
+    /**
+     * Close all the instances of the pool.
+     */
+    destroy(): void;
+  }
+
+  /**
+   * Open several instances of a patch up front (e.g. the voices of a
+   * synthesizer), so that no patch is opened nor closed at note time.
+   *
+   * @param { string } pathname Absolute path to the `pd` patch.
+   * @param { number } size Number of instances to open.
+   * @param { PatchPoolOptions | undefined } options
+   *
+   * @returns { PatchPool | null } The pool, or `null` if the patch can't be opened.
+   */
+  function createPatchPool(
+    pathname: string,
+    size: number,
+    options?: PatchPoolOptions
+  ): PatchPool | null;
+
   /**
    * Add a directory to the `pd` search paths, for loading libraries, etc.
    *
@@ -203,6 +704,46 @@ declare module "node-libpd" {
    */
   function clearSearchPath(): void;
 
+  /**
+   * Statistics of the patch cache.
+   *
+   * @interface PatchCacheStats
+   * @member `enabled` Whether the cache is enabled.
+   * @member `entries` Number of files in the cache.
+   * @member `hits` Number of patches opened from the cache.
+   * @member `misses` Number of patches read from disk.
+   * @member `invalidations` Number of cached files that changed on disk.
+   */
+  interface PatchCacheStats {
+    enabled: boolean;
+    entries: number;
+    hits: number;
+    misses: number;
+    invalidations: number;
+  }
+
+  /**
+   * Keep the content of the opened patch files in memory, so that opening the
+   * same file again skips reading and parsing it. A cached file is read again
+   * when its modification time or its size changed. Disabling the cache also
+   * clears it.
+   *
+   * @param { boolean | undefined } [enabled=true]
+   */
+  function enablePatchCache(enabled?: boolean): void;
+
+  /**
+   * Remove all the files from the patch cache.
+   */
+  function clearPatchCache(): void;
+
+  /**
+   * Retrieve the statistics of the patch cache.
+   *
+   * @returns { PatchCacheStats }
+   */
+  function getPatchCacheStats(): PatchCacheStats;
+
   /**
    * Send a named message to the `pd` backend.
    *
@@ -222,9 +763,16 @@ declare module "node-libpd" {
    * Subscribe to named events sendtby a `pd` patch.
    *
    * @param { string } channel Channel name corresponding to the `pd` send name.
-   * @param { PdCallback } callback Callback to execute when an event is received.
+   * @param { PdCallback } callback Callback to execute when an event is received,
+   * called with the payload of the message and the channel.
+   * @param { SubscribeOptions } [options] Filters applied natively to the messages
+   * of the channel, shared by all its callbacks and set by its first subscription.
    */
-  function subscribe(channel: string, callback: PdCallback): void;
+  function subscribe(
+    channel: string,
+    callback: PdCallback,
+    options?: SubscribeOptions
+  ): void;
 
   /**
    * Unsubscribe from named events sent by a `pd` patch.
@@ -235,6 +783,33 @@ declare module "node-libpd" {
    */
   function unsubscribe(channel: string, callback?: PdCallback): void;
 
+  /**
+   * Latest value sent by `pd` on a channel, polled from shared memory.
+   *
+   * @interface Mailbox
+   * @member `channel` The channel of the mailbox.
+   * @member `count` Number of messages received since the mailbox has been opened.
+   * @member `read` Return the last float or list (symbols read as `NaN`, bangs
+   * as empty lists) received on the channel, `null` if none, or the previously
+   * read value if `pd` keeps writing the mailbox.
+   * @member `close` Release the mailbox.
+   */
+  interface Mailbox {
+    readonly channel: string;
+    readonly count: number;
+    read(): number | number[] | null;
+    close(): void;
+  }
+
+  /**
+   * Open a mailbox on a channel, the latest value sent by `pd` on the channel
+   * can then be polled at any time without callback nor queueing. Lists are
+   * truncated to 14 values.
+   *
+   * @param { string } channel Channel name corresponding to the `pd` send name.
+   */
+  function mailbox(channel: string): Mailbox;
+
   /**
    * Write values into a `pd` array. Be careful with the size of the `pd` arrays
    * (default to `100`) in your patches.
@@ -257,6 +832,38 @@ declare module "node-libpd" {
     offset?: number
   ): boolean;
 
+  /**
+   * Options of `writeArrayAtomic`.
+   *
+   * @interface WriteArrayAtomicOptions
+   * @member `offset` Index of the `pd` array at which the data should be written.
+   * @member `time` Audio time at which the data should be applied, the values are
+   * applied at the first tick starting after this time.
+   */
+  interface WriteArrayAtomicOptions {
+    offset?: number;
+    time?: number;
+  }
+
+  /**
+   * Write values into a `pd` array at a tick boundary. The values are staged and
+   * then copied by the audio thread between two `pd` ticks, therefore the DSP
+   * never reads a partially written array.
+   *
+   * @param { string } name Name of the `pd` array.
+   * @param { Float32Array } data `Float32Array` containing the data to be written
+   * in the `pd` array.
+   * @param { WriteArrayAtomicOptions | undefined } options
+   *
+   * @returns { boolean } `true` if the operation has been scheduled, `false` if the
+   * array does not exist or is too small.
+   */
+  function writeArrayAtomic(
+    name: string,
+    data: Float32Array,
+    options?: WriteArrayAtomicOptions
+  ): boolean;
+
   /**
    * Read values from a `pd` array.
    *
@@ -277,6 +884,133 @@ declare module "node-libpd" {
     offset?: number
   ): boolean;
 
+  /**
+   * One entry of `readArrays`.
+   *
+   * @interface ArrayRead
+   * @member `name` Name of the `pd` array.
+   * @member `target` `Float32Array` to populate from `pd` array values.
+   * @member `offset` Index of the first value to read in the `pd` array.
+   * @member `length` Number of values to read, defaults to `target.length`.
+   */
+  interface ArrayRead {
+    name: string;
+    target: Float32Array;
+    offset?: number;
+    length?: number;
+  }
+
+  /**
+   * Read several `pd` arrays in one call. All copies are done at once between
+   * two `pd` ticks, so that they reflect the same moment of the audio stream.
+   *
+   * @param { ArrayRead[] } reads
+   *
+   * @returns { boolean[] } Success of each read.
+   */
+  function readArrays(reads: ArrayRead[]): boolean[];
+
+  /**
+   * Options of `writeArrayAsync` and `readArrayAsync`.
+   *
+   * @interface ArrayTransferOptions
+   * @member `offset` Index in the `pd` array at which the transfer starts.
+   * @member `chunkSize` Number of values copied per tick.
+   * @member `onProgress` Function called with the progression of the transfer
+   * (between 0 and 1).
+   */
+  interface ArrayTransferOptions {
+    offset?: number;
+    chunkSize?: number;
+    onProgress?: (progress: number) => void;
+  }
+
+  /**
+   * Write values into a `pd` array without blocking. The copy is split in chunks
+   * applied between successive `pd` ticks.
+   *
+   * @param { string } name Name of the `pd` array.
+   * @param { Float32Array } data Data to be written in the `pd` array, must not be
+   * modified until the `Promise` is settled.
+   * @param { ArrayTransferOptions | undefined } options
+   *
+   * @returns { Promise<Float32Array> } Resolved with `data` once the transfer is done.
+   */
+  function writeArrayAsync(
+    name: string,
+    data: Float32Array,
+    options?: ArrayTransferOptions
+  ): Promise<Float32Array>;
+
+  /**
+   * Read values from a `pd` array without blocking. The copy is split in chunks
+   * applied between successive `pd` ticks.
+   *
+   * @param { string } name Name of the `pd` array.
+   * @param { Float32Array } data `Float32Array` to populate, must not be used until
+   * the `Promise` is settled.
+   * @param { ArrayTransferOptions | undefined } options
+   *
+   * @returns { Promise<Float32Array> } Resolved with `data` once the transfer is done.
+   */
+  function readArrayAsync(
+    name: string,
+    data: Float32Array,
+    options?: ArrayTransferOptions
+  ): Promise<Float32Array>;
+
+  /**
+   * Options of `loadSoundfile`.
+   *
+   * @interface LoadSoundfileOptions
+   * @member `channel` Channel of the soundfile to load.
+   * @member `resize` Resize the `pd` array to the length of the soundfile, else
+   * the soundfile is truncated or the remaining of the array is filled with zeros.
+   * @member `onProgress` Function called with the progression of the copy into the
+   * `pd` array (between 0 and 1).
+   */
+  interface LoadSoundfileOptions {
+    channel?: number;
+    resize?: boolean;
+    onProgress?: (progress: number) => void;
+  }
+
+  /**
+   * Description of a soundfile loaded by `loadSoundfile`.
+   *
+   * @interface SoundfileInfos
+   * @member `arrayName` Name of the `pd` array.
+   * @member `numFrames` Number of frames copied from the soundfile.
+   * @member `numChannels` Number of channels of the soundfile.
+   * @member `sampleRate` Sample rate of the soundfile.
+   * @member `channel` Channel that has been loaded.
+   */
+  interface SoundfileInfos {
+    arrayName: string;
+    numFrames: number;
+    numChannels: number;
+    sampleRate: number;
+    channel: number;
+  }
+
+  /**
+   * Load a WAV or AIFF soundfile into a `pd` array. The file is decoded in a
+   * background thread and copied into the `pd` array by chunks, each chunk
+   * holding the `pd` lock for a short while. With `resize`, the views over the
+   * array are detached when the load starts.
+   *
+   * @param { string } arrayName Name of the `pd` array.
+   * @param { string } pathname Path to the soundfile.
+   * @param { LoadSoundfileOptions | undefined } options
+   *
+   * @returns { Promise<SoundfileInfos> }
+   */
+  function loadSoundfile(
+    arrayName: string,
+    pathname: string,
+    options?: LoadSoundfileOptions
+  ): Promise<SoundfileInfos>;
+
   /**
    * Fill a `pd` array with a given value.
    *
@@ -294,6 +1028,88 @@ declare module "node-libpd" {
    */
   function arraySize(name: string): number;
 
+  /**
+   * Live view over the storage of a `pd` array.
+   *
+   * @interface ArrayView
+   * @member `name` Name of the `pd` array.
+   * @member `data` `Float32Array` sharing its memory with the `pd` array.
+   * @member `stride` Distance between two values of the `pd` array in `data`.
+   * @member `length` Number of values in the `pd` array.
+   * @member `generation` Generation of the view, see `isValid`.
+   * @member `isValid` `false` if the view has been detached because `pd`
+   * resized or freed the array. Views are checked in the calls that can
+   * change arrays, in `send` and before the messages of `pd` are dispatched.
+   */
+  interface ArrayView {
+    readonly name: string;
+    readonly data: Float32Array;
+    readonly stride: number;
+    readonly length: number;
+    readonly generation: number;
+    readonly isValid: boolean;
+    get(index: number): number;
+    set(index: number, value: number): number;
+  }
+
+  /**
+   * Create a live view over the storage of a `pd` array, values are shared
+   * between javascript and `pd` without any copy. The value at index `i` of
+   * the `pd` array is `view.data[i * view.stride]`.
+   *
+   * @param { string } name The name of the `pd` array.
+   *
+   * @returns { ArrayView | null } The view, or `null` if the array does not exist
+   * or is being resized by `loadSoundfile`.
+   * See also {@link ArrayView}
+   */
+  function arrayView(name: string): ArrayView | null;
+
+  /**
+   * Options of `trackArrayChanges`.
+   *
+   * @interface TrackArrayChangesOptions
+   * @member `compare` Compare the array against a shadow copy on each read, to
+   * detect the writes made from `pd` itself (e.g. `tabwrite~`).
+   */
+  interface TrackArrayChangesOptions {
+    compare?: boolean;
+  }
+
+  /**
+   * Start tracking the changes made to a `pd` array.
+   *
+   * @param { string } name Name of the `pd` array.
+   * @param { TrackArrayChangesOptions | undefined } options
+   */
+  function trackArrayChanges(
+    name: string,
+    options?: TrackArrayChangesOptions
+  ): void;
+
+  /**
+   * Stop tracking the changes made to a `pd` array.
+   *
+   * @param { string } name Name of the `pd` array.
+   */
+  function untrackArrayChanges(name: string): void;
+
+  /**
+   * Copy the values of a tracked `pd` array that changed since the previous
+   * call into `dest`, at their offset in the `pd` array.
+   *
+   * @param { string } name Name of the `pd` array.
+   * @param { Float32Array } dest Buffer at least as large as the `pd` array.
+   *
+   * @returns { Array<[number, number]> | null } The `[offset, length]` spans that
+   * have been copied, or `null` if the array is not tracked, does not exist or
+   * is larger than `dest`.
+   */
+  function readArrayChanges(
+    name: string,
+    dest: Float32Array
+  ): Array<[number, number]> | null;
+
   /**
    * Starts an instance of the `pd` GUI.
    *
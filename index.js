@@ -29,9 +29,185 @@ const path = require("path");
  *  throttle the messages sent to and received by pd, i.e. more ticks means less
  *  precision in the treatement of the messages. A value of 1 or 2 is generally
  *  good enough even in constrained platforms such as the RPi.
+ * @param {Number} [config.timeout=5000] - time (in ms) to wait for the audio
+ *  stream to start before giving up
+ * @param {Number} [config.inputDevice] - index of the input device, defaults
+ *  to the default input device of the host API
+ * @param {Number} [config.outputDevice] - index of the output device, defaults
+ *  to the default output device of the host API
+ * @param {Number} [config.inputLatency] - suggested input latency (in
+ *  seconds), defaults to the device `defaultLowInputLatency`
+ * @param {Number} [config.outputLatency] - suggested output latency (in
+ *  seconds), defaults to the device `defaultLowOutputLatency`
+ * @param {String|Number} [config.hostApi] - name (e.g. 'ALSA', 'JACK Audio
+ *  Connection Kit', 'Core Audio') or index of the host API whose default
+ *  devices should be used
+ * @param {Array<String>} [config.streamFlags=['clipOff']] - PortAudio stream
+ *  flags, any of 'clipOff', 'ditherOff', 'neverDropInput' and
+ *  'primeOutputBuffersUsingStreamCallback'
+ * @param {Number} [config.framesPerBuffer] - size of the host audio buffers,
+ *  defaults to `blockSize * ticks`. A multiple of the pd block size overrides
+ *  `ticks`, any other value (or 0 to let PortAudio choose, possibly variable,
+ *  buffer sizes) goes through an internal block adapter which adds one block
+ *  of latency
+ * @param {Boolean} [config.processRaw=false] - process pd with
+ *  `libpd_process_raw`, converting between the interleaved PortAudio buffers
+ *  and the non-interleaved pd ones with SIMD instructions (AVX or SSE,
+ *  selected at runtime). Mostly useful with large channel counts
+ * @param {Object} [config.threads] - scheduling of the audio callback (`dsp`)
+ *  and message (`message`) threads, each as `{ policy, priority, cpus }` where
+ *  `policy` is one of 'fifo', 'rr' or 'other', `priority` is clamped to the
+ *  range of the policy and `cpus` lists the allowed cpus (Linux only). Failures
+ *  (e.g. missing permissions) leave the thread unchanged and are reported by
+ *  `getThreadSettings`
+ * @param {Boolean|String} [config.lockMemory=false] - lock the memory of the
+ *  process (Linux only) once pd and the audio stream are started, so that the
+ *  audio thread does not page fault after the process has been idle or
+ *  swapped, and pre-fault the audio and message thread stacks. Pages mapped
+ *  afterwards are locked again when patches are opened, use 'future' to lock
+ *  every page as it is mapped instead. Init does not fail if locking is not
+ *  permitted, see `getMemoryLock`
+ * @param {Boolean} [config.xrunEvents=false] - push the xruns reported by
+ *  PortAudio to the `pd.PdInternalMessages.Xrun` ('xrun') channel as
+ *  `{ frame, time, flags }`
+ * @param {String} [config.backend='portaudio'] - 'offline' runs the audio
+ *  callback on silent buffers from a thread of its own instead of opening an
+ *  audio device, e.g. for benchmarks or continuous integration
+ * @param {Boolean} [config.realtime=true] - with the offline backend, process
+ *  the buffers at the pace of the sample rate, false runs as fast as possible
  * @return {Boolean} a boolean defining if pd and portaudio have been properly
  *  initialized
  */
+/**
+ * Same as `init`, but pd and the audio stream are started from a worker thread
+ * so that the event loop is not blocked.
+ *
+ * @function initAsync
+ * @memberof pd
+ * @param {Object} config - same as `init`
+ * @param {Boolean} [computeAudio=true]
+ * @return {Promise<Object>} Promise resolved once the first audio callback has
+ *  run with the durations (in ms) of each init step `{ pdInit, paInitialize,
+ *  streamOpen, firstCallback }`, rejected if the stream does not start within
+ *  `config.timeout`
+ */
+/**
+ * Retrieve the durations (in ms) of each init step: pd init, `Pa_Initialize`,
+ * opening and starting the audio stream, and from the start of the stream to
+ * the end of the first audio callback.
+ *
+ * @function getInitTimings
+ * @memberof pd
+ * @return {Object} `{ pdInit, paInitialize, streamOpen, firstCallback }`
+ */
+/**
+ * Retrieve the latencies (in seconds) and sample rate achieved by the audio
+ * stream, as reported by PortAudio, which may differ from the requested ones.
+ *
+ * @function getStreamInfo
+ * @memberof pd
+ * @return {Object|undefined} `{ inputLatency, outputLatency, totalLatency,
+ *  sampleRate, inputDevice, outputDevice, hostApi, framesPerBuffer,
+ *  blockAdapter }`, undefined if the audio stream is not opened
+ */
+/**
+ * Retrieve the scheduling of the audio callback and message threads as read
+ * back once `config.threads` has been applied.
+ *
+ * @function getThreadSettings
+ * @memberof pd
+ * @return {Object} `{ dsp, message }`, each `null` until the thread is
+ *  running or `{ policy, priority, cpus, priorityError, affinityError }`
+ */
+/**
+ * Retrieve the state of the memory lock requested with `config.lockMemory`.
+ *
+ * @function getMemoryLock
+ * @memberof pd
+ * @return {Object} `{ locked, future, lockedBytes, error }`, `lockedBytes` is
+ *  the memory locked by the whole process (-1 if unknown) and `error` the
+ *  reason of a failed lock
+ */
+/**
+ * Retrieve the counters of the status flags reported by PortAudio to the audio
+ * callback since init, and the most recent xrun events.
+ *
+ * @function getAudioStats
+ * @memberof pd
+ * @return {Object} `{ callbacks, frames, inputUnderflows, inputOverflows,
+ *  outputUnderflows, outputOverflows, primingOutputs, xruns, events }` where
+ *  `events` lists the (up to 64) most recent xruns as `{ frame, time, flags }`
+ */
+/**
+ * Retrieve the load of the audio callback, i.e. the time spent processing a
+ * buffer relative to its duration (1 means the deadline is reached), and the
+ * distribution of the processing durations since init or `resetDspLoad`.
+ *
+ * @function getDspLoad
+ * @memberof pd
+ * @return {Object} `{ current, average, max, callbacks, mean, p50, p99, p999,
+ *  maxDuration }`, durations are in ms and percentiles are precise to ~6%
+ */
+/**
+ * Reset the statistics returned by `getDspLoad`, e.g. to measure a given
+ * patch set. Applied by the next audio callback.
+ *
+ * @function resetDspLoad
+ * @memberof pd
+ */
+/**
+ * Enable or disable the tracing of the latency of the messages sent without
+ * scheduled time, see `getLatencyStats`.
+ *
+ * @function enableLatencyTracing
+ * @memberof pd
+ * @param {Boolean} [enabled=true]
+ */
+/**
+ * Retrieve the latency of the traced messages for each stage of their
+ * journey, i.e. whether the background thread polling, the pd scheduler or
+ * the event loop is the bottleneck:
+ * - `send`: from `pd.send` to the background thread taking the message out
+ *   of the send queue
+ * - `inject`: delivery of the message to libpd, including the wait for the
+ *   audio thread to release pd
+ * - `pd`: from the start of the injection of a message to the first message
+ *   pd sends back while delivering it, i.e. the reply of echo patches such as
+ *   `[r $0-in]-[s $0-out]`. Replies sent later (e.g. after a `[delay]`) are
+ *   not traced
+ * - `dispatch`: from the message received from pd to the js callback
+ *
+ * @function getLatencyStats
+ * @memberof pd
+ * @return {Object} `{ enabled, send, inject, pd, dispatch }`, each stage as
+ *  `{ count, mean, p50, p99, p999, max }` in ms
+ */
+/**
+ * Reset the statistics returned by `getLatencyStats`.
+ *
+ * @function resetLatencyStats
+ * @memberof pd
+ */
+/**
+ * Retrieve the metrics of the queue of messages received from pd (`receive`)
+ * and of the queue of messages sent to pd (`send`), e.g. to size their
+ * `capacity` or check that no messages are lost.
+ *
+ * @function getQueueStats
+ * @memberof pd
+ * @return {Object} `{ receive, send }`, each queue as `{ capacity, policy,
+ *  depth, highWater, pushed, dropped, coalesced }`, `capacity` is null if the
+ *  queue is unbounded
+ */
+/**
+ * Retrieve the metrics of the log ring, `dropped` counts the lines overwritten
+ * before being delivered and `suppressed` the lines discarded by the rate
+ * limit or the minimum level.
+ *
+ * @function getLogStats
+ * @memberof pd
+ * @return {Object} `{ capacity, depth, pushed, dropped, suppressed }`
+ */
 /**
  * Destroy the pd instance. You basically want to do that want your program
  * exists to clean things up, be aware the any call to the pd instance after
@@ -57,6 +233,86 @@ const path = require("path");
  * @memberof pd
  * @param {Patch} patch - a patch instance as retrived by `openPatch`
  */
+/**
+ * Open a pd patch instance from the audio thread, between two ticks, so that
+ * the event loop is not blocked while a large patch is loaded. When the patch
+ * cache is enabled, the file is read and parsed in a worker thread
+ * beforehand and the audio thread only instantiates it. The audio stream
+ * must be running.
+ *
+ * @function openPatchAsync
+ * @memberof pd
+ * @param {String} pathname - absolute path to the pd patch
+ * @return {Promise<Object>} - Promise resolved with the instance of the patch
+ */
+/**
+ * Close a pd patch instance from the audio thread, between two ticks. The
+ * audio stream must be running.
+ *
+ * @function closePatchAsync
+ * @memberof pd
+ * @param {Patch} patch - a patch instance as retrived by `openPatch`
+ * @return {Promise<Object>} - Promise resolved with the closed patch
+ */
+/**
+ * Open several instances of a patch up front (e.g. the voices of a
+ * synthesizer), so that no patch is opened nor closed (and no DSP graph
+ * resorted) at note time. Free instances are tracked natively, `acquire`
+ * and `release` are O(1).
+ *
+ * @function createPatchPool
+ * @memberof pd
+ * @param {String} pathname - absolute path to the pd patch
+ * @param {Number} size - number of instances to open
+ * @param {Object} [options]
+ * @param {Number} [options.grow=0] - if > 0, number of instances opened in
+ *  a worker thread when the pool runs out of free instances
+ * @return {PatchPool|null} - the pool, or null if the patch can't be opened
+ */
+/**
+ * Pool of instances of a patch, as created by `createPatchPool`.
+ * @namespace PatchPool
+ */
+/**
+ * Number of instances in the pool.
+ * @member size
+ * @type {Number}
+ * @readonly
+ * @memberof PatchPool
+ */
+/**
+ * Number of free instances in the pool.
+ * @member available
+ * @type {Number}
+ * @readonly
+ * @memberof PatchPool
+ */
+/**
+ * Take a free instance from the pool.
+ * @function acquire
+ * @memberof PatchPool
+ * @return {Patch|null} - the instance, or null if none is available
+ */
+/**
+ * Give an instance back to the pool.
+ * @function release
+ * @memberof PatchPool
+ * @param {Patch} patch - instance returned by `acquire`
+ * @return {Boolean} - false if the patch is not an acquired instance of the pool
+ */
+/**
+ * Open new instances in a worker thread and add them to the pool.
+ * @function grow
+ * @memberof PatchPool
+ * @param {Number} num - number of instances to add
+ * @return {Promise<Number>} - Promise resolved with the new size of the pool,
+ *  rejected if the instances can't be opened
+ */
+/**
+ * Close all the instances of the pool.
+ * @function destroy
+ * @memberof PatchPool
+ */
 /**
  * Add a directory to the pd search paths, for loading libraries etc.
  *
@@ -70,6 +326,29 @@ const path = require("path");
  * @function clearSearchPath
  * @memberof pd
  */
+/**
+ * Keep the content of the opened patch files in memory, so that opening the
+ * same file again (e.g. many instances of a voice patch) skips reading and
+ * parsing it. A cached file is read again when its modification time or its
+ * size changed. Disabling the cache also clears it.
+ *
+ * @function enablePatchCache
+ * @memberof pd
+ * @param {Boolean} [enabled=true]
+ */
+/**
+ * Remove all the files from the patch cache.
+ *
+ * @function clearPatchCache
+ * @memberof pd
+ */
+/**
+ * Retrieve the statistics of the patch cache.
+ *
+ * @function getPatchCacheStats
+ * @memberof pd
+ * @return {Object} - { enabled, entries, hits, misses, invalidations }
+ */
 /**
  * Send a named message to the pd backend
  * @function send
@@ -89,7 +368,18 @@ const path = require("path");
  * @function subscribe
  * @memberof pd
  * @param {String} channel - channel name corresponding to the pd send name
- * @param {Function} callback - callback to execute when an event is received
+ * @param {Function} callback - callback to execute when an event is received,
+ *  called with the payload of the message and the channel
+ * @param {Object} [options] - filters applied natively to the messages of the
+ *  channel before they reach js, shared by all the callbacks of the channel
+ *  and set by its first subscription
+ * @param {String} [options.coalesce] - 'latest' to only dispatch the last
+ *  message received while the previous one waits for the event loop
+ * @param {Number} [options.maxRate] - maximum number of messages per second,
+ *  the last message received in between is dispatched once the interval has
+ *  elapsed
+ * @param {Number} [options.deadband] - drop float messages that differ from
+ *  the last accepted value by less than `deadband`
  */
 /**
  * Unsubscribe to named events send by a pd patch
@@ -100,6 +390,21 @@ const path = require("path");
  * @param {Function} [callback=null] - callback that should stop receive event.
  *  If null, all callbacks of the channel are removed
  */
+/**
+ * Open a mailbox on a channel, i.e. the latest value sent by pd on the channel
+ * is written in memory shared with js and can be polled at any time (e.g. at
+ * the frame rate of a UI) without callback nor queueing. Floats and lists
+ * (up to 14 values, symbols are read as NaN) are stored, bangs are stored as
+ * empty lists. Mailboxes don't interfere with the subscriptions of the channel.
+ *
+ * @function mailbox
+ * @memberof pd
+ * @param {String} channel - channel name corresponding to the pd send name
+ * @return {Object} - `{ channel, count, read(), close() }`, `read()` returns
+ *  the last float or list received on the channel, null if none (or the
+ *  previously read value if pd keeps writing the mailbox), `count` the
+ *  number of messages received since the mailbox has been opened
+ */
 /**
  * Write values into a pd array. Be carefull with the size of the pd arrays
  * (default to 100) in your patches.
@@ -113,6 +418,47 @@ const path = require("path");
  * @param {Number} [offset=0] - @todo confirm behavior
  * @return {Boolean} true if the operation succeed, false otherwise
  */
+/**
+ * Write values into a pd array at a tick boundary. Contrary to `writeArray`,
+ * the values are staged and then copied by the audio thread between two pd
+ * ticks, therefore objects such as `tabread~` never read a partially written
+ * array.
+ *
+ * @function writeArrayAtomic
+ * @memberof pd
+ * @param {Name} name - name of the pd array
+ * @param {Float32Array} data - Float32Array containing the data to be written
+ *  into the pd array.
+ * @param {Object} [options]
+ * @param {Number} [options.offset=0] - index of the pd array at which the
+ *  data should be written
+ * @param {Number} [options.time=0] - audio time at which the data should be
+ *  applied, the values are applied at the first tick starting after this
+ *  time (i.e. with a precision of 64 samples). If 0 or < currentTime, the
+ *  values are applied at next tick.
+ * @return {Boolean} true if the operation has been scheduled, false if the
+ *  array does not exist or is too small
+ */
+/**
+ * Write values into a pd array without blocking the event loop nor stalling
+ * the audio thread. The copy is split in chunks applied between successive pd
+ * ticks, which makes it suitable for very large arrays (e.g. sound samples).
+ *
+ * @function writeArrayAsync
+ * @memberof pd
+ * @param {Name} name - name of the pd array
+ * @param {Float32Array} data - Float32Array containing the data to be written
+ *  into the pd array, must not be modified until the Promise is settled.
+ * @param {Object} [options]
+ * @param {Number} [options.offset=0] - index of the pd array at which the
+ *  data should be written
+ * @param {Number} [options.chunkSize=16384] - number of values copied per tick
+ * @param {Function} [options.onProgress] - function called with the
+ *  progression of the transfer (between 0 and 1)
+ * @return {Promise<Float32Array>} Promise resolved with `data` once the
+ *  transfer is done, rejected if the array does not exist, is too small, or
+ *  is modified by pd during the transfer
+ */
 /**
  * Read values into a pd array.
  *
@@ -124,6 +470,60 @@ const path = require("path");
  * @param {Number} [offset=0] - @todo confirm behavior
  * @return {Boolean} true if the operation succeed, false otherwise
  */
+/**
+ * Read several pd arrays in one call. All copies are done at once between
+ * two pd ticks, so that they reflect the same moment of the audio stream.
+ *
+ * @function readArrays
+ * @memberof pd
+ * @param {Array<Object>} reads - list of `{ name, target, offset, length }`
+ *  where `target` is the Float32Array to populate, `offset` (default to 0)
+ *  the index of the first value to read in the pd array and `length`
+ *  (default to `target.length`) the number of values to read
+ * @return {Array<Boolean>} success of each read
+ */
+/**
+ * Read values from a pd array without blocking the event loop nor stalling
+ * the audio thread. The copy is split in chunks applied between successive pd
+ * ticks, which makes it suitable for very large arrays.
+ *
+ * @function readArrayAsync
+ * @memberof pd
+ * @param {Name} name - name of the pd array
+ * @param {Float32Array} data - Float32Array to populate from pd array values,
+ *  must not be used until the Promise is settled.
+ * @param {Object} [options]
+ * @param {Number} [options.offset=0] - index of the pd array from which the
+ *  values should be read
+ * @param {Number} [options.chunkSize=16384] - number of values copied per tick
+ * @param {Function} [options.onProgress] - function called with the
+ *  progression of the transfer (between 0 and 1)
+ * @return {Promise<Float32Array>} Promise resolved with `data` once the
+ *  transfer is done
+ */
+/**
+ * Load a WAV or AIFF soundfile (integer or float samples) into a pd array.
+ * The file is decoded in a background thread and copied into the pd array by
+ * chunks, each chunk holding the pd lock for a short while, therefore neither
+ * the event loop nor the audio thread are blocked while loading large files.
+ * With `resize`, the views over the array are detached when the load starts
+ * and `arrayView` returns null until it is done.
+ *
+ * @function loadSoundfile
+ * @memberof pd
+ * @param {Name} arrayName - name of the pd array
+ * @param {String} pathname - path to the soundfile
+ * @param {Object} [options]
+ * @param {Number} [options.channel=0] - channel of the soundfile to load
+ * @param {Boolean} [options.resize=false] - resize the pd array to the length
+ *  of the soundfile, else (as with `soundfiler`) the soundfile is truncated
+ *  or the remaining of the array is filled with zeros
+ * @param {Function} [options.onProgress] - function called with the
+ *  progression of the copy into the pd array (between 0 and 1)
+ * @return {Promise<Object>} Promise resolved with
+ *  `{ arrayName, numFrames, numChannels, sampleRate, channel }` where
+ *  `numFrames` is the number of frames copied from the soundfile
+ */
 /**
  * Fill a pd array with a given value.
  *
@@ -140,6 +540,62 @@ const path = require("path");
  * @param {Name} name - name of the pd array
  * @return {Number} size of the array
  */
+/**
+ * Create a live view over the storage of a pd array, i.e. values are shared
+ * between js and pd without any copy. As pd stores arrays as `t_word` (which
+ * is larger than a float on 64-bit platforms), the value at index `i` of the
+ * pd array is `view.data[i * view.stride]`, `view.get(i)` and `view.set(i, value)`
+ * are provided for convenience.
+ * The view is detached (i.e. `view.data.length` becomes 0) when the library
+ * notices that pd resized or freed the array: in the calls that can change
+ * arrays (e.g. `closePatch`), in `send` and before the messages of pd are
+ * dispatched. `view.isValid` allows to check that the view is still usable.
+ * As pd runs concurrently with js, an array resized by pd itself (e.g. by
+ * `[array size]` or a `resize` message) must not be accessed through a view
+ * until the view has been checked again.
+ * Be aware that, as with `writeArray`, writes are not synchronized with the
+ * audio thread.
+ *
+ * @function arrayView
+ * @memberof pd
+ * @param {Name} name - name of the pd array
+ * @return {Object|null} - { name, data, stride, length, generation, isValid }
+ *  or null if the array does not exists or is being resized by `loadSoundfile`
+ */
+/**
+ * Start tracking the changes made to a pd array, to be retrieved with
+ * `readArrayChanges`. Writes made with `writeArray`, `writeArrayAtomic`,
+ * `writeArrayAsync` and `clearArray` are always tracked. With `compare`, the
+ * array is also compared against a shadow copy on each read, which catches
+ * the writes made from pd itself (e.g. `tabwrite~`) or through an array view,
+ * at the cost of a scan of the array.
+ *
+ * @function trackArrayChanges
+ * @memberof pd
+ * @param {Name} name - name of the pd array
+ * @param {Object} [options]
+ * @param {Boolean} [options.compare=true] - detect the writes made from pd
+ */
+/**
+ * Stop tracking the changes made to a pd array.
+ *
+ * @function untrackArrayChanges
+ * @memberof pd
+ * @param {Name} name - name of the pd array
+ */
+/**
+ * Copy only the values of a tracked pd array that changed since the previous
+ * call (the whole array on first call) into `dest`, at their offset in the
+ * pd array.
+ *
+ * @function readArrayChanges
+ * @memberof pd
+ * @param {Name} name - name of the pd array
+ * @param {Float32Array} dest - buffer at least as large as the pd array
+ * @return {Array|null} - list of the `[offset, length]` spans that have been
+ *  copied, or null if the array is not tracked, does not exists or is larger
+ *  than `dest`
+ */
 
 /**
  * Object representing a patch instance.
@@ -179,36 +635,31 @@ const path = require("path");
 // singleton
 const pd = new nodelibpd.NodePd();
 
-let listenersChannelMap = {};
-
-// global receive function that dispatch to subscriptions
-const dispatch = function (channel, value) {
-  const listeners = listenersChannelMap[channel];
-
-  // as a message can still arrive from pd after `unsubscribe` have been
-  // called because of the inter-processs queue, we have to check that
-  // listeners still exists
-  if (listeners && listeners.length > 0) {
-    listeners.forEach(function (listener) {
-      listener(value);
-    });
-  }
-};
-
 let initialized = false;
 
 pd.PdInternalMessages = {
   Print: "print",
+  // batches of log lines (pd prints and native messages), see `config.log`
+  Log: "log",
+  // xrun events, if `config.xrunEvents` is set
+  Xrun: "xrun",
 };
 
 pd.init = (options = {}, computeAudio = true) => {
   if (!initialized) {
-    initialized = pd._initialize(options, computeAudio, dispatch);
+    initialized = pd._initialize(options, computeAudio);
   }
 
   return initialized;
 };
 
+pd.initAsync = async (options = {}, computeAudio = true) => {
+  const timings = await pd._initializeAsync(options, computeAudio);
+  initialized = true;
+
+  return timings;
+};
+
 // allow both syntax:
 // pd.openPatch(path.join(patchesPath, 'my-patch.pd')); // js friendly
 // pd.openPatch('my-patch.pd', patchesPath); // pd native API for backward compatibility
@@ -223,32 +674,210 @@ pd.openPatch = function (...args) {
   }
 };
 
-pd.subscribe = function (channel, callback) {
-  if (!listenersChannelMap[channel]) {
-    listenersChannelMap[channel] = [];
-    pd._subscribe(channel);
+pd.openPatchAsync = function (...args) {
+  if (args.length === 1) {
+    const filename = path.basename(args[0]);
+    const dirname = path.dirname(args[0]);
+    return pd._openPatchAsync(filename, dirname);
+  } else {
+    const [filename, dirname] = args;
+    return pd._openPatchAsync(filename, dirname);
+  }
+};
+
+// $0 of a pooled instance -> instances of its pool, so that closing the
+// instance directly also removes it from the pool
+const pooledPatches = new Map();
+
+function forgetPooledPatch(patch) {
+  if (patch instanceof Object && pooledPatches.has(patch.$0)) {
+    pooledPatches.get(patch.$0).delete(patch.$0);
+    pooledPatches.delete(patch.$0);
   }
+}
 
-  listenersChannelMap[channel].push(callback);
+function isPoolSize(value) {
+  return Number.isInteger(value) && value >= 0;
+}
+
+pd.closePatch = function (patch) {
+  forgetPooledPatch(patch);
+  return pd._closePatch(patch);
 };
 
-pd.unsubscribe = function (channel, callback = null) {
-  const listeners = listenersChannelMap[channel];
+pd.closePatchAsync = function (patch) {
+  forgetPooledPatch(patch);
+  return pd._closePatchAsync(patch);
+};
+
+pd.createPatchPool = function (pathname, size, options = {}) {
+  const { grow = 0 } = options;
+
+  if (!isPoolSize(size) || !isPoolSize(grow)) {
+    throw new Error(
+      "Invalid Arguments: pd.createPatchPool(pathname, size, { grow=0 }), " +
+        "size and grow must be positive integers"
+    );
+  }
+
+  const filename = path.basename(pathname);
+  const dirname = path.dirname(pathname);
+  const created = pd._createPatchPool(filename, dirname, size);
+
+  if (!created) {
+    return null;
+  }
+
+  const { id } = created;
+  // $0 -> patch, so that acquire does not have to create objects
+  const patches = new Map();
 
-  if (Array.isArray(listeners)) {
-    if (callback !== null) {
-      const index = listeners.indexOf(callback);
+  const addPatch = (patch) => {
+    patches.set(patch.$0, patch);
+    pooledPatches.set(patch.$0, patches);
+  };
 
-      if (index !== -1) {
-        listeners.splice(index, 1);
+  created.patches.forEach(addPatch);
+
+  let growing = false;
+
+  const pool = {
+    get size() {
+      return patches.size;
+    },
+
+    get available() {
+      return pd._patchPoolAvailable(id);
+    },
+
+    acquire() {
+      const $0 = pd._acquirePatch(id);
+
+      if (grow > 0 && !growing && pd._patchPoolAvailable(id) === 0) {
+        pool.grow(grow).catch(() => {});
       }
-    }
 
-    if (callback === null || listeners.length === 0) {
-      pd._unsubscribe(channel);
-      delete listenersChannelMap[channel];
-    }
+      return $0 !== 0 ? patches.get($0) : null;
+    },
+
+    release(patch) {
+      return pd._releasePatch(id, patch.$0);
+    },
+
+    async grow(num) {
+      if (!isPoolSize(num)) {
+        throw new Error(
+          "Invalid Arguments: pool.grow(num), num must be a positive integer"
+        );
+      }
+
+      growing = true;
+
+      try {
+        // opened in a worker thread, only added to the pool if it still exists
+        const added = await pd._growPatchPool(id, num);
+        added.forEach(addPatch);
+      } finally {
+        growing = false;
+      }
+
+      return patches.size;
+    },
+
+    destroy() {
+      pd._destroyPatchPool(id);
+
+      patches.forEach((patch) => {
+        pooledPatches.delete(patch.$0);
+        patch.isValid = false;
+        patch.$0 = 0;
+      });
+
+      patches.clear();
+    },
+  };
+
+  return pool;
+};
+
+pd.subscribe = function (channel, callback, options = null) {
+  pd._subscribe(channel, callback, options);
+};
+
+pd.unsubscribe = function (channel, callback = null) {
+  pd._unsubscribe(channel, callback);
+};
+
+pd.loadSoundfile = function (arrayName, pathname, options = {}) {
+  return pd._loadSoundfile(arrayName, path.resolve(pathname), options);
+};
+
+pd.arrayView = function (name) {
+  const view = pd._arrayView(name);
+
+  if (!view) {
+    return null;
   }
+
+  Object.defineProperty(view, "isValid", {
+    get: () => pd._arrayViewGeneration(name) === view.generation,
+  });
+
+  view.get = (index) => view.data[index * view.stride];
+  view.set = (index, value) => (view.data[index * view.stride] = value);
+
+  return view;
+};
+
+// attempts of `mailbox.read()` while pd is writing before it gives up
+const MAILBOX_READ_RETRIES = 64;
+
+pd.mailbox = function (channel) {
+  const buffer = pd._mailbox(channel);
+  // [sequence, length], cf. `mailbox_t`
+  const header = new Uint32Array(buffer, 0, 2);
+  const values = new Float32Array(buffer, 8);
+  let closed = false;
+  // last consistent value, returned if pd keeps writing
+  let last = null;
+
+  return {
+    channel,
+    get count() {
+      return Atomics.load(header, 0) >>> 1;
+    },
+    read() {
+      for (let i = 0; i < MAILBOX_READ_RETRIES; i++) {
+        const sequence = Atomics.load(header, 0);
+
+        // odd while pd writes the mailbox
+        if (sequence & 1) {
+          continue;
+        }
+
+        if (sequence === 0) {
+          return null;
+        }
+
+        const length = header[1];
+        const value =
+          length === 1 ? values[0] : Array.from(values.subarray(0, length));
+
+        if (Atomics.load(header, 0) === sequence) {
+          last = value;
+          return value;
+        }
+      }
+
+      return last;
+    },
+    close() {
+      if (!closed) {
+        closed = true;
+        pd._closeMailbox(channel);
+      }
+    },
+  };
 };
 
 module.exports = pd;
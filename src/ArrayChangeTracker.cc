@@ -0,0 +1,128 @@
+#include "./ArrayChangeTracker.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace node_lib_pd {
+
+ArrayChangeTracker::ArrayChangeTracker(bool compare)
+  : compare_(compare)
+  , all_(true)
+  , size_(-1)
+{}
+
+bool ArrayChangeTracker::compare() const {
+  return this->compare_;
+}
+
+void ArrayChangeTracker::markDirty(int offset, int length) {
+  if (length > 0) {
+    this->dirty_.push_back(span_t(offset, length));
+  }
+}
+
+void ArrayChangeTracker::markAll() {
+  this->all_ = true;
+}
+
+void ArrayChangeTracker::markPending(std::shared_ptr<TickTask> task,
+                                     int offset, int length) {
+  if (length > 0) {
+    this->pending_.push_back({ task, span_t(offset, length) });
+  }
+}
+
+void ArrayChangeTracker::collect(const t_word *vec, int size, float *dest,
+                                 std::vector<span_t> &spans) {
+  // applied scheduled writes become regular dirty ranges
+  for (auto it = this->pending_.begin(); it != this->pending_.end();) {
+    if (it->task->isDone()) {
+      this->dirty_.push_back(it->span);
+      it = this->pending_.erase(it);
+    } else {
+      it++;
+    }
+  }
+
+  if (size != this->size_) {
+    this->size_ = size;
+    this->all_ = true;
+
+    if (this->compare_) {
+      this->shadow_.resize(size);
+    }
+  }
+
+  std::vector<span_t> changed;
+
+  if (this->all_) {
+    if (size > 0) {
+      changed.push_back(span_t(0, size));
+    }
+  } else {
+    for (auto &span : this->dirty_) {
+      const int start = std::max(span.first, 0);
+      const int end = std::min(span.first + span.second, size);
+
+      if (start < end) {
+        changed.push_back(span_t(start, end - start));
+      }
+    }
+
+    if (this->compare_) {
+      // compare bit patterns, so that NaNs are not reported on each read
+      int start = -1;
+
+      for (int i = 0; i < size; i++) {
+        const bool diff = std::memcmp(&vec[i].w_float, &this->shadow_[i],
+                                      sizeof(float)) != 0;
+
+        if (diff && start == -1) {
+          start = i;
+        } else if (!diff && start != -1) {
+          changed.push_back(span_t(start, i - start));
+          start = -1;
+        }
+      }
+
+      if (start != -1) {
+        changed.push_back(span_t(start, size - start));
+      }
+    }
+
+    // merge overlapping and contiguous spans
+    std::sort(changed.begin(), changed.end());
+    std::vector<span_t> merged;
+
+    for (auto &span : changed) {
+      if (!merged.empty() &&
+          span.first <= merged.back().first + merged.back().second) {
+        const int end = std::max(merged.back().first + merged.back().second,
+                                 span.first + span.second);
+        merged.back().second = end - merged.back().first;
+      } else {
+        merged.push_back(span);
+      }
+    }
+
+    changed.swap(merged);
+  }
+
+  for (auto &span : changed) {
+    for (int i = span.first; i < span.first + span.second; i++) {
+      dest[i] = vec[i].w_float;
+    }
+
+    if (this->compare_) {
+      std::copy(dest + span.first, dest + span.first + span.second,
+                this->shadow_.begin() + span.first);
+    }
+
+    spans.push_back(span);
+  }
+
+  this->all_ = false;
+  this->dirty_.clear();
+}
+
+}; // namespace
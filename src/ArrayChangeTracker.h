@@ -0,0 +1,57 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "./TickScheduler.h"
+#include "PdBase.hpp"
+
+namespace node_lib_pd {
+
+/**
+ * Keep track of the ranges of a pd array that changed since the last read,
+ * so that pollers can copy only these ranges.
+ *
+ * Writes made from js are marked explicitly, writes scheduled in the audio
+ * thread are marked once applied. In `compare` mode, the array is also
+ * compared against a shadow copy on each read to catch writes made from pd
+ * itself (e.g. `tabwrite~`) or through an array view.
+ *
+ * Must only be used from the main thread.
+ */
+class ArrayChangeTracker {
+  public:
+    typedef std::pair<int, int> span_t; // offset, length
+
+    ArrayChangeTracker(bool compare);
+
+    bool compare() const;
+    void markDirty(int offset, int length);
+    void markAll();
+    // the range will be considered dirty once `task` is done
+    void markPending(std::shared_ptr<TickTask> task, int offset, int length);
+
+    /**
+     * Copy the changed values of the array into `dest` (at the same offsets)
+     * and append the changed spans to `spans`. Must be called while holding
+     * the pd lock.
+     */
+    void collect(const t_word *vec, int size, float *dest,
+                 std::vector<span_t> &spans);
+
+  private:
+    struct pending_t {
+      std::shared_ptr<TickTask> task;
+      span_t span;
+    };
+
+    bool compare_;
+    bool all_;
+    int size_;
+    std::vector<float> shadow_;
+    std::vector<span_t> dirty_;
+    std::vector<pending_t> pending_;
+};
+
+}; // namespace
@@ -0,0 +1,70 @@
+#include "./ArrayTasks.h"
+
+#include <algorithm>
+
+namespace node_lib_pd {
+
+WriteArrayTask::WriteArrayTask(PdWrapper *pdWrapper, const std::string &name,
+                               std::vector<float> &&data, int offset,
+                               double time)
+  : TickTask(time)
+  , result(false)
+  , pdWrapper_(pdWrapper)
+  , name_(name)
+  , data_(std::move(data))
+  , offset_(offset)
+{}
+
+bool WriteArrayTask::process() {
+  this->result = this->pdWrapper_->writeArray(this->name_, this->data_,
+                                              this->data_.size(), this->offset_);
+  return true;
+}
+
+ArrayTransferTask::ArrayTransferTask(PdWrapper *pdWrapper, Direction direction,
+                                     const std::string &name, float *data,
+                                     int length, int offset, int chunkSize)
+  : TickTask(0.)
+  , pdWrapper_(pdWrapper)
+  , direction_(direction)
+  , name_(name)
+  , data_(data)
+  , length_(length)
+  , offset_(offset)
+  , chunkSize_(chunkSize)
+  , transferred_(0)
+{}
+
+bool ArrayTransferTask::process() {
+  const int transferred = this->transferred_.load();
+  const int len = std::min(this->chunkSize_, this->length_ - transferred);
+  float *data = this->data_ + transferred;
+  const int offset = this->offset_ + transferred;
+  bool result;
+
+  if (this->direction_ == Direction::WRITE) {
+    result = this->pdWrapper_->writeArray(this->name_, data, len, offset);
+  } else {
+    result = this->pdWrapper_->readArray(this->name_, data, len, offset);
+  }
+
+  // array has been freed or resized in the meantime
+  if (!result) {
+    this->error = "array \"" + this->name_ + "\" changed during transfer";
+    return true;
+  }
+
+  this->transferred_.store(transferred + len);
+
+  return transferred + len >= this->length_;
+}
+
+float ArrayTransferTask::progress() const {
+  if (this->length_ == 0) {
+    return 1.f;
+  }
+
+  return (float)this->transferred_.load() / (float)this->length_;
+}
+
+}; // namespace
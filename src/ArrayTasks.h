@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "./PdWrapper.h"
+#include "./TickScheduler.h"
+
+namespace node_lib_pd {
+
+/**
+ * Write a staged copy of some values into a pd array at a tick boundary, so
+ * that the DSP never sees a partially written array.
+ */
+class WriteArrayTask : public TickTask {
+  public:
+    WriteArrayTask(PdWrapper *pdWrapper, const std::string &name,
+                   std::vector<float> &&data, int offset, double time);
+
+    bool process();
+
+    bool result;
+
+  private:
+    PdWrapper *pdWrapper_;
+    std::string name_;
+    std::vector<float> data_;
+    int offset_;
+};
+
+/**
+ * Copy values between a buffer and a pd array, split in chunks applied at
+ * successive tick boundaries so that the audio thread is never stalled by
+ * a large transfer.
+ */
+class ArrayTransferTask : public TickTask {
+  public:
+    enum class Direction {
+      READ,
+      WRITE,
+    };
+
+    /**
+     * `data` is not owned by the task and must stay alive until it is done
+     */
+    ArrayTransferTask(PdWrapper *pdWrapper, Direction direction,
+                      const std::string &name, float *data, int length,
+                      int offset, int chunkSize);
+
+    bool process();
+    float progress() const;
+
+  private:
+    PdWrapper *pdWrapper_;
+    Direction direction_;
+    std::string name_;
+    float *data_;
+    int length_;
+    int offset_;
+    int chunkSize_;
+    std::atomic<int> transferred_;
+};
+
+}; // namespace
@@ -0,0 +1,144 @@
+#include "./AudioStats.h"
+
+#include <algorithm>
+
+namespace node_lib_pd {
+
+// status flags reported as xruns, `paPrimingOutput` is only counted
+static const PaStreamCallbackFlags XRUN_FLAGS = paInputUnderflow |
+                                                paInputOverflow |
+                                                paOutputUnderflow |
+                                                paOutputOverflow;
+
+AudioStats::AudioStats() {
+  this->reset();
+}
+
+void AudioStats::reset() {
+  this->callbacks_ = 0;
+  this->frames_ = 0;
+  this->inputUnderflows_ = 0;
+  this->inputOverflows_ = 0;
+  this->outputUnderflows_ = 0;
+  this->outputOverflows_ = 0;
+  this->primingOutputs_ = 0;
+
+  for (int i = 0; i < NUM_EVENTS; i++) {
+    this->slots_[i].frame = 0;
+    this->slots_[i].time = 0;
+    this->slots_[i].flags = 0;
+  }
+
+  this->eventCount_ = 0;
+}
+
+void AudioStats::record(PaStreamCallbackFlags flags, unsigned long frames,
+                        double time) {
+  const std::memory_order relaxed = std::memory_order_relaxed;
+  const uint64_t frame = this->frames_.load(relaxed);
+
+  this->callbacks_.fetch_add(1, relaxed);
+  this->frames_.store(frame + frames, relaxed);
+
+  if (flags == 0) {
+    return;
+  }
+
+  if (flags & paInputUnderflow) {
+    this->inputUnderflows_.fetch_add(1, relaxed);
+  }
+
+  if (flags & paInputOverflow) {
+    this->inputOverflows_.fetch_add(1, relaxed);
+  }
+
+  if (flags & paOutputUnderflow) {
+    this->outputUnderflows_.fetch_add(1, relaxed);
+  }
+
+  if (flags & paOutputOverflow) {
+    this->outputOverflows_.fetch_add(1, relaxed);
+  }
+
+  if (flags & paPrimingOutput) {
+    this->primingOutputs_.fetch_add(1, relaxed);
+  }
+
+  if (flags & XRUN_FLAGS) {
+    const uint64_t count = this->eventCount_.load(relaxed);
+    slot_t &slot = this->slots_[count % NUM_EVENTS];
+
+    slot.frame.store(frame, relaxed);
+    slot.time.store(time, relaxed);
+    slot.flags.store(flags & XRUN_FLAGS, relaxed);
+
+    // publish the slot
+    this->eventCount_.store(count + 1, std::memory_order_release);
+  }
+}
+
+uint64_t AudioStats::callbacks() const {
+  return this->callbacks_.load(std::memory_order_relaxed);
+}
+
+uint64_t AudioStats::frames() const {
+  return this->frames_.load(std::memory_order_relaxed);
+}
+
+uint64_t AudioStats::inputUnderflows() const {
+  return this->inputUnderflows_.load(std::memory_order_relaxed);
+}
+
+uint64_t AudioStats::inputOverflows() const {
+  return this->inputOverflows_.load(std::memory_order_relaxed);
+}
+
+uint64_t AudioStats::outputUnderflows() const {
+  return this->outputUnderflows_.load(std::memory_order_relaxed);
+}
+
+uint64_t AudioStats::outputOverflows() const {
+  return this->outputOverflows_.load(std::memory_order_relaxed);
+}
+
+uint64_t AudioStats::primingOutputs() const {
+  return this->primingOutputs_.load(std::memory_order_relaxed);
+}
+
+uint64_t AudioStats::eventCount() const {
+  return this->eventCount_.load(std::memory_order_acquire);
+}
+
+uint64_t AudioStats::events(uint64_t since,
+                            std::vector<xrun_event_t> &dest) const {
+  const uint64_t count = this->eventCount_.load(std::memory_order_acquire);
+  uint64_t first = count > (uint64_t)NUM_EVENTS ? count - NUM_EVENTS : 0;
+
+  if (since > first) {
+    first = since;
+  }
+
+  const size_t offset = dest.size();
+
+  for (uint64_t i = first; i < count; i++) {
+    const slot_t &slot = this->slots_[i % NUM_EVENTS];
+    xrun_event_t event;
+    event.frame = slot.frame.load(std::memory_order_relaxed);
+    event.time = slot.time.load(std::memory_order_relaxed);
+    event.flags = slot.flags.load(std::memory_order_relaxed);
+    dest.push_back(event);
+  }
+
+  // drop the events the writer may have overwritten meanwhile
+  std::atomic_thread_fence(std::memory_order_acquire);
+  const uint64_t after = this->eventCount_.load(std::memory_order_relaxed);
+
+  if (after > (uint64_t)NUM_EVENTS && after - NUM_EVENTS > first) {
+    const uint64_t overwritten = std::min(after - NUM_EVENTS, count) - first;
+    dest.erase(dest.begin() + offset, dest.begin() + offset + overwritten);
+  }
+
+  return count;
+}
+
+}; // namespace
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <vector>
+
+#include "portaudio.h"
+
+namespace node_lib_pd {
+
+// xrun reported by portaudio in the status flags of a callback
+typedef struct xrun_event_s {
+  uint64_t frame;              // stream frame at the start of the callback
+  double time;                 // stream time (s) at the start of the callback
+  PaStreamCallbackFlags flags;
+} xrun_event_t;
+
+/**
+ * Counters of the portaudio callback status flags and ring of the most recent
+ * xrun events.
+ *
+ * Written by the audio thread only, without locks nor allocations, and read
+ * from any thread. A reader racing with the writer may see counters from
+ * different callbacks, events overwritten while being read are dropped.
+ */
+class AudioStats {
+  public:
+    static const int NUM_EVENTS = 64;
+
+    AudioStats();
+
+    // not thread safe, call while the stream is stopped
+    void reset();
+
+    // called by the audio thread on each callback
+    void record(PaStreamCallbackFlags flags, unsigned long frames, double time);
+
+    uint64_t callbacks() const;
+    uint64_t frames() const;
+    uint64_t inputUnderflows() const;
+    uint64_t inputOverflows() const;
+    uint64_t outputUnderflows() const;
+    uint64_t outputOverflows() const;
+    uint64_t primingOutputs() const;
+
+    // number of xrun events recorded since reset
+    uint64_t eventCount() const;
+
+    /**
+     * Append the events recorded after the first `since` ones (at most the
+     * `NUM_EVENTS` most recent) to `dest`, returns the event count at the
+     * time of the read.
+     */
+    uint64_t events(uint64_t since, std::vector<xrun_event_t> &dest) const;
+
+  private:
+    struct slot_t {
+      std::atomic<uint64_t> frame;
+      std::atomic<double> time;
+      std::atomic<unsigned long> flags;
+    };
+
+    std::atomic<uint64_t> callbacks_;
+    std::atomic<uint64_t> frames_;
+    std::atomic<uint64_t> inputUnderflows_;
+    std::atomic<uint64_t> inputOverflows_;
+    std::atomic<uint64_t> outputUnderflows_;
+    std::atomic<uint64_t> outputOverflows_;
+    std::atomic<uint64_t> primingOutputs_;
+
+    slot_t slots_[NUM_EVENTS];
+    std::atomic<uint64_t> eventCount_;
+};
+
+}; // namespace
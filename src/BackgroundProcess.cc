@@ -3,18 +3,39 @@
 namespace node_lib_pd {
 
 BackgroundProcess::BackgroundProcess(
-  Napi::Function& callback,
+  Napi::Env env,
   audio_config_t * audioConfig,
   LockedQueue<pd_msg_t> * msgQueue,
   PaWrapper * paWrapper,
-  PdWrapper * pdWrapper)
-  : Napi::AsyncProgressWorker<uint32_t>(callback, "pa background process")
+  PdWrapper * pdWrapper,
+  TickScheduler * tickScheduler,
+  thread_report_t * threadReport,
+  LatencyTracer * latencyTracer,
+  ChannelFilters * channelFilters,
+  SubscriptionTable * subscriptions,
+  LogRing * logRing,
+  TaskCompletions * taskCompletions,
+  std::function<void(Napi::Env)> beforeDispatch)
+  : Napi::AsyncProgressWorker<uint32_t>(env, "pa background process")
   , audioConfig_(audioConfig)
   , msgReceiveQueue_(msgQueue)
   , paWrapper_(paWrapper)
   , pdWrapper_(pdWrapper)
+  , tickScheduler_(tickScheduler)
+  , threadReport_(threadReport)
+  , latencyTracer_(latencyTracer)
+  , channelFilters_(channelFilters)
+  , subscriptions_(subscriptions)
+  , logRing_(logRing)
+  , taskCompletions_(taskCompletions)
+  , beforeDispatch_(beforeDispatch)
+  , watchArrays_(false)
+  , xrunEventsSent_(0)
   , mut_()
-{}
+{
+  this->sendStats_.capacity = audioConfig->sendQueue.capacity;
+  this->sendStats_.policy = audioConfig->sendQueue.policy;
+}
 
 BackgroundProcess::~BackgroundProcess() {
   #ifdef DEBUG
@@ -23,25 +44,119 @@ BackgroundProcess::~BackgroundProcess() {
 }
 
 void BackgroundProcess::addScheduledMessage(pd_scheduled_msg_t msg) {
+  // only messages to be delivered asap are traced
+  if (msg.time == 0 && this->latencyTracer_->isEnabled()) {
+    msg.timestamp = LatencyTracer::now();
+  }
+
   std::lock_guard<std::mutex> lock(mut_);
-  this->sendMsgQueue_.push(msg);
+  std::vector<pd_scheduled_msg_t> &heap = this->sendMsgQueue_;
+  compare_msg_time_t compare;
+
+  this->sendStats_.pushed += 1;
+
+  if (this->sendStats_.capacity > 0 && heap.size() >= this->sendStats_.capacity) {
+    switch (this->sendStats_.policy) {
+      case OverflowPolicy::DROP_NEWEST: {
+        this->sendStats_.dropped += 1;
+        return;
+      }
+      case OverflowPolicy::DROP_OLDEST: {
+        // oldest in order of sending, not of scheduled time
+        auto oldest = std::min_element(heap.begin(), heap.end(),
+          [](const pd_scheduled_msg_t &a, const pd_scheduled_msg_t &b) {
+            return a.index < b.index;
+          });
+
+        heap.erase(oldest);
+        std::make_heap(heap.begin(), heap.end(), compare);
+        this->sendStats_.dropped += 1;
+        break;
+      }
+      case OverflowPolicy::COALESCE: {
+        auto latest = heap.end();
+
+        for (auto it = heap.begin(); it != heap.end(); ++it) {
+          if (it->channel == msg.channel &&
+              (latest == heap.end() || it->index > latest->index)) {
+            latest = it;
+          }
+        }
+
+        if (latest == heap.end()) {
+          this->sendStats_.dropped += 1;
+        } else {
+          *latest = msg;
+          std::make_heap(heap.begin(), heap.end(), compare);
+          this->sendStats_.coalesced += 1;
+        }
+
+        return;
+      }
+    }
+  }
+
+  heap.push_back(msg);
+  std::push_heap(heap.begin(), heap.end(), compare);
+
+  if (heap.size() > this->sendStats_.highWater) {
+    this->sendStats_.highWater = heap.size();
+  }
+}
+
+void BackgroundProcess::watchArrays(bool watch) {
+  this->watchArrays_.store(watch, std::memory_order_relaxed);
+}
+
+queue_stats_t BackgroundProcess::sendQueueStats() const {
+  std::lock_guard<std::mutex> lock(mut_);
+  queue_stats_t stats = this->sendStats_;
+  stats.depth = this->sendMsgQueue_.size();
+  return stats;
 }
 
 // this is called in the worker thread
 void BackgroundProcess::Execute(const BackgroundProcess::ExecutionProgress& progress) {
-  PaStream * paStream = this->paWrapper_->getStream();
+  // the worker thread belongs to the libuv pool, it is given back with its
+  // own scheduling once the stream is stopped
+  thread_state_t poolThreadState;
+  saveThreadState(poolThreadState);
+  applyThreadSettings(this->audioConfig_->messageThread, *this->threadReport_);
+
+  if (this->audioConfig_->lockMemory) {
+    MemoryLock::prefaultStack();
+  }
 
-  while (Pa_IsStreamActive(paStream) == 1) {
+  uint64_t lastXrunCount = 0;
+
+  while (this->paWrapper_->isActive()) {
     double currentTime = this->paWrapper_->currentTime;
     double lookAhead = this->audioConfig_->bufferDuration;
     double nextTime = currentTime + lookAhead;
 
     std::unique_lock<std::mutex> lock(this->mut_);
+    std::vector<pd_scheduled_msg_t> &heap = this->sendMsgQueue_;
+    bool sent = false;
     // send scheduled messages to pd
-    while (!this->sendMsgQueue_.empty() && this->sendMsgQueue_.top().time <= nextTime) {
-      pd_scheduled_msg_t nextMsg = this->sendMsgQueue_.top();
-      this->pdWrapper_->sendMessage(nextMsg);
-      this->sendMsgQueue_.pop();
+    while (!heap.empty() && heap.front().time <= nextTime) {
+      std::pop_heap(heap.begin(), heap.end(), compare_msg_time_t());
+      pd_scheduled_msg_t nextMsg = heap.back();
+      heap.pop_back();
+      sent = true;
+
+      if (nextMsg.timestamp != 0) {
+        const uint64_t dequeued = LatencyTracer::now();
+        this->latencyTracer_->record(LatencyTracer::SEND,
+                                     dequeued - nextMsg.timestamp);
+        // replies are received while the message is delivered
+        this->latencyTracer_->beginInjection(dequeued);
+        this->pdWrapper_->sendMessage(nextMsg);
+        this->latencyTracer_->endInjection();
+        this->latencyTracer_->record(LatencyTracer::INJECT,
+                                     LatencyTracer::now() - dequeued);
+      } else {
+        this->pdWrapper_->sendMessage(nextMsg);
+      }
     }
 
     lock.unlock();
@@ -49,8 +164,29 @@ void BackgroundProcess::Execute(const BackgroundProcess::ExecutionProgress& prog
     // receive messages from pd
     this->pdWrapper_->getLibPdInstance()->receiveMessages();
 
-    // add flag to progress callback if the queue is not empty
-    if (!this->msgReceiveQueue_->empty()) {
+    // forward the messages held by rate limited channels
+    this->channelFilters_->flush(this->msgReceiveQueue_);
+
+    // release tasks applied by the audio thread
+    this->tickScheduler_->collect();
+
+    // add flag to progress callback if the queue or the log ring are not
+    // empty, if new xruns should be notified, if tick tasks progressed or if
+    // the messages sent may have resized viewed arrays
+    bool notify = !this->msgReceiveQueue_->empty() || !this->logRing_->empty() ||
+                  this->taskCompletions_->poll() ||
+                  (sent && this->watchArrays_.load(std::memory_order_relaxed));
+
+    if (this->audioConfig_->xrunEvents) {
+      const uint64_t xrunCount = this->paWrapper_->audioStats.eventCount();
+
+      if (xrunCount != lastXrunCount) {
+        lastXrunCount = xrunCount;
+        notify = true;
+      }
+    }
+
+    if (notify) {
       const uint32_t i = 1;
       progress.Send(&i, 1);
     }
@@ -63,31 +199,49 @@ void BackgroundProcess::Execute(const BackgroundProcess::ExecutionProgress& prog
     // double sleepDuration = this->audioConfig_->bufferDuration;
     Pa_Sleep(sleepDuration * 1000.0f);
   }
+
+  restoreThreadState(poolThreadState);
 }
 
 // this is called in the js event loop
 void BackgroundProcess::OnProgress(const uint32_t* data, size_t size) {
+  std::vector<Napi::Function> listeners;
+  Napi::Value channel;
+
+  // pd ran since the last callback, e.g. array views must be checked before
+  // any listener can access them
+  this->beforeDispatch_(Env());
+
   // dequeue messages
   while (!this->msgReceiveQueue_->empty()) {
     auto ptr = this->msgReceiveQueue_->pop();
+    this->channelFilters_->release(ptr);
+
+    if (ptr->timestamp != 0) {
+      this->latencyTracer_->record(LatencyTracer::DISPATCH,
+                                   LatencyTracer::now() - ptr->timestamp);
+    }
 
-    Napi::Value channel = Napi::String::New(Env(), ptr->channel);
+    // the channel may have been unsubscribed since the message was received
+    if (!this->subscriptions_->listeners(*ptr, listeners, channel)) {
+      continue;
+    }
+
+    Napi::Value value;
 
     switch (ptr->type) {
       case PD_MSG_TYPES::BANG_MSG: {
-        Callback().Call({ channel });
+        value = Env().Undefined();
         break;
       }
 
       case PD_MSG_TYPES::FLOAT_MSG: {
-        Napi::Value num = Napi::Number::New(Env(), ptr->num);
-        Callback().Call({ channel, num });
+        value = Napi::Number::New(Env(), ptr->num);
         break;
       }
 
       case PD_MSG_TYPES::SYMBOL_MSG: {
-        Napi::Value symbol = Napi::String::New(Env(), ptr->symbol);
-        Callback().Call({ channel, symbol });
+        value = Napi::String::New(Env(), ptr->symbol);
         break;
       }
 
@@ -106,11 +260,107 @@ void BackgroundProcess::OnProgress(const uint32_t* data, size_t size) {
           }
         }
 
-        Callback().Call({ channel, list });
+        value = list;
         break;
       }
     }
+
+    for (auto &listener : listeners) {
+      listener.Call({ value, channel });
+    }
+  }
+
+  // log lines are delivered in batches
+  if (!this->logRing_->empty()) {
+    this->logEntries_.clear();
+    this->logRing_->drain(this->logEntries_);
+
+    if (this->subscriptions_->listeners("log", listeners, channel)) {
+      Napi::Array entries = Napi::Array::New(Env(), this->logEntries_.size());
+
+      for (uint32_t i = 0; i < this->logEntries_.size(); i++) {
+        entries.Set(i, LogEntryToObject(Env(), this->logEntries_[i]));
+      }
+
+      for (auto &listener : listeners) {
+        listener.Call({ entries, channel });
+      }
+    }
+
+    // lines printed by pd, one call per line for backward compatibility
+    if (this->subscriptions_->listeners("print", listeners, channel)) {
+      for (auto &entry : this->logEntries_) {
+        if (entry.source.compare(0, 2, "pd") != 0) {
+          continue;
+        }
+
+        Napi::Value message = Napi::String::New(Env(), entry.message);
+
+        for (auto &listener : listeners) {
+          listener.Call({ message, channel });
+        }
+      }
+    }
   }
+
+  // settle the Promises of the tasks applied by the audio thread
+  this->taskCompletions_->dispatch(Env());
+
+  if (this->audioConfig_->xrunEvents) {
+    this->xrunEvents_.clear();
+    this->xrunEventsSent_ = this->paWrapper_->audioStats.events(
+        this->xrunEventsSent_, this->xrunEvents_);
+
+    if (!this->xrunEvents_.empty() &&
+        this->subscriptions_->listeners("xrun", listeners, channel)) {
+      for (auto &event : this->xrunEvents_) {
+        Napi::Value value = XrunEventToObject(Env(), event);
+
+        for (auto &listener : listeners) {
+          listener.Call({ value, channel });
+        }
+      }
+    }
+  }
+}
+
+Napi::Object BackgroundProcess::XrunEventToObject(Napi::Env env, const xrun_event_t &event) {
+  Napi::Object obj = Napi::Object::New(env);
+  Napi::Array flags = Napi::Array::New(env);
+  int next = 0;
+
+  if (event.flags & paInputUnderflow) {
+    flags[next++] = Napi::String::New(env, "inputUnderflow");
+  }
+
+  if (event.flags & paInputOverflow) {
+    flags[next++] = Napi::String::New(env, "inputOverflow");
+  }
+
+  if (event.flags & paOutputUnderflow) {
+    flags[next++] = Napi::String::New(env, "outputUnderflow");
+  }
+
+  if (event.flags & paOutputOverflow) {
+    flags[next++] = Napi::String::New(env, "outputOverflow");
+  }
+
+  obj.Set("frame", Napi::Number::New(env, (double)event.frame));
+  obj.Set("time", Napi::Number::New(env, event.time));
+  obj.Set("flags", flags);
+
+  return obj;
+}
+
+Napi::Object BackgroundProcess::LogEntryToObject(Napi::Env env, const log_entry_t &entry) {
+  Napi::Object obj = Napi::Object::New(env);
+
+  obj.Set("time", Napi::Number::New(env, entry.time));
+  obj.Set("level", Napi::String::New(env, LogRing::levelName(entry.level)));
+  obj.Set("source", Napi::String::New(env, entry.source));
+  obj.Set("message", Napi::String::New(env, entry.message));
+
+  return obj;
 }
 
 void BackgroundProcess::OnOK() {
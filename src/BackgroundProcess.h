@@ -1,16 +1,26 @@
 #pragma once
 
 #include <iostream>
-#include <queue>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <vector>
 #include <mutex>
 #include <napi.h>
 
 #include "portaudio.h"
 #include "libpd/PdBase.hpp"
 #include "./types.h"
+#include "./ChannelFilters.h"
+#include "./LatencyTracer.h"
+#include "./LogRing.h"
 #include "./LockedQueue.h"
+#include "./MemoryLock.h"
 #include "./PaWrapper.h"
 #include "./PdWrapper.h"
+#include "./SubscriptionTable.h"
+#include "./TaskCompletions.h"
+#include "./TickScheduler.h"
 
 namespace node_lib_pd {
 
@@ -23,26 +33,57 @@ class BackgroundProcess : public Napi::AsyncProgressWorker<uint32_t>
 {
   public:
     BackgroundProcess(
-        Napi::Function& callback,
+        Napi::Env env,
         audio_config_t* audioConfig,
         LockedQueue<pd_msg_t>* msgQueue,
         PaWrapper* paWrapper,
-        PdWrapper* pdWrapper);
+        PdWrapper* pdWrapper,
+        TickScheduler* tickScheduler,
+        thread_report_t* threadReport,
+        LatencyTracer* latencyTracer,
+        ChannelFilters* channelFilters,
+        SubscriptionTable* subscriptions,
+        LogRing* logRing,
+        TaskCompletions* taskCompletions,
+        std::function<void(Napi::Env)> beforeDispatch);
     ~BackgroundProcess();
 
     void addScheduledMessage(pd_scheduled_msg_t);
+    queue_stats_t sendQueueStats() const;
+    // if true, js is notified after messages have been sent to pd, as they
+    // may have resized the arrays viewed from js
+    void watchArrays(bool watch);
 
     // This code will be executed on the worker thread
     void Execute(const BackgroundProcess::ExecutionProgress& progress);
     void OnProgress(const uint32_t* data, size_t size);
     void OnOK(); // not mandatory
 
+    static Napi::Object XrunEventToObject(Napi::Env env, const xrun_event_t &event);
+    static Napi::Object LogEntryToObject(Napi::Env env, const log_entry_t &entry);
+
   private:
     audio_config_t * audioConfig_;
     LockedQueue<pd_msg_t> * msgReceiveQueue_;
     PaWrapper * paWrapper_;
     PdWrapper * pdWrapper_;
-    std::priority_queue<pd_scheduled_msg_t, std::vector<pd_scheduled_msg_t>, compare_msg_time_t> sendMsgQueue_;
+    TickScheduler * tickScheduler_;
+    thread_report_t * threadReport_;
+    LatencyTracer * latencyTracer_;
+    ChannelFilters * channelFilters_;
+    SubscriptionTable * subscriptions_;
+    LogRing * logRing_;
+    TaskCompletions * taskCompletions_;
+    // called in the js thread before anything is dispatched
+    std::function<void(Napi::Env)> beforeDispatch_;
+    std::atomic<bool> watchArrays_;
+    std::vector<log_entry_t> logEntries_;
+    uint64_t xrunEventsSent_;
+    std::vector<xrun_event_t> xrunEvents_;
+    // binary heap ordered by `compare_msg_time_t`, kept as a plain vector
+    // so that the overflow policies can reach any element
+    std::vector<pd_scheduled_msg_t> sendMsgQueue_;
+    queue_stats_t sendStats_;
 
     mutable std::mutex mut_;
 };
@@ -0,0 +1,68 @@
+#include "./BlockAdapter.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace node_lib_pd {
+
+BlockAdapter::BlockAdapter()
+  : blockSize_(0)
+  , numInputChannels_(0)
+  , numOutputChannels_(0)
+  , position_(0)
+{}
+
+void BlockAdapter::setup(int blockSize, int numInputChannels,
+                         int numOutputChannels) {
+  this->blockSize_ = blockSize;
+  this->numInputChannels_ = numInputChannels;
+  this->numOutputChannels_ = numOutputChannels;
+  this->position_ = 0;
+
+  this->input_.assign(blockSize * numInputChannels, 0.f);
+  this->output_.assign(blockSize * numOutputChannels, 0.f);
+}
+
+unsigned long BlockAdapter::exchange(const float *in, float *out,
+                                     unsigned long frames) {
+  const unsigned long n =
+      std::min(frames, (unsigned long)(this->blockSize_ - this->position_));
+
+  if (this->numInputChannels_ > 0) {
+    float *dest = &this->input_[this->position_ * this->numInputChannels_];
+    const size_t size = n * this->numInputChannels_ * sizeof(float);
+
+    if (in != NULL) {
+      std::memcpy(dest, in, size);
+    } else {
+      std::memset(dest, 0, size);
+    }
+  }
+
+  if (this->numOutputChannels_ > 0 && out != NULL) {
+    const float *src = &this->output_[this->position_ * this->numOutputChannels_];
+    std::memcpy(out, src, n * this->numOutputChannels_ * sizeof(float));
+  }
+
+  this->position_ += n;
+
+  return n;
+}
+
+bool BlockAdapter::ready() const {
+  return this->position_ == this->blockSize_;
+}
+
+void BlockAdapter::rewind() {
+  this->position_ = 0;
+}
+
+float *BlockAdapter::inputBlock() {
+  return this->numInputChannels_ > 0 ? this->input_.data() : NULL;
+}
+
+float *BlockAdapter::outputBlock() {
+  return this->numOutputChannels_ > 0 ? this->output_.data() : NULL;
+}
+
+}; // namespace
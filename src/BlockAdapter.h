@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+
+namespace node_lib_pd {
+
+/**
+ * Adapt host buffers of any size to whole pd blocks.
+ *
+ * Input frames are accumulated in a one-block FIFO while the output frames
+ * computed by the previous block are consumed, once a full block of input is
+ * available `ready` returns true and the caller should run one pd tick from
+ * `inputBlock` into `outputBlock` then `rewind`. This adds exactly one block
+ * of latency.
+ *
+ * Buffers are allocated in `setup`, `exchange` never allocates and can be
+ * called from the audio thread. Buffers are interleaved.
+ */
+class BlockAdapter {
+  public:
+    BlockAdapter();
+
+    void setup(int blockSize, int numInputChannels, int numOutputChannels);
+
+    /**
+     * Push up to `frames` input frames and pull the same number of output
+     * frames, stops at the end of the current block. Returns the number of
+     * frames exchanged.
+     */
+    unsigned long exchange(const float *in, float *out, unsigned long frames);
+
+    bool ready() const;
+    void rewind();
+
+    // NULL if there are no channels
+    float *inputBlock();
+    float *outputBlock();
+
+  private:
+    int blockSize_;
+    int numInputChannels_;
+    int numOutputChannels_;
+    int position_;
+    std::vector<float> input_;
+    std::vector<float> output_;
+};
+
+}; // namespace
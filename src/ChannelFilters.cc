@@ -0,0 +1,144 @@
+#include "./ChannelFilters.h"
+
+#include <chrono>
+#include <cmath>
+
+namespace node_lib_pd {
+
+ChannelFilters::ChannelFilters()
+  : size_(0)
+{}
+
+// the channel of a queued message is read without lock by `release`
+static void copyPayload(pd_msg_t &dest, const pd_msg_t &src) {
+  dest.type = src.type;
+  dest.num = src.num;
+  dest.symbol = src.symbol;
+  dest.list = src.list;
+  dest.timestamp = src.timestamp;
+}
+
+uint64_t ChannelFilters::now() {
+  const std::chrono::nanoseconds time =
+      std::chrono::steady_clock::now().time_since_epoch();
+  return (uint64_t)time.count();
+}
+
+void ChannelFilters::set(const std::string &channel,
+                         const channel_filter_t &filter) {
+  std::lock_guard<std::mutex> lock(this->mut_);
+  this->filters_[channel].options = filter;
+  this->size_ = this->filters_.size();
+}
+
+void ChannelFilters::remove(const std::string &channel) {
+  std::lock_guard<std::mutex> lock(this->mut_);
+  this->filters_.erase(channel);
+  this->size_ = this->filters_.size();
+}
+
+bool ChannelFilters::filter(const std::shared_ptr<pd_msg_t> &msg) {
+  // most channels are not filtered
+  if (this->size_.load(std::memory_order_relaxed) == 0) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(this->mut_);
+  auto search = this->filters_.find(msg->channel);
+
+  if (search == this->filters_.end()) {
+    return false;
+  }
+
+  state_t &state = search->second;
+  const channel_filter_t &options = state.options;
+  const bool isFloat = msg->type == PD_MSG_TYPES::FLOAT_MSG;
+
+  if (isFloat && options.deadband > 0.f && state.hasValue &&
+      std::fabs(msg->num - state.lastValue) < options.deadband) {
+    return true;
+  }
+
+  if (isFloat) {
+    state.hasValue = true;
+    state.lastValue = msg->num;
+  }
+
+  // the pending message is only referenced here once it has been dispatched
+  // or dropped by the receive queue
+  if (state.pending && state.pending.use_count() == 1) {
+    state.pending.reset();
+  }
+
+  if (options.coalesce && state.pending) {
+    copyPayload(*state.pending, *msg);
+    state.held.reset();
+    return true;
+  }
+
+  const uint64_t time = now();
+
+  if (options.minInterval > 0 && state.lastForward != 0 &&
+      time - state.lastForward < options.minInterval) {
+    state.held = msg;
+    return true;
+  }
+
+  state.held.reset();
+  state.lastForward = time;
+
+  if (options.coalesce) {
+    state.pending = msg;
+  }
+
+  return false;
+}
+
+void ChannelFilters::flush(LockedQueue<pd_msg_t> *queue) {
+  if (this->size_.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(this->mut_);
+  const uint64_t time = now();
+
+  for (auto &entry : this->filters_) {
+    state_t &state = entry.second;
+
+    if (!state.held || time - state.lastForward < state.options.minInterval) {
+      continue;
+    }
+
+    if (state.pending && state.pending.use_count() == 1) {
+      state.pending.reset();
+    }
+
+    if (state.options.coalesce && state.pending) {
+      copyPayload(*state.pending, *state.held);
+    } else {
+      queue->push(state.held);
+      state.lastForward = time;
+
+      if (state.options.coalesce) {
+        state.pending = state.held;
+      }
+    }
+
+    state.held.reset();
+  }
+}
+
+void ChannelFilters::release(const std::shared_ptr<pd_msg_t> &msg) {
+  if (this->size_.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(this->mut_);
+  auto search = this->filters_.find(msg->channel);
+
+  if (search != this->filters_.end() && search->second.pending == msg) {
+    search->second.pending.reset();
+  }
+}
+
+}; // namespace
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+
+#include "./types.h"
+#include "./LockedQueue.h"
+
+namespace node_lib_pd {
+
+typedef struct channel_filter_s {
+  bool coalesce = false;    // merge into the message not yet dispatched
+  uint64_t minInterval = 0; // in ns, 0 for no rate limit
+  float deadband = 0.f;     // minimum change of float values, 0 for none
+} channel_filter_t;
+
+/**
+ * Filter the messages received from pd on subscribed channels before they
+ * are pushed to the receive queue, so that high-rate channels (e.g. meters)
+ * only cross into js when meaningful:
+ *
+ * - coalesce: a message is merged into the previous message of the channel
+ *   if the latter is still waiting in the queue
+ * - minInterval: messages following a forwarded message too closely are held
+ *   (only the latest one), and forwarded by `flush` once the interval has
+ *   elapsed
+ * - deadband: float messages too close to the last accepted value are dropped
+ *
+ * Called from the threads running pd (`filter`, `flush`) and from the js
+ * thread (`release`, `set`, `remove`).
+ */
+class ChannelFilters {
+  public:
+    ChannelFilters();
+
+    void set(const std::string &channel, const channel_filter_t &filter);
+    void remove(const std::string &channel);
+
+    // return true if the message is consumed by the filter, i.e. dropped,
+    // held or merged into a queued message, false if it should be queued
+    bool filter(const std::shared_ptr<pd_msg_t> &msg);
+    // push the held messages whose interval has elapsed
+    void flush(LockedQueue<pd_msg_t> *queue);
+    // must be called before reading a message popped from the queue
+    void release(const std::shared_ptr<pd_msg_t> &msg);
+
+  private:
+    struct state_t {
+      channel_filter_t options;
+      // last forwarded message, while it is waiting in the queue
+      std::shared_ptr<pd_msg_t> pending;
+      // latest message waiting for `minInterval`
+      std::shared_ptr<pd_msg_t> held;
+      uint64_t lastForward = 0;
+      bool hasValue = false;
+      float lastValue = 0.f;
+    };
+
+    static uint64_t now();
+
+    std::atomic<int> size_;
+    std::map<std::string, state_t> filters_;
+    std::mutex mut_;
+};
+
+}; // namespace
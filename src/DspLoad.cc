@@ -0,0 +1,65 @@
+#include "./DspLoad.h"
+
+namespace node_lib_pd {
+
+DspLoad::DspLoad()
+  : resetRequested_(false)
+{
+  this->reset();
+}
+
+void DspLoad::reset() {
+  this->durations_.reset();
+  this->current_ = 0;
+  this->max_ = 0;
+  this->busy_ = 0;
+  this->budget_ = 0;
+  this->resetRequested_ = false;
+}
+
+void DspLoad::requestReset() {
+  this->resetRequested_ = true;
+}
+
+void DspLoad::record(uint64_t duration, uint64_t budget) {
+  const std::memory_order relaxed = std::memory_order_relaxed;
+
+  if (this->resetRequested_.load(relaxed)) {
+    this->reset();
+  }
+
+  const double load = budget > 0 ? (double)duration / (double)budget : 0;
+
+  this->durations_.record(duration);
+  this->current_.store(load, relaxed);
+  this->busy_.fetch_add(duration, relaxed);
+  this->budget_.fetch_add(budget, relaxed);
+
+  if (load > this->max_.load(relaxed)) {
+    this->max_.store(load, relaxed);
+  }
+}
+
+double DspLoad::current() const {
+  return this->current_.load(std::memory_order_relaxed);
+}
+
+double DspLoad::average() const {
+  const uint64_t budget = this->budget_.load(std::memory_order_relaxed);
+
+  if (budget == 0) {
+    return 0;
+  }
+
+  return (double)this->busy_.load(std::memory_order_relaxed) / (double)budget;
+}
+
+double DspLoad::max() const {
+  return this->max_.load(std::memory_order_relaxed);
+}
+
+const Histogram &DspLoad::durations() const {
+  return this->durations_;
+}
+
+}; // namespace
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+#include "./Histogram.h"
+
+namespace node_lib_pd {
+
+/**
+ * Time spent by the audio callback processing a buffer relative to the
+ * duration of the buffer, i.e. how close the dsp is to the deadline.
+ *
+ * Written by the audio thread only, without locks nor allocations, and read
+ * from any thread.
+ */
+class DspLoad {
+  public:
+    DspLoad();
+
+    // not thread safe, call while the stream is stopped
+    void reset();
+    // can be called from any thread, applied by the next `record`
+    void requestReset();
+
+    // called by the audio thread, durations in ns
+    void record(uint64_t duration, uint64_t budget);
+
+    // load of the last callback
+    double current() const;
+    // total processing time over total buffer duration
+    double average() const;
+    double max() const;
+
+    // processing durations (in ns) of the callbacks
+    const Histogram &durations() const;
+
+  private:
+    Histogram durations_;
+    std::atomic<bool> resetRequested_;
+    std::atomic<double> current_;
+    std::atomic<double> max_;
+    std::atomic<uint64_t> busy_;
+    std::atomic<uint64_t> budget_;
+};
+
+}; // namespace
@@ -0,0 +1,138 @@
+#include "./Histogram.h"
+
+namespace node_lib_pd {
+
+Histogram::Histogram()
+  : generation_(0)
+{
+  clear_(this->generations_[0]);
+  clear_(this->generations_[1]);
+}
+
+void Histogram::reset() {
+  const int next = this->generation_.load(std::memory_order_acquire) ^ 1;
+
+  // not recorded to since the previous reset, but for late writers
+  clear_(this->generations_[next]);
+  this->generation_.store(next, std::memory_order_release);
+}
+
+void Histogram::clear_(counters_t &counters) {
+  const std::memory_order relaxed = std::memory_order_relaxed;
+
+  for (int i = 0; i < NUM_BUCKETS; i++) {
+    counters.buckets[i].store(0, relaxed);
+  }
+
+  counters.count.store(0, relaxed);
+  counters.sum.store(0, relaxed);
+  counters.max.store(0, relaxed);
+}
+
+const Histogram::counters_t &Histogram::current_() const {
+  return this->generations_[this->generation_.load(std::memory_order_acquire)];
+}
+
+int Histogram::bucketIndex(uint64_t value) {
+  if (value < (uint64_t)SUB_BUCKETS) {
+    return (int)value;
+  }
+
+  int exponent = 63;
+  while (!(value & ((uint64_t)1 << exponent))) {
+    exponent--;
+  }
+
+  if (exponent >= MAX_EXPONENT) {
+    return NUM_BUCKETS - 1;
+  }
+
+  // the SUB_BUCKETS_BITS bits following the most significant one
+  const int shift = exponent - SUB_BUCKETS_BITS;
+  const int sub = (int)(value >> shift) - SUB_BUCKETS;
+
+  return SUB_BUCKETS + shift * SUB_BUCKETS + sub;
+}
+
+uint64_t Histogram::bucketValue(int index) {
+  if (index < SUB_BUCKETS) {
+    return (uint64_t)index;
+  }
+
+  const int shift = (index - SUB_BUCKETS) / SUB_BUCKETS;
+  const int sub = (index - SUB_BUCKETS) % SUB_BUCKETS;
+  const uint64_t low = (uint64_t)(SUB_BUCKETS + sub) << shift;
+
+  return low + (((uint64_t)1 << shift) >> 1);
+}
+
+void Histogram::record(uint64_t value) {
+  const std::memory_order relaxed = std::memory_order_relaxed;
+  counters_t &counters =
+      this->generations_[this->generation_.load(std::memory_order_acquire)];
+
+  counters.buckets[bucketIndex(value)].fetch_add(1, relaxed);
+  counters.sum.fetch_add(value, relaxed);
+  counters.count.fetch_add(1, relaxed);
+
+  uint64_t max = counters.max.load(relaxed);
+  while (value > max && !counters.max.compare_exchange_weak(max, value, relaxed)) {}
+}
+
+uint64_t Histogram::count() const {
+  return this->current_().count.load(std::memory_order_relaxed);
+}
+
+uint64_t Histogram::max() const {
+  return this->current_().max.load(std::memory_order_relaxed);
+}
+
+double Histogram::mean() const {
+  const counters_t &counters = this->current_();
+  const uint64_t count = counters.count.load(std::memory_order_relaxed);
+
+  if (count == 0) {
+    return 0;
+  }
+
+  return (double)counters.sum.load(std::memory_order_relaxed) / (double)count;
+}
+
+uint64_t Histogram::percentile(double ratio) const {
+  // count from the buckets rather than `count`, which may be ahead of them
+  const counters_t &counters = this->current_();
+  uint64_t counts[NUM_BUCKETS];
+  uint64_t total = 0;
+
+  for (int i = 0; i < NUM_BUCKETS; i++) {
+    counts[i] = counters.buckets[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+
+  if (total == 0) {
+    return 0;
+  }
+
+  uint64_t rank = (uint64_t)(ratio * (double)total + 0.5);
+
+  if (rank < 1) {
+    rank = 1;
+  }
+
+  uint64_t cumulated = 0;
+
+  for (int i = 0; i < NUM_BUCKETS; i++) {
+    cumulated += counts[i];
+
+    if (cumulated >= rank) {
+      const uint64_t value = bucketValue(i);
+      const uint64_t max = counters.max.load(std::memory_order_relaxed);
+      // the max is exact, don't report a percentile above it
+      return max > 0 && value > max ? max : value;
+    }
+  }
+
+  return counters.max.load(std::memory_order_relaxed);
+}
+
+}; // namespace
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+namespace node_lib_pd {
+
+/**
+ * Lock free log-linear histogram of durations (in ns).
+ *
+ * Each power of two range is split into `SUB_BUCKETS` linear buckets, so that
+ * values are recorded with a relative precision of 1 / SUB_BUCKETS (6%) up to
+ * 2^MAX_EXPONENT ns (~18 min). Values can be recorded from several threads
+ * (e.g. the audio thread) and read from any thread, a reader racing with a
+ * writer may see a partially recorded value.
+ *
+ * Counters are kept in two generations, `reset` clears the unused one and
+ * makes it current, so that it never writes to counters being recorded to.
+ */
+class Histogram {
+  public:
+    static const int SUB_BUCKETS = 16;
+    static const int SUB_BUCKETS_BITS = 4;
+    static const int MAX_EXPONENT = 40;
+    static const int NUM_BUCKETS =
+        SUB_BUCKETS + (MAX_EXPONENT - SUB_BUCKETS_BITS) * SUB_BUCKETS;
+
+    Histogram();
+
+    /**
+     * Can be called from any thread, concurrently with `record`. A value
+     * recorded while the histogram is reset may be lost.
+     */
+    void reset();
+
+    void record(uint64_t value);
+
+    uint64_t count() const;
+    uint64_t max() const;
+    double mean() const;
+
+    /**
+     * value under which `ratio` (e.g. 0.99) of the recorded values are,
+     * within the precision of the buckets, 0 if empty
+     */
+    uint64_t percentile(double ratio) const;
+
+  private:
+    static int bucketIndex(uint64_t value);
+    // middle of the range of values recorded in bucket `index`
+    static uint64_t bucketValue(int index);
+
+    struct counters_t {
+      std::atomic<uint64_t> buckets[NUM_BUCKETS];
+      std::atomic<uint64_t> count;
+      std::atomic<uint64_t> sum;
+      std::atomic<uint64_t> max;
+    };
+
+    static void clear_(counters_t &counters);
+    const counters_t &current_() const;
+
+    counters_t generations_[2];
+    std::atomic<int> generation_;
+};
+
+}; // namespace
@@ -0,0 +1,61 @@
+#include "./InitWorker.h"
+
+#include <chrono>
+#include <thread>
+
+namespace node_lib_pd {
+
+InitWorker::InitWorker(
+  Napi::Env env,
+  std::function<bool(std::string& error)> start,
+  std::function<bool()> started,
+  std::function<Napi::Value(Napi::Env)> onStarted,
+  std::function<void()> onFailed,
+  int timeout)
+  : Napi::AsyncWorker(env, "pd init")
+  , start_(start)
+  , started_(started)
+  , onStarted_(onStarted)
+  , onFailed_(onFailed)
+  , timeout_(timeout)
+  , deferred_(Napi::Promise::Deferred::New(env))
+{}
+
+Napi::Promise InitWorker::GetPromise() {
+  return this->deferred_.Promise();
+}
+
+// this is called in the worker thread
+void InitWorker::Execute() {
+  std::string error;
+
+  if (!this->start_(error)) {
+    this->SetError(error);
+    return;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  auto timeout = std::chrono::milliseconds(this->timeout_);
+
+  while (!this->started_()) {
+    if (std::chrono::steady_clock::now() - start > timeout) {
+      this->SetError("Audio stream did not start within " +
+                     std::to_string(this->timeout_) + "ms");
+      return;
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+// this is called in the js event loop
+void InitWorker::OnOK() {
+  this->deferred_.Resolve(this->onStarted_(Env()));
+}
+
+void InitWorker::OnError(const Napi::Error& e) {
+  this->onFailed_();
+  this->deferred_.Reject(e.Value());
+}
+
+}; // namespace
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <napi.h>
+
+namespace node_lib_pd {
+
+/**
+ * Start pd and the audio stream from a worker thread and settle a Promise
+ * once the first audio callback has run, or once `timeout` is elapsed.
+ */
+class InitWorker : public Napi::AsyncWorker
+{
+  public:
+    /**
+     * `start` is executed in the worker thread and must fill `error` on
+     * failure, `started` tells if the first audio callback has run and
+     * `onStarted` is executed in the js thread, its returned value resolves
+     * the Promise
+     */
+    InitWorker(
+        Napi::Env env,
+        std::function<bool(std::string& error)> start,
+        std::function<bool()> started,
+        std::function<Napi::Value(Napi::Env)> onStarted,
+        std::function<void()> onFailed,
+        int timeout);
+
+    Napi::Promise GetPromise();
+
+    // This code will be executed on the worker thread
+    void Execute();
+    void OnOK();
+    void OnError(const Napi::Error& e);
+
+  private:
+    std::function<bool(std::string& error)> start_;
+    std::function<bool()> started_;
+    std::function<Napi::Value(Napi::Env)> onStarted_;
+    std::function<void()> onFailed_;
+    int timeout_;
+    Napi::Promise::Deferred deferred_;
+};
+
+}; // namespace
@@ -0,0 +1,210 @@
+#include "./Interleave.h"
+
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NODE_LIB_PD_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace node_lib_pd {
+
+namespace interleave {
+
+// Both conversions are matrix transposes: `src` is a `rows` x `cols` row
+// major matrix, `dest` a `cols` x `rows` one. Only the region
+// [r0, r1[ x [c0, c1[ of `src` is copied.
+typedef void (*transpose_t)(const float *src, float *dest, int rows, int cols,
+                            int r0, int r1, int c0, int c1);
+
+static void transposeScalar(const float *src, float *dest, int rows, int cols,
+                            int r0, int r1, int c0, int c1) {
+  for (int i = r0; i < r1; i++) {
+    for (int j = c0; j < c1; j++) {
+      dest[j * rows + i] = src[i * cols + j];
+    }
+  }
+}
+
+#ifdef NODE_LIB_PD_X86_SIMD
+static void transposeSSE(const float *src, float *dest, int rows, int cols,
+                         int r0, int r1, int c0, int c1) {
+  const int r4 = r0 + ((r1 - r0) & ~3);
+  const int c4 = c0 + ((c1 - c0) & ~3);
+
+  for (int i = r0; i < r4; i += 4) {
+    for (int j = c0; j < c4; j += 4) {
+      const float *s = src + i * cols + j;
+      __m128 a = _mm_loadu_ps(s);
+      __m128 b = _mm_loadu_ps(s + cols);
+      __m128 c = _mm_loadu_ps(s + 2 * cols);
+      __m128 d = _mm_loadu_ps(s + 3 * cols);
+
+      _MM_TRANSPOSE4_PS(a, b, c, d);
+
+      float *t = dest + j * rows + i;
+      _mm_storeu_ps(t, a);
+      _mm_storeu_ps(t + rows, b);
+      _mm_storeu_ps(t + 2 * rows, c);
+      _mm_storeu_ps(t + 3 * rows, d);
+    }
+  }
+
+  // remaining rows and columns
+  transposeScalar(src, dest, rows, cols, r4, r1, c0, c1);
+  transposeScalar(src, dest, rows, cols, r0, r4, c4, c1);
+}
+
+// stereo is too narrow for tiles, shuffle pairs of frames instead
+static void interleaveStereoSSE(const float *src, float *dest, int numFrames) {
+  const float *left = src;
+  const float *right = src + numFrames;
+  const int n4 = numFrames & ~3;
+
+  for (int i = 0; i < n4; i += 4) {
+    const __m128 l = _mm_loadu_ps(left + i);
+    const __m128 r = _mm_loadu_ps(right + i);
+    _mm_storeu_ps(dest + 2 * i, _mm_unpacklo_ps(l, r));
+    _mm_storeu_ps(dest + 2 * i + 4, _mm_unpackhi_ps(l, r));
+  }
+
+  transposeScalar(src, dest, 2, numFrames, 0, 2, n4, numFrames);
+}
+
+static void deinterleaveStereoSSE(const float *src, float *dest,
+                                  int numFrames) {
+  float *left = dest;
+  float *right = dest + numFrames;
+  const int n4 = numFrames & ~3;
+
+  for (int i = 0; i < n4; i += 4) {
+    const __m128 a = _mm_loadu_ps(src + 2 * i);
+    const __m128 b = _mm_loadu_ps(src + 2 * i + 4);
+    _mm_storeu_ps(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+  }
+
+  transposeScalar(src, dest, numFrames, 2, n4, numFrames, 0, 2);
+}
+
+__attribute__((target("avx")))
+static void transposeAVX(const float *src, float *dest, int rows, int cols,
+                         int r0, int r1, int c0, int c1) {
+  const int r8 = r0 + ((r1 - r0) & ~7);
+  const int c8 = c0 + ((c1 - c0) & ~7);
+
+  for (int i = r0; i < r8; i += 8) {
+    for (int j = c0; j < c8; j += 8) {
+      const float *s = src + i * cols + j;
+      __m256 r[8];
+      __m256 t[8];
+
+      for (int k = 0; k < 8; k++) {
+        r[k] = _mm256_loadu_ps(s + k * cols);
+      }
+
+      for (int k = 0; k < 4; k++) {
+        t[2 * k] = _mm256_unpacklo_ps(r[2 * k], r[2 * k + 1]);
+        t[2 * k + 1] = _mm256_unpackhi_ps(r[2 * k], r[2 * k + 1]);
+      }
+
+      for (int k = 0; k < 2; k++) {
+        const int o = 4 * k;
+        r[o] = _mm256_shuffle_ps(t[o], t[o + 2], _MM_SHUFFLE(1, 0, 1, 0));
+        r[o + 1] = _mm256_shuffle_ps(t[o], t[o + 2], _MM_SHUFFLE(3, 2, 3, 2));
+        r[o + 2] = _mm256_shuffle_ps(t[o + 1], t[o + 3], _MM_SHUFFLE(1, 0, 1, 0));
+        r[o + 3] = _mm256_shuffle_ps(t[o + 1], t[o + 3], _MM_SHUFFLE(3, 2, 3, 2));
+      }
+
+      float *d = dest + j * rows + i;
+
+      for (int k = 0; k < 4; k++) {
+        _mm256_storeu_ps(d + k * rows,
+                         _mm256_permute2f128_ps(r[k], r[k + 4], 0x20));
+        _mm256_storeu_ps(d + (k + 4) * rows,
+                         _mm256_permute2f128_ps(r[k], r[k + 4], 0x31));
+      }
+    }
+  }
+
+  // remaining rows and columns
+  transposeSSE(src, dest, rows, cols, r8, r1, c0, c1);
+  transposeSSE(src, dest, rows, cols, r0, r8, c8, c1);
+}
+#endif
+
+static transpose_t selectTranspose(const char **name) {
+#ifdef NODE_LIB_PD_X86_SIMD
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("avx")) {
+    *name = "avx";
+    return &transposeAVX;
+  }
+
+  if (__builtin_cpu_supports("sse")) {
+    *name = "sse";
+    return &transposeSSE;
+  }
+#endif
+
+  *name = "scalar";
+  return &transposeScalar;
+}
+
+static const char *transposeName = "scalar";
+static const transpose_t transpose = selectTranspose(&transposeName);
+
+void interleave(const float *src, float *dest, int numChannels,
+                int numFrames) {
+  if (numChannels == 1) {
+    std::memcpy(dest, src, numFrames * sizeof(float));
+    return;
+  }
+
+#ifdef NODE_LIB_PD_X86_SIMD
+  if (numChannels == 2 && transpose != &transposeScalar) {
+    interleaveStereoSSE(src, dest, numFrames);
+    return;
+  }
+#endif
+
+  transpose(src, dest, numChannels, numFrames, 0, numChannels, 0, numFrames);
+}
+
+void deinterleave(const float *src, float *dest, int numChannels,
+                  int numFrames) {
+  if (numChannels == 1) {
+    std::memcpy(dest, src, numFrames * sizeof(float));
+    return;
+  }
+
+#ifdef NODE_LIB_PD_X86_SIMD
+  if (numChannels == 2 && transpose != &transposeScalar) {
+    deinterleaveStereoSSE(src, dest, numFrames);
+    return;
+  }
+#endif
+
+  transpose(src, dest, numFrames, numChannels, 0, numFrames, 0, numChannels);
+}
+
+void interleaveScalar(const float *src, float *dest, int numChannels,
+                      int numFrames) {
+  transposeScalar(src, dest, numChannels, numFrames, 0, numChannels, 0,
+                  numFrames);
+}
+
+void deinterleaveScalar(const float *src, float *dest, int numChannels,
+                        int numFrames) {
+  transposeScalar(src, dest, numFrames, numChannels, 0, numFrames, 0,
+                  numChannels);
+}
+
+const char *implementation() {
+  return transposeName;
+}
+
+}; // namespace interleave
+
+}; // namespace
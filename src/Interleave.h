@@ -0,0 +1,33 @@
+#pragma once
+
+namespace node_lib_pd {
+
+/**
+ * Conversions between the interleaved layout of portaudio buffers
+ * ([frame][channel]) and the non-interleaved layout of pd buffers
+ * ([channel][frame]), as used with `libpd_process_raw`.
+ *
+ * On x86, the conversions are done by transposing 8x8 (AVX) or 4x4 (SSE)
+ * tiles, the implementation is selected once at runtime according to the
+ * cpu. Other architectures use the scalar loops.
+ */
+namespace interleave {
+
+// non-interleaved `src` to interleaved `dest`
+void interleave(const float *src, float *dest, int numChannels, int numFrames);
+// interleaved `src` to non-interleaved `dest`
+void deinterleave(const float *src, float *dest, int numChannels,
+                  int numFrames);
+
+// scalar reference implementations
+void interleaveScalar(const float *src, float *dest, int numChannels,
+                      int numFrames);
+void deinterleaveScalar(const float *src, float *dest, int numChannels,
+                        int numFrames);
+
+// name of the implementation selected at runtime: "avx", "sse" or "scalar"
+const char *implementation();
+
+}; // namespace interleave
+
+}; // namespace
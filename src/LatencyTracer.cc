@@ -0,0 +1,58 @@
+#include "./LatencyTracer.h"
+
+#include <chrono>
+
+namespace node_lib_pd {
+
+// injection in progress in the current thread, 0 if none or already matched
+static thread_local uint64_t currentInjection = 0;
+
+LatencyTracer::LatencyTracer()
+  : enabled_(false)
+{}
+
+uint64_t LatencyTracer::now() {
+  const std::chrono::nanoseconds time =
+      std::chrono::steady_clock::now().time_since_epoch();
+  return (uint64_t)time.count() + 1;
+}
+
+void LatencyTracer::enable(bool enabled) {
+  this->enabled_ = enabled;
+}
+
+bool LatencyTracer::isEnabled() const {
+  return this->enabled_.load(std::memory_order_relaxed);
+}
+
+void LatencyTracer::reset() {
+  for (int i = 0; i < NUM_STAGES; i++) {
+    this->histograms_[i].reset();
+  }
+}
+
+void LatencyTracer::record(Stage stage, uint64_t duration) {
+  this->histograms_[stage].record(duration);
+}
+
+void LatencyTracer::beginInjection(uint64_t time) {
+  currentInjection = time;
+}
+
+void LatencyTracer::endInjection() {
+  currentInjection = 0;
+}
+
+uint64_t LatencyTracer::takeInjected() {
+  const uint64_t injected = currentInjection;
+  // only the first reply is matched with the message
+  currentInjection = 0;
+
+  return injected;
+}
+
+const Histogram &LatencyTracer::histogram(Stage stage) const {
+  return this->histograms_[stage];
+}
+
+}; // namespace
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+#include "./Histogram.h"
+
+namespace node_lib_pd {
+
+/**
+ * Aggregate the latency of the messages exchanged between js and pd, per
+ * stage of their journey:
+ *
+ * - SEND: from `pd.send` to the background thread taking the message out of
+ *   the send queue (i.e. polling interval)
+ * - INJECT: duration of the libpd call delivering the message, including the
+ *   wait for the pd lock held by the audio thread
+ * - PD: from the start of the injection of a message to the first message
+ *   pd sends back while delivering it, i.e. the reply of echo patches.
+ *   libpd delivers messages synchronously, so a reply is matched with the
+ *   injection in progress in the thread receiving it. Messages sent later by
+ *   the audio thread (e.g. after a [delay]) are not matched
+ * - DISPATCH: from the message being pushed in the receive queue to the js
+ *   callback (i.e. event loop)
+ *
+ * Only messages sent without a scheduled time are traced. Durations are in
+ * ns, the stages can be reset from any thread.
+ */
+class LatencyTracer {
+  public:
+    enum Stage { SEND = 0, INJECT, PD, DISPATCH, NUM_STAGES };
+
+    LatencyTracer();
+
+    // steady clock time in ns, 0 is never returned
+    static uint64_t now();
+
+    void enable(bool enabled);
+    bool isEnabled() const;
+
+    void reset();
+
+    void record(Stage stage, uint64_t duration);
+
+    // called around the injection of a traced message into pd, started at
+    // `time`, from the thread delivering it
+    void beginInjection(uint64_t time);
+    void endInjection();
+    // start of the injection in progress in the calling thread if it has
+    // not been matched with a reply yet, 0 otherwise
+    uint64_t takeInjected();
+
+    const Histogram &histogram(Stage stage) const;
+
+  private:
+    std::atomic<bool> enabled_;
+    Histogram histograms_[NUM_STAGES];
+};
+
+}; // namespace
@@ -1,14 +1,43 @@
 #pragma once
 
-#include <mutex>
-#include <queue>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <stddef.h>
+#include <stdint.h>
 
 namespace node_lib_pd {
 
 /**
- * Thread safe locked queue of shared pointers.
+ * What to do with a message pushed to a full queue
+ */
+enum class OverflowPolicy {
+  DROP_NEWEST, // discard the pushed message
+  DROP_OLDEST, // discard the oldest queued message
+  COALESCE,    // replace the most recent queued message of the same channel,
+               // drop the newest if there is none
+};
+
+struct queue_stats_t {
+  size_t capacity = 0; // 0 if unbounded
+  OverflowPolicy policy = OverflowPolicy::DROP_NEWEST;
+  size_t depth = 0;
+  size_t highWater = 0;
+  uint64_t pushed = 0;
+  uint64_t dropped = 0;
+  uint64_t coalesced = 0;
+};
+
+/**
+ * Thread safe locked queue of shared pointers, optionally bounded.
  * adapted (simplified) from: http://coliru.stacked-crooked.com/a/d04973a3cf6ba8a5
+ *
+ * The `COALESCE` policy requires `T` to have a `channel` member. With this
+ * policy, the most recent queued element of each channel is indexed so that
+ * a push to a full queue does not scan it (references to the elements of a
+ * deque are stable when pushing and popping at its ends).
  */
 template<typename T>
 class LockedQueue {
@@ -21,11 +50,67 @@ class LockedQueue {
     virtual ~LockedQueue() = default;
 
     /**
-     * add an element to th queue
+     * bound the queue to `capacity` elements (0 for unbounded), elements
+     * already queued are kept
      */
-    void push(std::shared_ptr<T> value) {
+    void setCapacity(size_t capacity, OverflowPolicy policy) {
       std::lock_guard<std::mutex> lock(mut);
-      data_queue.push(value);
+      stats_.capacity = capacity;
+      stats_.policy = policy;
+
+      latest_.clear();
+
+      if (this->coalescing_()) {
+        for (auto &element : data_queue) {
+          latest_[element->channel] = &element;
+        }
+      }
+    }
+
+    /**
+     * add an element to th queue, return false if an element had to be dropped
+     * or coalesced
+     */
+    bool push(std::shared_ptr<T> value) {
+      std::lock_guard<std::mutex> lock(mut);
+      stats_.pushed += 1;
+
+      if (stats_.capacity > 0 && data_queue.size() >= stats_.capacity) {
+        switch (stats_.policy) {
+          case OverflowPolicy::DROP_NEWEST: {
+            stats_.dropped += 1;
+            return false;
+          }
+          case OverflowPolicy::DROP_OLDEST: {
+            this->popFront_();
+            stats_.dropped += 1;
+            break;
+          }
+          case OverflowPolicy::COALESCE: {
+            auto latest = latest_.find(value->channel);
+
+            if (latest != latest_.end()) {
+              *latest->second = value;
+              stats_.coalesced += 1;
+            } else {
+              stats_.dropped += 1;
+            }
+
+            return false;
+          }
+        }
+
+        this->pushBack_(value);
+        return false;
+      }
+
+      this->pushBack_(value);
+
+      if (data_queue.size() > stats_.highWater) {
+        stats_.highWater = data_queue.size();
+      }
+
+      return true;
     }
 
     /**
@@ -39,7 +124,7 @@ class LockedQueue {
       }
 
       auto res = data_queue.front();
-      data_queue.pop();
+      this->popFront_();
 
       return res;
     }
@@ -54,9 +139,44 @@ class LockedQueue {
       return data_queue.size();
     }
 
+    queue_stats_t stats() const {
+      std::lock_guard<std::mutex> lock(mut);
+      queue_stats_t stats = stats_;
+      stats.depth = data_queue.size();
+      return stats;
+    }
+
   private:
+    bool coalescing_() const {
+      return stats_.capacity > 0 && stats_.policy == OverflowPolicy::COALESCE;
+    }
+
+    void pushBack_(std::shared_ptr<T> &value) {
+      data_queue.push_back(value);
+
+      if (this->coalescing_()) {
+        latest_[value->channel] = &data_queue.back();
+      }
+    }
+
+    void popFront_() {
+      if (this->coalescing_()) {
+        auto latest = latest_.find(data_queue.front()->channel);
+
+        // last queued element of its channel
+        if (latest != latest_.end() && latest->second == &data_queue.front()) {
+          latest_.erase(latest);
+        }
+      }
+
+      data_queue.pop_front();
+    }
+
     mutable std::mutex mut;
-    std::queue<std::shared_ptr<T>> data_queue;
+    std::deque<std::shared_ptr<T>> data_queue;
+    queue_stats_t stats_;
+    // channel -> most recent queued element, only with the COALESCE policy
+    std::unordered_map<std::string, std::shared_ptr<T> *> latest_;
 };
 
 }; // namespace
@@ -0,0 +1,201 @@
+#include "./LogRing.h"
+
+#include <chrono>
+#include <iostream>
+
+namespace node_lib_pd {
+
+LogRing::LogRing()
+  : ring_(DEFAULT_CAPACITY)
+  , head_(0)
+  , count_(0)
+  , maxRate_(DEFAULT_MAX_RATE)
+  , minLevel_(LogLevel::INFO)
+  , consoleLevel_(LogLevel::WARN)
+  , console_(true)
+  , size_(0)
+{
+  this->stats_.capacity = DEFAULT_CAPACITY;
+}
+
+double LogRing::now() {
+  const std::chrono::duration<double, std::milli> time =
+      std::chrono::system_clock::now().time_since_epoch();
+  return time.count();
+}
+
+void LogRing::configure(size_t capacity, double maxRate, LogLevel minLevel,
+                        LogLevel consoleLevel, bool console) {
+  std::lock_guard<std::mutex> lock(this->mut_);
+
+  if (capacity < 1) {
+    capacity = 1;
+  }
+
+  // pending lines are lost, the ring is configured before pd is started
+  this->ring_.assign(capacity, log_entry_t());
+  this->head_ = 0;
+  this->count_ = 0;
+  this->size_ = 0;
+  this->stats_.capacity = capacity;
+
+  this->maxRate_ = maxRate > 0 ? maxRate : 0;
+  this->minLevel_ = minLevel;
+  this->consoleLevel_ = consoleLevel;
+  this->console_ = console;
+  this->buckets_.clear();
+}
+
+void LogRing::pushPd(const std::string &line) {
+  LogLevel level = LogLevel::INFO;
+  size_t start = 0;
+
+  // prefixes added by pd's `pd_error`, `post` and `verbose`
+  if (line.compare(0, 7, "error: ") == 0) {
+    level = LogLevel::ERROR;
+    start = 7;
+  } else if (line.compare(0, 9, "warning: ") == 0) {
+    level = LogLevel::WARN;
+    start = 9;
+  } else if (line.compare(0, 8, "verbose(") == 0) {
+    level = LogLevel::DEBUG;
+  }
+
+  // `[print foo]` outputs `foo: ...`
+  std::string source = "pd";
+  const size_t colon = line.find(": ", start);
+
+  if (level == LogLevel::INFO && colon != std::string::npos && colon > start &&
+      line.find(' ', start) > colon) {
+    source += ":" + line.substr(start, colon - start);
+  }
+
+  this->push(level, source, line);
+}
+
+void LogRing::push(LogLevel level, const std::string &source,
+                   const std::string &message) {
+  std::lock_guard<std::mutex> lock(this->mut_);
+  const double time = now();
+
+  this->stats_.pushed += 1;
+
+  if (this->console_ && level <= this->consoleLevel_ &&
+      source.compare(0, 2, "pd") != 0) {
+    std::cout << "[" << source << "] " << message << std::endl;
+  }
+
+  if (level > this->minLevel_) {
+    this->stats_.suppressed += 1;
+    return;
+  }
+
+  if (this->maxRate_ > 0) {
+    bucket_t &bucket = this->buckets_[source];
+    const double elapsed = bucket.last == 0 ? 1000 : time - bucket.last;
+
+    // bursts of up to one second of lines
+    bucket.tokens += elapsed * this->maxRate_ / 1000;
+
+    if (bucket.tokens > this->maxRate_) {
+      bucket.tokens = this->maxRate_;
+    }
+
+    bucket.last = time;
+
+    if (bucket.tokens < 1) {
+      bucket.suppressed += 1;
+      this->stats_.suppressed += 1;
+      return;
+    }
+
+    bucket.tokens -= 1;
+
+    if (bucket.suppressed > 0) {
+      this->write_(time, LogLevel::WARN, source,
+                   std::to_string(bucket.suppressed) +
+                       " lines suppressed by the rate limit");
+      bucket.suppressed = 0;
+    }
+  }
+
+  this->write_(time, level, source, message);
+}
+
+void LogRing::write_(double time, LogLevel level, const std::string &source,
+                     const std::string &message) {
+  const size_t capacity = this->ring_.size();
+  size_t index;
+
+  if (this->count_ == capacity) {
+    // overwrite the oldest line
+    index = this->head_;
+    this->head_ = (this->head_ + 1) % capacity;
+    this->stats_.dropped += 1;
+  } else {
+    index = (this->head_ + this->count_) % capacity;
+    this->count_ += 1;
+  }
+
+  log_entry_t &entry = this->ring_[index];
+  entry.time = time;
+  entry.level = level;
+  entry.source = source;
+  entry.message = message;
+
+  this->size_ = this->count_;
+}
+
+bool LogRing::empty() const {
+  return this->size_.load(std::memory_order_relaxed) == 0;
+}
+
+void LogRing::drain(std::vector<log_entry_t> &dest) {
+  std::lock_guard<std::mutex> lock(this->mut_);
+  const size_t capacity = this->ring_.size();
+
+  for (size_t i = 0; i < this->count_; i++) {
+    log_entry_t &entry = this->ring_[(this->head_ + i) % capacity];
+    dest.push_back(std::move(entry));
+  }
+
+  this->head_ = 0;
+  this->count_ = 0;
+  this->size_ = 0;
+}
+
+log_stats_t LogRing::stats() const {
+  std::lock_guard<std::mutex> lock(this->mut_);
+  log_stats_t stats = this->stats_;
+  stats.depth = this->count_;
+  return stats;
+}
+
+const char *LogRing::levelName(LogLevel level) {
+  switch (level) {
+    case LogLevel::ERROR: return "error";
+    case LogLevel::WARN: return "warn";
+    case LogLevel::INFO: return "info";
+    case LogLevel::DEBUG: return "debug";
+  }
+
+  return "info";
+}
+
+bool LogRing::parseLevel(const std::string &name, LogLevel &level) {
+  if (name == "error") {
+    level = LogLevel::ERROR;
+  } else if (name == "warn") {
+    level = LogLevel::WARN;
+  } else if (name == "info") {
+    level = LogLevel::INFO;
+  } else if (name == "debug") {
+    level = LogLevel::DEBUG;
+  } else {
+    return false;
+  }
+
+  return true;
+}
+
+}; // namespace
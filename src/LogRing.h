@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace node_lib_pd {
+
+enum class LogLevel { ERROR = 0, WARN, INFO, DEBUG };
+
+struct log_entry_t {
+  double time = 0;      // ms since epoch
+  LogLevel level = LogLevel::INFO;
+  std::string source;   // `pd`, `pd:<print name>`, `portaudio` or `node-libpd`
+  std::string message;
+};
+
+struct log_stats_t {
+  size_t capacity = 0;
+  size_t depth = 0;
+  uint64_t pushed = 0;
+  uint64_t dropped = 0;    // overwritten before being delivered
+  uint64_t suppressed = 0; // rate limited or below the minimum level
+};
+
+/**
+ * Bounded ring of log lines, kept apart from the control messages so that a
+ * chatty patch never delays them. The oldest lines are overwritten when the
+ * ring is full, lines are rate limited per source (token bucket) and
+ * delivered to js in batches by the background process.
+ *
+ * Native sources (i.e. not pd) are also echoed to stdout from `consoleLevel`,
+ * so that errors are visible even if they happen before js can be notified.
+ */
+class LogRing {
+  public:
+    static const size_t DEFAULT_CAPACITY = 256;
+    static constexpr double DEFAULT_MAX_RATE = 50;
+
+    LogRing();
+
+    // `maxRate` in lines per second and per source, 0 for unlimited
+    void configure(size_t capacity, double maxRate, LogLevel minLevel,
+                   LogLevel consoleLevel, bool console);
+
+    // severity and source of a line printed by pd, e.g. `error: ...`,
+    // `foo: 1` for `[print foo]`
+    void pushPd(const std::string &line);
+    void push(LogLevel level, const std::string &source,
+              const std::string &message);
+
+    bool empty() const;
+    // move the pending lines to `dest`, in order
+    void drain(std::vector<log_entry_t> &dest);
+    log_stats_t stats() const;
+
+    static const char *levelName(LogLevel level);
+    // return false if `name` is not a level name
+    static bool parseLevel(const std::string &name, LogLevel &level);
+
+  private:
+    struct bucket_t {
+      double tokens = 0;
+      double last = 0; // ms
+      uint64_t suppressed = 0;
+    };
+
+    static double now();
+    void write_(double time, LogLevel level, const std::string &source,
+                const std::string &message);
+
+    std::vector<log_entry_t> ring_;
+    size_t head_;  // index of the oldest line
+    size_t count_;
+    double maxRate_;
+    LogLevel minLevel_;
+    LogLevel consoleLevel_;
+    bool console_;
+    std::map<std::string, bucket_t> buckets_;
+    std::atomic<size_t> size_;
+    log_stats_t stats_;
+    mutable std::mutex mut_;
+};
+
+}; // namespace
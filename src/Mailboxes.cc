@@ -0,0 +1,131 @@
+#include "./Mailboxes.h"
+
+#include <cstring>
+
+namespace node_lib_pd {
+
+Mailboxes::Mailboxes()
+  : size_(0)
+  , table_(new table_t())
+  , writers_(0)
+{}
+
+Mailboxes::~Mailboxes() {
+  delete this->table_.load();
+
+  for (const table_t *table : this->retired_) {
+    delete table;
+  }
+}
+
+std::shared_ptr<mailbox_t> Mailboxes::open(const std::string &channel,
+                                           bool &created) {
+  entry_t &entry = this->entries_[channel];
+
+  created = !entry.mailbox;
+
+  if (created) {
+    entry.mailbox = std::make_shared<mailbox_t>();
+    entry.mailbox->sequence = 0;
+    entry.mailbox->length = 0;
+    memset(entry.mailbox->values, 0, sizeof(entry.mailbox->values));
+    this->publish_();
+  }
+
+  entry.refs += 1;
+
+  return entry.mailbox;
+}
+
+bool Mailboxes::close(const std::string &channel) {
+  auto search = this->entries_.find(channel);
+
+  if (search == this->entries_.end()) {
+    return false;
+  }
+
+  search->second.refs -= 1;
+
+  if (search->second.refs > 0) {
+    return false;
+  }
+
+  // the memory is released once js does not reference it anymore
+  this->entries_.erase(search);
+  this->publish_();
+
+  return true;
+}
+
+bool Mailboxes::empty() const {
+  return this->size_.load(std::memory_order_relaxed) == 0;
+}
+
+bool Mailboxes::write(const std::string &channel, const float *values,
+                      int length) {
+  // most channels have no mailbox
+  if (this->empty()) {
+    return false;
+  }
+
+  // announce the write before loading the table, see `reclaim_`
+  this->writers_.fetch_add(1);
+  const table_t *table = this->table_.load();
+  auto search = table->find(channel);
+
+  if (search == table->end()) {
+    this->writers_.fetch_sub(1);
+    return false;
+  }
+
+  mailbox_t &mailbox = *search->second;
+  // single writer at a time, pd delivers messages under its own lock
+  const uint32_t sequence = mailbox.sequence.load(std::memory_order_relaxed);
+
+  if (length > mailbox_t::MAX_VALUES) {
+    length = mailbox_t::MAX_VALUES;
+  }
+
+  mailbox.sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  mailbox.length = length;
+
+  for (int i = 0; i < length; i++) {
+    mailbox.values[i] = values[i];
+  }
+
+  mailbox.sequence.store(sequence + 2, std::memory_order_release);
+  this->writers_.fetch_sub(1);
+
+  return true;
+}
+
+void Mailboxes::publish_() {
+  table_t *table = new table_t();
+
+  for (auto &entry : this->entries_) {
+    table->emplace(entry.first, entry.second.mailbox);
+  }
+
+  this->retired_.push_back(this->table_.exchange(table));
+  this->size_ = this->entries_.size();
+  this->reclaim_();
+}
+
+void Mailboxes::reclaim_() {
+  // sequentially consistent with `write`: if no writer is seen after the
+  // exchange, writers starting afterwards load the new table, otherwise the
+  // retired tables (and their mailboxes) are kept until a later change
+  if (this->writers_.load() != 0) {
+    return;
+  }
+
+  for (const table_t *table : this->retired_) {
+    delete table;
+  }
+
+  this->retired_.clear();
+}
+
+}; // namespace
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace node_lib_pd {
+
+/**
+ * Latest value received on a channel, shared with js through an external
+ * ArrayBuffer (one cache line), read as
+ * `Uint32Array [sequence, length]` followed by `Float32Array values`.
+ */
+struct mailbox_t {
+  static const int MAX_VALUES = 14;
+
+  // odd while the values are being written, incremented by 2 per message
+  std::atomic<uint32_t> sequence;
+  uint32_t length;
+  float values[MAX_VALUES];
+};
+
+static_assert(sizeof(mailbox_t) == 64, "mailbox_t must fit a cache line");
+
+/**
+ * Mailboxes of the channels whose current value is polled from js instead of
+ * being dispatched as messages. Written by the threads running pd, which pd
+ * serializes, under a sequence lock so that js never reads a partially
+ * written list.
+ *
+ * As in `SubscriptionTable`, the channels are published as an immutable
+ * table copied and swapped by the js thread, so that `write` never locks.
+ * `open` and `close` must be called from the js thread.
+ */
+class Mailboxes {
+  public:
+    Mailboxes();
+    ~Mailboxes();
+
+    // return the mailbox of the channel, `created` is set if it has not been
+    // opened before
+    std::shared_ptr<mailbox_t> open(const std::string &channel, bool &created);
+    // return true if the mailbox has been closed as many times as opened
+    bool close(const std::string &channel);
+
+    bool empty() const;
+
+    // write the values of a message (none for a bang), return false if the
+    // channel has no mailbox
+    bool write(const std::string &channel, const float *values, int length);
+
+  private:
+    struct entry_t {
+      std::shared_ptr<mailbox_t> mailbox;
+      int refs = 0;
+    };
+
+    typedef std::map<std::string, std::shared_ptr<mailbox_t>> table_t;
+
+    // publish the mailboxes of `entries_` in place of the current table
+    void publish_();
+    void reclaim_();
+
+    std::atomic<int> size_;
+    // js thread only
+    std::map<std::string, entry_t> entries_;
+    // read by the threads running pd, only replaced by the js thread
+    std::atomic<const table_t *> table_;
+    // number of `write` in progress
+    std::atomic<int> writers_;
+    std::vector<const table_t *> retired_;
+};
+
+}; // namespace
@@ -0,0 +1,97 @@
+#include "./MemoryLock.h"
+
+#include <alloca.h>
+#include <errno.h>
+#include <fstream>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace node_lib_pd {
+
+MemoryLock::MemoryLock()
+  : locked_(false)
+  , future_(false)
+  , error_(0)
+{}
+
+MemoryLock::~MemoryLock() {
+  this->unlock();
+}
+
+bool MemoryLock::lock(bool future) {
+#ifdef __linux__
+  const int flags = future ? (MCL_CURRENT | MCL_FUTURE) : MCL_CURRENT;
+
+  if (mlockall(flags) != 0) {
+    this->error_ = errno;
+    return false;
+  }
+
+  this->locked_ = true;
+  this->future_ = future;
+  this->error_ = 0;
+  return true;
+#else
+  this->error_ = ENOTSUP;
+  return false;
+#endif
+}
+
+bool MemoryLock::relock() {
+  if (!this->locked_ || this->future_) {
+    return this->locked_;
+  }
+
+  return this->lock(false);
+}
+
+void MemoryLock::unlock() {
+#ifdef __linux__
+  if (this->locked_) {
+    munlockall();
+  }
+#endif
+
+  this->locked_ = false;
+  this->future_ = false;
+}
+
+bool MemoryLock::isLocked() const {
+  return this->locked_;
+}
+
+bool MemoryLock::isFuture() const {
+  return this->future_;
+}
+
+int MemoryLock::error() const {
+  return this->error_;
+}
+
+long MemoryLock::lockedBytes() {
+#ifdef __linux__
+  std::ifstream status("/proc/self/status");
+  std::string line;
+
+  while (std::getline(status, line)) {
+    // e.g. "VmLck:     1234 kB"
+    if (line.compare(0, 6, "VmLck:") == 0) {
+      return std::stol(line.substr(6)) * 1024;
+    }
+  }
+#endif
+
+  return -1;
+}
+
+void MemoryLock::prefaultStack(size_t size) {
+  volatile unsigned char *stack = (volatile unsigned char *)alloca(size);
+  const long pageSize = sysconf(_SC_PAGESIZE);
+
+  for (size_t i = 0; i < size; i += pageSize) {
+    stack[i] = 0;
+  }
+}
+
+}; // namespace
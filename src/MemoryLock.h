@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stddef.h>
+
+namespace node_lib_pd {
+
+/**
+ * Keep the memory of the process resident so that the audio thread does not
+ * page fault after the process has been idle or swapped.
+ *
+ * `lock` uses `mlockall`, which also faults in every page currently mapped,
+ * i.e. the buffers already allocated by portaudio, pd and the receiver. With
+ * `future`, pages mapped afterwards are locked too, otherwise `relock` should
+ * be called once new buffers are allocated (e.g. pd dsp buffers after a patch
+ * is loaded). Linux only, fails with ENOTSUP elsewhere.
+ */
+class MemoryLock {
+  public:
+    MemoryLock();
+    ~MemoryLock();
+
+    // stack size touched by `prefaultStack`
+    static const size_t STACK_PREFAULT_SIZE = 256 * 1024;
+
+    bool lock(bool future);
+    // lock the pages mapped since `lock`, no-op if not locked or `future`
+    bool relock();
+    void unlock();
+
+    bool isLocked() const;
+    bool isFuture() const;
+    // errno of the last failed call, 0 if none
+    int error() const;
+
+    /**
+     * bytes locked by the process (`VmLck`), -1 if unknown
+     */
+    static long lockedBytes();
+
+    /**
+     * touch the next `size` bytes of the calling thread stack so that they
+     * are mapped before they are needed in realtime code
+     */
+    static void prefaultStack(size_t size = STACK_PREFAULT_SIZE);
+
+  private:
+    bool locked_;
+    bool future_;
+    int error_;
+};
+
+}; // namespace
@@ -16,6 +16,7 @@ Napi::Object NodePd::Init(Napi::Env env, Napi::Object exports) {
           InstanceAccessor<&NodePd::CurrentTime>("currentTime"),
 
           InstanceMethod("destroy", &NodePd::Destroy),
+          InstanceMethod("getInitTimings", &NodePd::GetInitTimings),
 
           InstanceMethod("computeAudio", &NodePd::ComputeAudio),
 
@@ -26,15 +27,38 @@ Napi::Object NodePd::Init(Napi::Env env, Napi::Object exports) {
           InstanceMethod("getInputDevices", &NodePd::GetInputDevices),
           InstanceMethod("getOutputDevices", &NodePd::GetOutputDevices),
           InstanceMethod("getDeviceAtIndex", &NodePd::GetDeviceAtIndex),
-
-          InstanceMethod("closePatch", &NodePd::ClosePatch),
+          InstanceMethod("refreshDevices", &NodePd::RefreshDevices),
+          InstanceMethod("getStreamInfo", &NodePd::GetStreamInfo),
+          InstanceMethod("getThreadSettings", &NodePd::GetThreadSettings),
+          InstanceMethod("getMemoryLock", &NodePd::GetMemoryLock),
+          InstanceMethod("getAudioStats", &NodePd::GetAudioStats),
+          InstanceMethod("getDspLoad", &NodePd::GetDspLoad),
+          InstanceMethod("resetDspLoad", &NodePd::ResetDspLoad),
+          InstanceMethod("enableLatencyTracing", &NodePd::EnableLatencyTracing),
+          InstanceMethod("getLatencyStats", &NodePd::GetLatencyStats),
+          InstanceMethod("resetLatencyStats", &NodePd::ResetLatencyStats),
+          InstanceMethod("getQueueStats", &NodePd::GetQueueStats),
+          InstanceMethod("getLogStats", &NodePd::GetLogStats),
+
+          InstanceMethod("_closePatch", &NodePd::ClosePatch),
+          InstanceMethod("_closePatchAsync", &NodePd::ClosePatchAsync),
           InstanceMethod("addToSearchPath", &NodePd::AddToSearchPath),
           InstanceMethod("clearSearchPath", &NodePd::ClearSearchPath),
+          InstanceMethod("enablePatchCache", &NodePd::EnablePatchCache),
+          InstanceMethod("clearPatchCache", &NodePd::ClearPatchCache),
+          InstanceMethod("getPatchCacheStats", &NodePd::GetPatchCacheStats),
           InstanceMethod("send", &NodePd::Send),
           InstanceMethod("readArray", &NodePd::ReadArray),
+          InstanceMethod("readArrays", &NodePd::ReadArrays),
           InstanceMethod("writeArray", &NodePd::WriteArray),
+          InstanceMethod("writeArrayAtomic", &NodePd::WriteArrayAtomic),
           InstanceMethod("clearArray", &NodePd::ClearArray),
+          InstanceMethod("writeArrayAsync", &NodePd::WriteArrayAsync),
+          InstanceMethod("readArrayAsync", &NodePd::ReadArrayAsync),
           InstanceMethod("arraySize", &NodePd::ArraySize),
+          InstanceMethod("trackArrayChanges", &NodePd::TrackArrayChanges),
+          InstanceMethod("untrackArrayChanges", &NodePd::UntrackArrayChanges),
+          InstanceMethod("readArrayChanges", &NodePd::ReadArrayChanges),
 
           InstanceMethod("startGUI", &NodePd::StartGUI),
           InstanceMethod("pollGUI", &NodePd::PollGUI),
@@ -42,9 +66,22 @@ Napi::Object NodePd::Init(Napi::Env env, Napi::Object exports) {
 
           // monkey patched on the js side
           InstanceMethod("_initialize", &NodePd::Initialize),
+          InstanceMethod("_initializeAsync", &NodePd::InitializeAsync),
           InstanceMethod("_openPatch", &NodePd::OpenPatch),
+          InstanceMethod("_openPatchAsync", &NodePd::OpenPatchAsync),
+          InstanceMethod("_createPatchPool", &NodePd::CreatePatchPool),
+          InstanceMethod("_growPatchPool", &NodePd::GrowPatchPool),
+          InstanceMethod("_acquirePatch", &NodePd::AcquirePatch),
+          InstanceMethod("_releasePatch", &NodePd::ReleasePatch),
+          InstanceMethod("_patchPoolAvailable", &NodePd::PatchPoolAvailable),
+          InstanceMethod("_destroyPatchPool", &NodePd::DestroyPatchPool),
           InstanceMethod("_subscribe", &NodePd::Subscribe),
           InstanceMethod("_unsubscribe", &NodePd::Unsubscribe),
+          InstanceMethod("_mailbox", &NodePd::Mailbox),
+          InstanceMethod("_closeMailbox", &NodePd::CloseMailbox),
+          InstanceMethod("_loadSoundfile", &NodePd::LoadSoundfile),
+          InstanceMethod("_arrayView", &NodePd::ArrayView),
+          InstanceMethod("_arrayViewGeneration", &NodePd::ArrayViewGeneration),
       });
 
 // node: DEBUG seems to be defined when doing `node-gyp build --debug`
@@ -61,7 +98,8 @@ Napi::Object NodePd::Init(Napi::Env env, Napi::Object exports) {
 }
 
 NodePd::NodePd(const Napi::CallbackInfo &info)
-    : Napi::ObjectWrap<NodePd>(info), initialized_(false) {
+    : Napi::ObjectWrap<NodePd>(info), initialized_(false),
+      initializing_(false), pdInitDuration_(0), backgroundProcess_(NULL) {
   Napi::Env env = info.Env();
   Napi::HandleScope scope(env);
 
@@ -75,13 +113,40 @@ NodePd::NodePd(const Napi::CallbackInfo &info)
   this->audioConfig_->numOutputChannels = this->DEFAULT_NUM_OUTPUT_CHANNELS;
   this->audioConfig_->sampleRate = this->DEFAULT_SAMPLE_RATE;
   this->audioConfig_->ticks = this->DEFAULT_NUM_TICKS;
+  this->audioConfig_->inputDevice = -1;
+  this->audioConfig_->outputDevice = -1;
+  this->audioConfig_->hostApi = -1;
+  this->audioConfig_->inputLatency = -1;
+  this->audioConfig_->outputLatency = -1;
+  this->audioConfig_->streamFlags = paClipOff;
+  this->audioConfig_->processRaw = false;
+  this->audioConfig_->dspThread.policy = -1;
+  this->audioConfig_->dspThread.priority = 0;
+  this->audioConfig_->dspThread.cpuMask = 0;
+  this->audioConfig_->messageThread.policy = -1;
+  this->audioConfig_->messageThread.priority = 0;
+  this->audioConfig_->messageThread.cpuMask = 0;
+  this->audioConfig_->lockMemory = 0;
+  this->audioConfig_->xrunEvents = false;
+  this->audioConfig_->backend = BACKEND_PORTAUDIO;
+  this->audioConfig_->realtime = true;
+  this->audioConfig_->receiveQueue.capacity = 0;
+  this->audioConfig_->receiveQueue.policy = OverflowPolicy::DROP_NEWEST;
+  this->audioConfig_->sendQueue.capacity = 0;
+  this->audioConfig_->sendQueue.policy = OverflowPolicy::DROP_NEWEST;
 
   // queue for sharing messages between PdReceiver and BackgroundProcess
   this->msgQueue_ = new LockedQueue<pd_msg_t>();
 
-  this->paWrapper_ = new PaWrapper();
+  // tasks applied by the audio thread between ticks
+  this->tickScheduler_ = new TickScheduler();
+
+  this->paWrapper_ = new PaWrapper(&this->logRing_);
   this->pdWrapper_ = new PdWrapper();
-  this->pdReceiver_ = new PdReceiver(msgQueue_);
+  this->pdReceiver_ = new PdReceiver(msgQueue_, &this->latencyTracer_,
+                                     &this->channelFilters_,
+                                     &this->subscriptions_, &this->mailboxes_,
+                                     &this->logRing_);
 }
 
 NodePd::~NodePd() {
@@ -94,6 +159,7 @@ NodePd::~NodePd() {
   delete this->paWrapper_;
   delete this->pdWrapper_;
   delete this->pdReceiver_;
+  delete this->tickScheduler_;
 
   free(this->audioConfig_);
 }
@@ -116,88 +182,74 @@ NodePd::~NodePd() {
  * @param {int} [param.numOutputChannels=2] - number of output channels
  * @param {int} [param.sampleRate=44100] - sample rate
  * @param {int} [param.ticks=1] - ticks
+ * @param {int} [param.inputDevice] - index of the input device
+ * @param {int} [param.outputDevice] - index of the output device
+ * @param {double} [param.inputLatency] - suggested input latency in seconds
+ * @param {double} [param.outputLatency] - suggested output latency in seconds
+ * @param {string|int} [param.hostApi] - name or index of the host API
+ * @param {Array<string>} [param.streamFlags=['clipOff']] - portaudio flags
+ * @param {int} [param.framesPerBuffer] - host buffer size, 0 for unspecified,
+ * defaults to blockSize * ticks
+ * @param {bool} [param.processRaw=false] - convert between interleaved and
+ * pd buffers with simd instructions and process them with libpd_process_raw
+ * @param {Object} [param.threads] - scheduling of the `dsp` and `message`
+ * threads, e.g. { dsp: { policy: 'fifo', priority: 80, cpus: [1] } }
+ * @param {bool|string} [param.lockMemory=false] - mlockall the process, use
+ * 'future' to also lock pages mapped afterwards
+ * @param {bool} [param.xrunEvents=false] - push xrun events on the `xrun`
+ * channel
+ * @param {Object} [param.receiveQueue] - bound the queue of messages received
+ * from pd, e.g. { capacity: 1024, policy: 'dropOldest' }
+ * @param {Object} [param.sendQueue] - bound the queue of messages scheduled
+ * to pd, same options as `receiveQueue`
+ * @param {Object} [param.log] - log ring options, e.g. { capacity: 256,
+ * level: 'info', maxRate: 50, console: 'warn' }
+ * @param {string} [param.backend='portaudio'] - 'offline' processes silent
+ * buffers from a thread of its own, without opening any audio device
+ * @param {bool} [param.realtime=true] - with the offline backend, pace the
+ * processing on the sample rate, false runs as fast as possible
  */
 Napi::Value NodePd::Initialize(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
-  if (info.Length() != 3 || !info[0].IsObject() || !info[1].IsBoolean() || !info[2].IsFunction()) {
+  if (info.Length() != 2 || !info[0].IsObject() || !info[1].IsBoolean()) {
     Napi::Error::New(env, "Invalid Arguments").ThrowAsJavaScriptException();
   }
 
-  if (this->initialized_ == false) {
-    int numInputChannels = this->audioConfig_->numInputChannels;
-    int numOutputChannels = this->audioConfig_->numOutputChannels;
-    int sampleRate = this->audioConfig_->sampleRate;
-    int ticks = this->audioConfig_->ticks;
-
+  if (this->initialized_ == false && this->initializing_ == false) {
     Napi::Object obj = info[0].As<Napi::Object>();
-
-    if (obj.Has("numInputChannels")) {
-      numInputChannels =
-          obj.Get("numInputChannels").As<Napi::Number>().Int32Value();
-    }
-
-    if (obj.Has("numOutputChannels")) {
-      numOutputChannels =
-          obj.Get("numOutputChannels").As<Napi::Number>().Int32Value();
-    }
-
-    if (obj.Has("sampleRate")) {
-      sampleRate = obj.Get("sampleRate").As<Napi::Number>().Int32Value();
-    }
-
-    if (obj.Has("ticks")) {
-      ticks = obj.Get("ticks").As<Napi::Number>().Int32Value();
-    }
-
-    const int blockSize = this->pdWrapper_->blockSize();
-
-    this->audioConfig_->numInputChannels = numInputChannels;
-    this->audioConfig_->numOutputChannels = numOutputChannels;
-    this->audioConfig_->sampleRate = sampleRate;
-    this->audioConfig_->ticks = ticks; // number of blocks processed by pd in
-    this->audioConfig_->blockSize =
-        blockSize; // size of the pd blocks (e.g. 64)
-    this->audioConfig_->framesPerBuffer = blockSize * ticks;
-    this->audioConfig_->bufferDuration =
-        (double)blockSize * (double)ticks / (double)sampleRate;
-
+    const int timeout = this->ConfigureAudio_(obj);
     const bool compute_audio = info[1].As<Napi::Boolean>().Value();
 
-    // init lib-pd
-    const bool pdInitialized = this->pdWrapper_->init(this->audioConfig_, compute_audio);
-    this->pdWrapper_->setReceiver(this->pdReceiver_);
-
-    // // init portaudio
-    const bool paInitialized = this->paWrapper_->init(
-        this->audioConfig_, this->pdWrapper_->getLibPdInstance());
+    std::string error;
 
-    Napi::Function callback = info[2].As<Napi::Function>();
-
-    this->backgroundProcess_ =
-        new BackgroundProcess(callback, this->audioConfig_, this->msgQueue_,
-                              this->paWrapper_, this->pdWrapper_);
-
-    this->backgroundProcess_->Queue();
+    if (!this->StartAudio_(compute_audio, error)) {
+      this->logRing_.push(LogLevel::ERROR, "node-libpd", error);
+      return Napi::Boolean::New(env, false);
+    }
 
-    int millis = 0; // for debug
+    int millis = 0;
     // block process while time is not running
-    // @note: maybe move to Promise API, but probably not really important
-    // here...
-    while ((double)this->paWrapper_->currentTime <= 0.0f) {
-      millis += 1; // for debug
+    while (!this->paWrapper_->started) {
+      if (millis >= timeout) {
+        this->logRing_.push(LogLevel::ERROR, "node-libpd",
+                            "Audio stream did not start within " +
+                                std::to_string(timeout) + "ms");
+        this->StopAudio_();
+        return Napi::Boolean::New(env, false);
+      }
+
+      millis += 1;
       std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
 
 #ifdef DEBUG
-    std::cout << "[node-libpd] > pd initialized: " << pdInitialized
-              << std::endl;
-    std::cout << "[node-libpd] > portaudio initialized: " << paInitialized
-              << std::endl;
     std::cout << "[node-libpd] audio started in: " << millis << "ms"
               << std::endl;
 #endif
 
+    this->StartBackgroundProcess_(env);
+
     this->initialized_ = true;
     return Napi::Boolean::New(info.Env(), this->initialized_);
   } else {
@@ -206,628 +258,2249 @@ Napi::Value NodePd::Initialize(const Napi::CallbackInfo &info) {
 }
 
 /**
- * clear Pd instance.
- * need to stop the background process cleanly
+ * Same as `Initialize` but pd and the audio stream are started from a worker
+ * thread, the returned Promise is resolved with the init timings once the
+ * first audio callback has run, or rejected after `config.timeout`.
  */
-Napi::Value NodePd::Destroy(const Napi::CallbackInfo &info) {
-#ifdef DEBUG
-  std::cout << "[node-libpd] destroy node-libpd instance" << std::endl;
-#endif
+Napi::Value NodePd::InitializeAsync(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
 
-  // not sure c++ guys would like that...
-  delete this;
+  if (info.Length() != 2 || !info[0].IsObject() || !info[1].IsBoolean()) {
+    Napi::Error::New(env, "Invalid Arguments").ThrowAsJavaScriptException();
+  }
 
-  return info.Env().Undefined();
-}
+  if (this->initialized_ || this->initializing_) {
+    Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+    deferred.Reject(Napi::Error::New(env, this->initialized_
+                                              ? "pd is already initialized"
+                                              : "pd is being initialized")
+                        .Value());
+    return deferred.Promise();
+  }
 
-// --------------------------------------------------------------------------
-// --------------------------------------------------------------------------
-//
-// DYNAMIC CONFIGURATION
-//
-// --------------------------------------------------------------------------
-// --------------------------------------------------------------------------
+  Napi::Object obj = info[0].As<Napi::Object>();
+  const int timeout = this->ConfigureAudio_(obj);
+  const bool compute_audio = info[1].As<Napi::Boolean>().Value();
+
+  this->initializing_ = true;
+
+  InitWorker *worker = new InitWorker(
+      env,
+      [this, compute_audio](std::string &error) {
+        return this->StartAudio_(compute_audio, error);
+      },
+      [this]() { return this->paWrapper_->started.load(); },
+      [this](Napi::Env env) {
+        this->StartBackgroundProcess_(env);
+
+        this->initializing_ = false;
+        this->initialized_ = true;
+
+        return this->InitTimings_(env);
+      },
+      [this]() {
+        this->StopAudio_();
+        this->initializing_ = false;
+      },
+      timeout);
+
+  Napi::Promise promise = worker->GetPromise();
+  worker->Queue();
+
+  return promise;
+}
 
 /**
- * Set PD to compute audio or not.
+ * @return {Object} - durations (in ms) of the init steps: { pdInit,
+ *  paInitialize, streamOpen, firstCallback }
  */
-Napi::Value NodePd::ComputeAudio(const Napi::CallbackInfo &info) {
-  bool compute_audio = true;
+Napi::Value NodePd::GetInitTimings(const Napi::CallbackInfo &info) {
+  return this->InitTimings_(info.Env());
+}
 
-  if (info.Length() >= 1 && info[0].IsBoolean()) {
-    compute_audio = info[0].As<Napi::Boolean>().Value();
+/**
+ * @return {Object} - counters of the portaudio callback status flags and
+ *  most recent xrun events: { callbacks, frames, inputUnderflows,
+ *  inputOverflows, outputUnderflows, outputOverflows, primingOutputs, xruns,
+ *  events }
+ */
+Napi::Value NodePd::GetAudioStats(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  const AudioStats &stats = this->paWrapper_->audioStats;
+
+  std::vector<xrun_event_t> events;
+  const uint64_t xruns = stats.events(0, events);
+
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("callbacks", Napi::Number::New(env, (double)stats.callbacks()));
+  obj.Set("frames", Napi::Number::New(env, (double)stats.frames()));
+  obj.Set("inputUnderflows",
+          Napi::Number::New(env, (double)stats.inputUnderflows()));
+  obj.Set("inputOverflows",
+          Napi::Number::New(env, (double)stats.inputOverflows()));
+  obj.Set("outputUnderflows",
+          Napi::Number::New(env, (double)stats.outputUnderflows()));
+  obj.Set("outputOverflows",
+          Napi::Number::New(env, (double)stats.outputOverflows()));
+  obj.Set("primingOutputs",
+          Napi::Number::New(env, (double)stats.primingOutputs()));
+  obj.Set("xruns", Napi::Number::New(env, (double)xruns));
+
+  Napi::Array list = Napi::Array::New(env, events.size());
+
+  for (size_t i = 0; i < events.size(); i++) {
+    list[(uint32_t)i] = BackgroundProcess::XrunEventToObject(env, events[i]);
   }
 
-  this->pdWrapper_->computeAudio(compute_audio);
+  obj.Set("events", list);
 
-  return info.Env().Undefined();
+  return obj;
 }
 
-// --------------------------------------------------------------------------
-// --------------------------------------------------------------------------
-//
-// DEVICES
-//
-// --------------------------------------------------------------------------
-// --------------------------------------------------------------------------
+/**
+ * @return {Object} - load of the audio callback (processing time over buffer
+ *  duration) and processing durations in ms: { current, average, max,
+ *  callbacks, mean, p50, p99, p999, maxDuration }
+ */
+Napi::Value NodePd::GetDspLoad(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  const DspLoad &dspLoad = this->paWrapper_->dspLoad;
+  const Histogram &durations = dspLoad.durations();
+
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("current", Napi::Number::New(env, dspLoad.current()));
+  obj.Set("average", Napi::Number::New(env, dspLoad.average()));
+  obj.Set("max", Napi::Number::New(env, dspLoad.max()));
+  obj.Set("callbacks", Napi::Number::New(env, (double)durations.count()));
+  // ns to ms
+  obj.Set("mean", Napi::Number::New(env, durations.mean() / 1e6));
+  obj.Set("p50",
+          Napi::Number::New(env, (double)durations.percentile(0.5) / 1e6));
+  obj.Set("p99",
+          Napi::Number::New(env, (double)durations.percentile(0.99) / 1e6));
+  obj.Set("p999",
+          Napi::Number::New(env, (double)durations.percentile(0.999) / 1e6));
+  obj.Set("maxDuration",
+          Napi::Number::New(env, (double)durations.max() / 1e6));
+
+  return obj;
+}
 
 /**
- * clear Pd instance.
+ * Reset the dsp load statistics, applied by the next audio callback.
  */
-// NAN_METHOD(NodePd::listDevices)
-// {
-//   // std::cout << "clear" << std::endl;
-//   NodePd * nodePd = Nan::ObjectWrap::Unwrap<NodePd>(info.This());
-//   nodePd->paWrapper_->listDevices(); // clear pd
-//   // nodePd->paWrapper_->clear(); // clear portaudio
-// }
+Napi::Value NodePd::ResetDspLoad(const Napi::CallbackInfo &info) {
+  this->paWrapper_->dspLoad.requestReset();
+  return info.Env().Undefined();
+}
 
 /**
- * Get audio devices count.
+ * Enable or disable the tracing of the latency of the messages sent without
+ * scheduled time.
+ *
+ * @param {bool} [enabled=true]
  */
-Napi::Value NodePd::GetDevicesCount(const Napi::CallbackInfo &info) {
-  Napi::Env env = info.Env();
+Napi::Value NodePd::EnableLatencyTracing(const Napi::CallbackInfo &info) {
+  const bool enabled =
+      info.Length() > 0 ? info[0].As<Napi::Boolean>().Value() : true;
 
-  if (!this->initialized_) {
-    Napi::Error::New(env, "Can't getDevicesCount before init")
-        .ThrowAsJavaScriptException();
-  }
+  this->latencyTracer_.enable(enabled);
+  return info.Env().Undefined();
+}
 
-  int numDevices = this->paWrapper_->getDeviceCount();
-  return Napi::Number::New(env, numDevices);
+/**
+ * @return {Object} - latency (in ms) of each stage of the messages: { send,
+ *  inject, pd, dispatch }
+ */
+Napi::Value NodePd::GetLatencyStats(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  Napi::Object obj = Napi::Object::New(env);
+
+  obj.Set("enabled", Napi::Boolean::New(env, this->latencyTracer_.isEnabled()));
+  obj.Set("send", this->HistogramToObject_(
+                      env, this->latencyTracer_.histogram(LatencyTracer::SEND)));
+  obj.Set("inject",
+          this->HistogramToObject_(
+              env, this->latencyTracer_.histogram(LatencyTracer::INJECT)));
+  obj.Set("pd", this->HistogramToObject_(
+                    env, this->latencyTracer_.histogram(LatencyTracer::PD)));
+  obj.Set("dispatch",
+          this->HistogramToObject_(
+              env, this->latencyTracer_.histogram(LatencyTracer::DISPATCH)));
+
+  return obj;
+}
+
+Napi::Value NodePd::ResetLatencyStats(const Napi::CallbackInfo &info) {
+  this->latencyTracer_.reset();
+  return info.Env().Undefined();
 }
+
 /**
- * List audio devices.
+ * @return {Object} - metrics of the queue of messages received from pd and of
+ *  the queue of scheduled messages sent to pd: { receive, send }
  */
-Napi::Value NodePd::ListDevices(const Napi::CallbackInfo &info) {
+Napi::Value NodePd::GetQueueStats(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
+  Napi::Object obj = Napi::Object::New(env);
+  queue_stats_t send;
 
-  if (!this->initialized_) {
-    Napi::Error::New(env, "Can't listDevices before init")
-        .ThrowAsJavaScriptException();
+  if (this->initialized_) {
+    send = this->backgroundProcess_->sendQueueStats();
+  } else {
+    send.capacity = this->audioConfig_->sendQueue.capacity;
+    send.policy = this->audioConfig_->sendQueue.policy;
   }
 
-  int numDevices = this->paWrapper_->getDeviceCount();
+  obj.Set("receive", this->QueueStatsToObject_(env, this->msgQueue_->stats()));
+  obj.Set("send", this->QueueStatsToObject_(env, send));
 
-  const PaDeviceInfo *deviceInfo;
-  Napi::Array devices = Napi::Array::New(env, numDevices);
+  return obj;
+}
 
-  for (int i = 0; i < numDevices; i++) {
-    deviceInfo = this->paWrapper_->getDeviceAtIndex(i);
+/**
+ * @return {Object} - metrics of the log ring: { capacity, depth, pushed,
+ *  dropped, suppressed }
+ */
+Napi::Value NodePd::GetLogStats(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  Napi::Object obj = Napi::Object::New(env);
+  const log_stats_t stats = this->logRing_.stats();
 
-    Napi::Object device = this->PaDeviceToObject_(env, deviceInfo, i);
-    devices[i] = device;
+  obj.Set("capacity", Napi::Number::New(env, (double)stats.capacity));
+  obj.Set("depth", Napi::Number::New(env, (double)stats.depth));
+  obj.Set("pushed", Napi::Number::New(env, (double)stats.pushed));
+  obj.Set("dropped", Napi::Number::New(env, (double)stats.dropped));
+  obj.Set("suppressed", Napi::Number::New(env, (double)stats.suppressed));
+
+  return obj;
+}
+
+/**
+ * Convert queue stats to { capacity, policy, depth, highWater, pushed,
+ * dropped, coalesced }, capacity is null if the queue is unbounded.
+ */
+Napi::Object NodePd::QueueStatsToObject_(Napi::Env env,
+                                         const queue_stats_t &stats) {
+  Napi::Object obj = Napi::Object::New(env);
+  const char *policy = "dropNewest";
+
+  if (stats.policy == OverflowPolicy::DROP_OLDEST) {
+    policy = "dropOldest";
+  } else if (stats.policy == OverflowPolicy::COALESCE) {
+    policy = "coalesce";
   }
 
-  return devices;
+  obj.Set("capacity", stats.capacity > 0
+                          ? Napi::Value(Napi::Number::New(env, (double)stats.capacity))
+                          : env.Null());
+  obj.Set("policy", Napi::String::New(env, policy));
+  obj.Set("depth", Napi::Number::New(env, (double)stats.depth));
+  obj.Set("highWater", Napi::Number::New(env, (double)stats.highWater));
+  obj.Set("pushed", Napi::Number::New(env, (double)stats.pushed));
+  obj.Set("dropped", Napi::Number::New(env, (double)stats.dropped));
+  obj.Set("coalesced", Napi::Number::New(env, (double)stats.coalesced));
+
+  return obj;
 }
 
-Napi::Value NodePd::GetDefaultInputDevice(const Napi::CallbackInfo &info) {
+/**
+ * Convert a histogram of durations (in ns) to { count, mean, p50, p99, p999,
+ * max } in ms.
+ */
+Napi::Object NodePd::HistogramToObject_(Napi::Env env,
+                                        const Histogram &histogram) {
+  Napi::Object obj = Napi::Object::New(env);
+
+  obj.Set("count", Napi::Number::New(env, (double)histogram.count()));
+  obj.Set("mean", Napi::Number::New(env, histogram.mean() / 1e6));
+  obj.Set("p50",
+          Napi::Number::New(env, (double)histogram.percentile(0.5) / 1e6));
+  obj.Set("p99",
+          Napi::Number::New(env, (double)histogram.percentile(0.99) / 1e6));
+  obj.Set("p999",
+          Napi::Number::New(env, (double)histogram.percentile(0.999) / 1e6));
+  obj.Set("max", Napi::Number::New(env, (double)histogram.max() / 1e6));
+
+  return obj;
+}
+
+/**
+ * @return {Object} - { locked, future, lockedBytes, error }, `lockedBytes` is
+ *  -1 if unknown
+ */
+Napi::Value NodePd::GetMemoryLock(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
+  Napi::Object obj = Napi::Object::New(env);
+
+  obj.Set("locked", Napi::Boolean::New(env, this->memoryLock_.isLocked()));
+  obj.Set("future", Napi::Boolean::New(env, this->memoryLock_.isFuture()));
+  obj.Set("lockedBytes",
+          Napi::Number::New(env, (double)MemoryLock::lockedBytes()));
+  obj.Set("error", this->memoryLock_.error() != 0
+                       ? Napi::Value(Napi::String::New(
+                             env, strerror(this->memoryLock_.error())))
+                       : env.Null());
+
+  return obj;
+}
 
-  if (!this->initialized_) {
-    Napi::Error::New(env, "Can't getDefaultInputDevice before init")
-        .ThrowAsJavaScriptException();
+/**
+ * Parse `{ policy, priority, cpus }` into `settings`.
+ */
+void NodePd::ParseThreadSettings_(Napi::Object obj,
+                                  thread_settings_t &settings) {
+  if (obj.Has("policy")) {
+    const std::string policy = obj.Get("policy").As<Napi::String>().Utf8Value();
+
+    if (policy == "fifo") {
+      settings.policy = SCHED_FIFO;
+    } else if (policy == "rr") {
+      settings.policy = SCHED_RR;
+    } else if (policy == "other") {
+      settings.policy = SCHED_OTHER;
+    } else {
+      this->logRing_.push(LogLevel::WARN, "node-libpd",
+                          "Unknown scheduling policy: " + policy);
+    }
   }
 
-  PaDeviceIndex index = this->paWrapper_->getDefaultInputDevice();
-
-  if (index == paNoDevice) {
-    return env.Undefined();
+  if (obj.Has("priority")) {
+    settings.priority = obj.Get("priority").As<Napi::Number>().Int32Value();
   }
 
-  const PaDeviceInfo *deviceInfo = this->paWrapper_->getDeviceAtIndex(index);
-  return this->PaDeviceToObject_(env, deviceInfo, index);
-}
+  if (obj.Has("cpus")) {
+    Napi::Array cpus = obj.Get("cpus").As<Napi::Array>();
+    settings.cpuMask = 0;
 
-Napi::Value NodePd::GetDefaultOutputDevice(const Napi::CallbackInfo &info) {
-  Napi::Env env = info.Env();
+    for (uint32_t i = 0; i < cpus.Length(); i++) {
+      const int cpu = cpus.Get(i).As<Napi::Number>().Int32Value();
 
-  if (!this->initialized_) {
-    Napi::Error::New(env, "Can't getDefaultOutputDevice before init")
-        .ThrowAsJavaScriptException();
+      if (cpu >= 0 && cpu < 64) {
+        settings.cpuMask |= (uint64_t)1 << cpu;
+      }
+    }
   }
+}
 
-  PaDeviceIndex index = this->paWrapper_->getDefaultOutputDevice();
-  if (index == paNoDevice) {
-    return env.Undefined();
+void NodePd::ParseQueueConfig_(Napi::Object obj, queue_config_t &config) {
+  if (obj.Has("capacity")) {
+    const int capacity = obj.Get("capacity").As<Napi::Number>().Int32Value();
+    config.capacity = capacity > 0 ? capacity : 0;
   }
 
-  const PaDeviceInfo *deviceInfo = this->paWrapper_->getDeviceAtIndex(index);
-  return this->PaDeviceToObject_(env, deviceInfo, index);
+  if (obj.Has("policy")) {
+    const std::string policy = obj.Get("policy").As<Napi::String>().Utf8Value();
+
+    if (policy == "dropNewest") {
+      config.policy = OverflowPolicy::DROP_NEWEST;
+    } else if (policy == "dropOldest") {
+      config.policy = OverflowPolicy::DROP_OLDEST;
+    } else if (policy == "coalesce") {
+      config.policy = OverflowPolicy::COALESCE;
+    } else {
+      this->logRing_.push(LogLevel::WARN, "node-libpd",
+                          "Unknown queue overflow policy: " + policy);
+    }
+  }
 }
 
-Napi::Value NodePd::GetInputDevices(const Napi::CallbackInfo &info) {
-  Napi::Env env = info.Env();
+void NodePd::ParseLogConfig_(Napi::Object obj) {
+  size_t capacity = LogRing::DEFAULT_CAPACITY;
+  double maxRate = LogRing::DEFAULT_MAX_RATE;
+  LogLevel level = LogLevel::INFO;
+  LogLevel consoleLevel = LogLevel::WARN;
+  bool console = true;
 
-  if (!this->initialized_) {
-    Napi::Error::New(env, "Can't getInputDevices before init")
-        .ThrowAsJavaScriptException();
+  if (obj.Has("capacity")) {
+    const int value = obj.Get("capacity").As<Napi::Number>().Int32Value();
+    capacity = value > 0 ? value : 1;
   }
 
-  int numDevices = this->paWrapper_->getDeviceCount();
+  if (obj.Has("maxRate")) {
+    maxRate = obj.Get("maxRate").As<Napi::Number>().DoubleValue();
+  }
 
-  const PaDeviceInfo *deviceInfo;
-  Napi::Array devices = Napi::Array::New(env);
+  if (obj.Has("level")) {
+    const std::string name = obj.Get("level").As<Napi::String>().Utf8Value();
 
-  int next = 0;
-  for (int i = 0; i < numDevices; i++) {
-    deviceInfo = this->paWrapper_->getDeviceAtIndex(i);
+    if (!LogRing::parseLevel(name, level)) {
+      this->logRing_.push(LogLevel::WARN, "node-libpd",
+                          "Unknown log level: " + name);
+    }
+  }
 
-    if (deviceInfo->maxInputChannels > 0) {
-      Napi::Object device = this->PaDeviceToObject_(env, deviceInfo, i);
-      devices[next] = device;
-      next++;
+  if (obj.Has("console")) {
+    Napi::Value value = obj.Get("console");
+
+    if (value.IsString()) {
+      const std::string name = value.As<Napi::String>().Utf8Value();
+
+      if (!LogRing::parseLevel(name, consoleLevel)) {
+        this->logRing_.push(LogLevel::WARN, "node-libpd",
+                            "Unknown log level: " + name);
+      }
+    } else {
+      console = value.ToBoolean().Value();
     }
   }
 
-  return devices;
+  this->logRing_.configure(capacity, maxRate, level, consoleLevel, console);
 }
 
-Napi::Value NodePd::GetOutputDevices(const Napi::CallbackInfo &info) {
-  Napi::Env env = info.Env();
-
-  if (!this->initialized_) {
-    Napi::Error::New(env, "Can't getOutputDevices before init")
-        .ThrowAsJavaScriptException();
+/**
+ * Convert a thread report to `{ policy, priority, cpus, priorityError,
+ * affinityError }`, null if the settings are not applied yet.
+ */
+Napi::Value NodePd::ThreadReportToObject_(Napi::Env env,
+                                          const thread_report_t &report) {
+  if (!report.applied) {
+    return env.Null();
   }
 
-  int numDevices = this->paWrapper_->getDeviceCount();
+  Napi::Object obj = Napi::Object::New(env);
 
-  const PaDeviceInfo *deviceInfo;
-  Napi::Array devices = Napi::Array::New(env);
+  if (report.policy == SCHED_FIFO) {
+    obj.Set("policy", Napi::String::New(env, "fifo"));
+  } else if (report.policy == SCHED_RR) {
+    obj.Set("policy", Napi::String::New(env, "rr"));
+  } else if (report.policy == SCHED_OTHER) {
+    obj.Set("policy", Napi::String::New(env, "other"));
+  } else {
+    obj.Set("policy", Napi::Number::New(env, report.policy));
+  }
+
+  obj.Set("priority", Napi::Number::New(env, report.priority));
 
+  Napi::Array cpus = Napi::Array::New(env);
   int next = 0;
-  for (int i = 0; i < numDevices; i++) {
-    deviceInfo = this->paWrapper_->getDeviceAtIndex(i);
 
-    if (deviceInfo->maxOutputChannels > 0) {
-      Napi::Object device = this->PaDeviceToObject_(env, deviceInfo, i);
-      devices[next] = device;
-      next++;
+  for (int i = 0; i < 64; i++) {
+    if (report.cpuMask & ((uint64_t)1 << i)) {
+      cpus[next++] = Napi::Number::New(env, i);
     }
   }
 
-  return devices;
+  obj.Set("cpus", cpus);
+  obj.Set("priorityError",
+          report.priorityError != 0
+              ? Napi::Value(Napi::String::New(env, strerror(report.priorityError)))
+              : env.Null());
+  obj.Set("affinityError",
+          report.affinityError != 0
+              ? Napi::Value(Napi::String::New(env, strerror(report.affinityError)))
+              : env.Null());
+
+  return obj;
 }
 
-Napi::Value NodePd::GetDeviceAtIndex(const Napi::CallbackInfo &info) {
+/**
+ * @return {Object} - scheduling applied to the audio callback and message
+ *  threads: { dsp, message }
+ */
+Napi::Value NodePd::GetThreadSettings(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
+  Napi::Object obj = Napi::Object::New(env);
 
-  if (!this->initialized_) {
-    Napi::Error::New(env, "Can't getDeviceAtIndex before init")
-        .ThrowAsJavaScriptException();
+  obj.Set("dsp", this->ThreadReportToObject_(env, this->paWrapper_->dspThread));
+  obj.Set("message", this->ThreadReportToObject_(env, this->messageThread_));
+
+  return obj;
+}
+
+/**
+ * Apply the given config to `audioConfig_`, returns the init timeout in ms.
+ */
+int NodePd::ConfigureAudio_(Napi::Object obj) {
+  int numInputChannels = this->audioConfig_->numInputChannels;
+  int numOutputChannels = this->audioConfig_->numOutputChannels;
+  int sampleRate = this->audioConfig_->sampleRate;
+  int ticks = this->audioConfig_->ticks;
+  int timeout = DEFAULT_INIT_TIMEOUT;
+
+  if (obj.Has("numInputChannels")) {
+    numInputChannels =
+        obj.Get("numInputChannels").As<Napi::Number>().Int32Value();
   }
 
-  if (info.Length() == 0 || !info[0].IsNumber()) {
-    Napi::Error::New(env, "Invalid Arguments: pd.getDeviceAtIndex(index)")
-        .ThrowAsJavaScriptException();
+  if (obj.Has("numOutputChannels")) {
+    numOutputChannels =
+        obj.Get("numOutputChannels").As<Napi::Number>().Int32Value();
   }
 
-  int index = info[0].As<Napi::Number>().Int32Value();
-  const PaDeviceInfo *deviceInfo = this->paWrapper_->getDeviceAtIndex(index);
+  if (obj.Has("sampleRate")) {
+    sampleRate = obj.Get("sampleRate").As<Napi::Number>().Int32Value();
+  }
 
-  if (deviceInfo != NULL) {
-    return this->PaDeviceToObject_(env, deviceInfo, index);
+  if (obj.Has("ticks")) {
+    ticks = obj.Get("ticks").As<Napi::Number>().Int32Value();
   }
-  
-  return env.Undefined();
-}
 
-/**
- * Convert PaDeviceInfo to object.
- */
-Napi::Object NodePd::PaDeviceToObject_(Napi::Env env, PaDeviceInfo const * deviceInfo, int index) {
-  Napi::Object device = Napi::Object::New(env);
+  if (obj.Has("timeout")) {
+    timeout = obj.Get("timeout").As<Napi::Number>().Int32Value();
+  }
 
-  device.Set("structVersion", Napi::Number::New(env, deviceInfo->structVersion));
-  device.Set("index", Napi::Number::New(env, index));
-  device.Set("name", Napi::String::New(env, deviceInfo->name));
-  device.Set("maxInputChannels",
-              Napi::Number::New(env, deviceInfo->maxInputChannels));
-  device.Set("maxOutputChannels",
-              Napi::Number::New(env, deviceInfo->maxOutputChannels));
-  device.Set(
-      "defaultLowInputLatency",
-      Napi::Number::New(env, (double)deviceInfo->defaultLowInputLatency));
-  device.Set(
-      "defaultLowOutputLatency",
-      Napi::Number::New(env, (double)deviceInfo->defaultLowOutputLatency));
-  device.Set(
-      "defaultHighInputLatency",
-      Napi::Number::New(env, (double)deviceInfo->defaultHighInputLatency));
-  device.Set(
-      "defaultHighOutputLatency",
-      Napi::Number::New(env, (double)deviceInfo->defaultHighOutputLatency));
-  device.Set("defaultSampleRate",
-              Napi::Number::New(env, (double)deviceInfo->defaultSampleRate));
+  if (obj.Has("processRaw")) {
+    this->audioConfig_->processRaw =
+        obj.Get("processRaw").As<Napi::Boolean>().Value();
+  }
 
-  return device;
-}
+  if (obj.Has("lockMemory")) {
+    Napi::Value lockMemory = obj.Get("lockMemory");
 
-// --------------------------------------------------------------------------
-// --------------------------------------------------------------------------
+    if (lockMemory.IsString()) {
+      this->audioConfig_->lockMemory =
+          lockMemory.As<Napi::String>().Utf8Value() == "future" ? 2 : 1;
+    } else {
+      this->audioConfig_->lockMemory =
+          lockMemory.As<Napi::Boolean>().Value() ? 1 : 0;
+    }
+  }
+
+  if (obj.Has("xrunEvents")) {
+    this->audioConfig_->xrunEvents =
+        obj.Get("xrunEvents").As<Napi::Boolean>().Value();
+  }
+
+  if (obj.Has("backend")) {
+    const std::string backend =
+        obj.Get("backend").As<Napi::String>().Utf8Value();
+    this->audioConfig_->backend =
+        backend == "offline" ? BACKEND_OFFLINE : BACKEND_PORTAUDIO;
+  }
+
+  if (obj.Has("realtime")) {
+    this->audioConfig_->realtime =
+        obj.Get("realtime").As<Napi::Boolean>().Value();
+  }
+
+  if (obj.Has("receiveQueue")) {
+    this->ParseQueueConfig_(obj.Get("receiveQueue").As<Napi::Object>(),
+                            this->audioConfig_->receiveQueue);
+  }
+
+  if (obj.Has("sendQueue")) {
+    this->ParseQueueConfig_(obj.Get("sendQueue").As<Napi::Object>(),
+                            this->audioConfig_->sendQueue);
+  }
+
+  this->msgQueue_->setCapacity(this->audioConfig_->receiveQueue.capacity,
+                               this->audioConfig_->receiveQueue.policy);
+
+  if (obj.Has("log")) {
+    this->ParseLogConfig_(obj.Get("log").As<Napi::Object>());
+  }
+
+  if (obj.Has("threads")) {
+    Napi::Object threads = obj.Get("threads").As<Napi::Object>();
+
+    if (threads.Has("dsp")) {
+      this->ParseThreadSettings_(threads.Get("dsp").As<Napi::Object>(),
+                                 this->audioConfig_->dspThread);
+    }
+
+    if (threads.Has("message")) {
+      this->ParseThreadSettings_(threads.Get("message").As<Napi::Object>(),
+                                 this->audioConfig_->messageThread);
+    }
+  }
+
+  const int blockSize = this->pdWrapper_->blockSize();
+  // 0 lets portaudio choose (possibly varying) buffer sizes
+  int framesPerBuffer = -1;
+
+  if (obj.Has("framesPerBuffer")) {
+    framesPerBuffer =
+        obj.Get("framesPerBuffer").As<Napi::Number>().Int32Value();
+
+    // whole pd blocks are processed in place, no need to adapt
+    if (framesPerBuffer > 0 && framesPerBuffer % blockSize == 0) {
+      ticks = framesPerBuffer / blockSize;
+    }
+  }
+
+  if (framesPerBuffer < 0) {
+    framesPerBuffer = blockSize * ticks;
+  }
+
+  if (obj.Has("inputDevice")) {
+    this->audioConfig_->inputDevice =
+        obj.Get("inputDevice").As<Napi::Number>().Int32Value();
+  }
+
+  if (obj.Has("outputDevice")) {
+    this->audioConfig_->outputDevice =
+        obj.Get("outputDevice").As<Napi::Number>().Int32Value();
+  }
+
+  if (obj.Has("inputLatency")) {
+    this->audioConfig_->inputLatency =
+        obj.Get("inputLatency").As<Napi::Number>().DoubleValue();
+  }
+
+  if (obj.Has("outputLatency")) {
+    this->audioConfig_->outputLatency =
+        obj.Get("outputLatency").As<Napi::Number>().DoubleValue();
+  }
+
+  if (obj.Has("hostApi")) {
+    Napi::Value hostApi = obj.Get("hostApi");
+
+    // unknown names are kept as an invalid index so that init fails
+    if (hostApi.IsString()) {
+      const int index =
+          this->paWrapper_->findHostApi(hostApi.As<Napi::String>().Utf8Value());
+      this->audioConfig_->hostApi = index == -1 ? -2 : index;
+    } else {
+      this->audioConfig_->hostApi = hostApi.As<Napi::Number>().Int32Value();
+    }
+  }
+
+  if (obj.Has("streamFlags")) {
+    Napi::Array flags = obj.Get("streamFlags").As<Napi::Array>();
+    PaStreamFlags streamFlags = paNoFlag;
+
+    for (uint32_t i = 0; i < flags.Length(); i++) {
+      const std::string flag = flags.Get(i).As<Napi::String>().Utf8Value();
+
+      if (flag == "clipOff") {
+        streamFlags |= paClipOff;
+      } else if (flag == "ditherOff") {
+        streamFlags |= paDitherOff;
+      } else if (flag == "neverDropInput") {
+        streamFlags |= paNeverDropInput;
+      } else if (flag == "primeOutputBuffersUsingStreamCallback") {
+        streamFlags |= paPrimeOutputBuffersUsingStreamCallback;
+      } else {
+        this->logRing_.push(LogLevel::WARN, "node-libpd",
+                            "Unknown stream flag: " + flag);
+      }
+    }
+
+    this->audioConfig_->streamFlags = streamFlags;
+  }
+
+  this->audioConfig_->numInputChannels = numInputChannels;
+  this->audioConfig_->numOutputChannels = numOutputChannels;
+  this->audioConfig_->sampleRate = sampleRate;
+  this->audioConfig_->ticks = ticks; // number of blocks processed by pd in
+  this->audioConfig_->blockSize =
+      blockSize; // size of the pd blocks (e.g. 64)
+  this->audioConfig_->framesPerBuffer = framesPerBuffer;
+  this->audioConfig_->bufferDuration =
+      (double)(framesPerBuffer > 0 ? framesPerBuffer : blockSize * ticks) /
+      (double)sampleRate;
+
+  this->tickScheduler_->setBudget(TICK_TASKS_BUDGET * (double)blockSize /
+                                  (double)sampleRate);
+
+  return timeout;
+}
+
+/**
+ * Init libpd and open the audio stream, does not touch js values so that it
+ * can be called from a worker thread.
+ */
+bool NodePd::StartAudio_(bool computeAudio, std::string &error) {
+  // pd can't be initialized twice, e.g. if a previous init timed out
+  if (!this->pdWrapper_->isInited()) {
+    auto start = std::chrono::steady_clock::now();
+    const bool pdInitialized =
+        this->pdWrapper_->init(this->audioConfig_, computeAudio);
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    this->pdInitDuration_ = elapsed.count();
+
+    if (!pdInitialized) {
+      error = "Failed to initialize pd";
+      return false;
+    }
+
+    this->pdWrapper_->setReceiver(this->pdReceiver_);
+  } else {
+    this->pdWrapper_->computeAudio(computeAudio);
+  }
+
+  const bool paInitialized = this->paWrapper_->init(
+      this->audioConfig_, this->pdWrapper_->getLibPdInstance(),
+      this->tickScheduler_);
+
+  if (!paInitialized) {
+    error = "Failed to start the audio stream";
+    return false;
+  }
+
+  // lock once pd and portaudio buffers are allocated, so that they are
+  // faulted in, init still succeeds if locking is not permitted
+  if (this->audioConfig_->lockMemory &&
+      !this->memoryLock_.lock(this->audioConfig_->lockMemory == 2)) {
+    this->logRing_.push(LogLevel::WARN, "node-libpd",
+                        std::string("Failed to lock memory: ") +
+                            strerror(this->memoryLock_.error()));
+  }
+
+  return true;
+}
+
+void NodePd::StopAudio_() {
+  this->paWrapper_->stopStream();
+  this->paWrapper_->closeStream();
+}
+
+void NodePd::StartBackgroundProcess_(Napi::Env env) {
+  this->messageThread_.applied = false;
+  this->backgroundProcess_ =
+      new BackgroundProcess(env, this->audioConfig_, this->msgQueue_,
+                            this->paWrapper_, this->pdWrapper_,
+                            this->tickScheduler_, &this->messageThread_,
+                            &this->latencyTracer_, &this->channelFilters_,
+                            &this->subscriptions_, &this->logRing_,
+                            &this->taskCompletions_,
+                            [this](Napi::Env env) {
+                              this->ValidateArrayViews_(env);
+                            });
+
+  this->backgroundProcess_->Queue();
+}
+
+Napi::Object NodePd::InitTimings_(Napi::Env env) {
+  Napi::Object timings = Napi::Object::New(env);
+
+  timings.Set("pdInit", this->pdInitDuration_);
+  timings.Set("paInitialize", this->paWrapper_->paInitializeDuration);
+  timings.Set("streamOpen", this->paWrapper_->streamOpenDuration);
+  timings.Set("firstCallback", this->paWrapper_->firstCallbackDuration.load());
+
+  return timings;
+}
+
+/**
+ * clear Pd instance.
+ * need to stop the background process cleanly
+ */
+Napi::Value NodePd::Destroy(const Napi::CallbackInfo &info) {
+#ifdef DEBUG
+  std::cout << "[node-libpd] destroy node-libpd instance" << std::endl;
+#endif
+
+  // pending tasks reference js buffers, stop the audio thread before
+  // releasing them
+  this->StopAudio_();
+  this->taskCompletions_.cancel(info.Env(), "pd instance destroyed");
+
+  // views over pd memory must not outlive the pd instance
+  for (auto &entry : this->arrayViews_) {
+    this->InvalidateArrayView_(info.Env(), entry.second);
+  }
+
+  // not sure c++ guys would like that...
+  delete this;
+
+  return info.Env().Undefined();
+}
+
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+//
+// DYNAMIC CONFIGURATION
+//
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+
+/**
+ * Set PD to compute audio or not.
+ */
+Napi::Value NodePd::ComputeAudio(const Napi::CallbackInfo &info) {
+  bool compute_audio = true;
+
+  if (info.Length() >= 1 && info[0].IsBoolean()) {
+    compute_audio = info[0].As<Napi::Boolean>().Value();
+  }
+
+  this->pdWrapper_->computeAudio(compute_audio);
+
+  return info.Env().Undefined();
+}
+
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+//
+// DEVICES
+//
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+
+/**
+ * clear Pd instance.
+ */
+// NAN_METHOD(NodePd::listDevices)
+// {
+//   // std::cout << "clear" << std::endl;
+//   NodePd * nodePd = Nan::ObjectWrap::Unwrap<NodePd>(info.This());
+//   nodePd->paWrapper_->listDevices(); // clear pd
+//   // nodePd->paWrapper_->clear(); // clear portaudio
+// }
+
+/**
+ * Get audio devices count.
+ */
+Napi::Value NodePd::GetDevicesCount(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  int numDevices = this->paWrapper_->getDeviceCount();
+  return Napi::Number::New(env, numDevices);
+}
+/**
+ * List audio devices.
+ */
+Napi::Value NodePd::ListDevices(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  int numDevices = this->paWrapper_->getDeviceCount();
+
+  const PaDeviceInfo *deviceInfo;
+  Napi::Array devices = Napi::Array::New(env, numDevices);
+
+  for (int i = 0; i < numDevices; i++) {
+    deviceInfo = this->paWrapper_->getDeviceAtIndex(i);
+
+    Napi::Object device = this->PaDeviceToObject_(env, deviceInfo, i);
+    devices[i] = device;
+  }
+
+  return devices;
+}
+
+Napi::Value NodePd::GetDefaultInputDevice(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  PaDeviceIndex index = this->paWrapper_->getDefaultInputDevice();
+
+  if (index == paNoDevice) {
+    return env.Undefined();
+  }
+
+  const PaDeviceInfo *deviceInfo = this->paWrapper_->getDeviceAtIndex(index);
+
+  if (deviceInfo == NULL) {
+    return env.Undefined();
+  }
+
+  return this->PaDeviceToObject_(env, deviceInfo, index);
+}
+
+Napi::Value NodePd::GetDefaultOutputDevice(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  PaDeviceIndex index = this->paWrapper_->getDefaultOutputDevice();
+  if (index == paNoDevice) {
+    return env.Undefined();
+  }
+
+  const PaDeviceInfo *deviceInfo = this->paWrapper_->getDeviceAtIndex(index);
+
+  if (deviceInfo == NULL) {
+    return env.Undefined();
+  }
+
+  return this->PaDeviceToObject_(env, deviceInfo, index);
+}
+
+Napi::Value NodePd::GetInputDevices(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  int numDevices = this->paWrapper_->getDeviceCount();
+
+  const PaDeviceInfo *deviceInfo;
+  Napi::Array devices = Napi::Array::New(env);
+
+  int next = 0;
+  for (int i = 0; i < numDevices; i++) {
+    deviceInfo = this->paWrapper_->getDeviceAtIndex(i);
+
+    if (deviceInfo->maxInputChannels > 0) {
+      Napi::Object device = this->PaDeviceToObject_(env, deviceInfo, i);
+      devices[next] = device;
+      next++;
+    }
+  }
+
+  return devices;
+}
+
+Napi::Value NodePd::GetOutputDevices(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  int numDevices = this->paWrapper_->getDeviceCount();
+
+  const PaDeviceInfo *deviceInfo;
+  Napi::Array devices = Napi::Array::New(env);
+
+  int next = 0;
+  for (int i = 0; i < numDevices; i++) {
+    deviceInfo = this->paWrapper_->getDeviceAtIndex(i);
+
+    if (deviceInfo->maxOutputChannels > 0) {
+      Napi::Object device = this->PaDeviceToObject_(env, deviceInfo, i);
+      devices[next] = device;
+      next++;
+    }
+  }
+
+  return devices;
+}
+
+Napi::Value NodePd::GetDeviceAtIndex(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() == 0 || !info[0].IsNumber()) {
+    Napi::Error::New(env, "Invalid Arguments: pd.getDeviceAtIndex(index)")
+        .ThrowAsJavaScriptException();
+  }
+
+  int index = info[0].As<Napi::Number>().Int32Value();
+  const PaDeviceInfo *deviceInfo = this->paWrapper_->getDeviceAtIndex(index);
+
+  if (deviceInfo != NULL) {
+    return this->PaDeviceToObject_(env, deviceInfo, index);
+  }
+  
+  return env.Undefined();
+}
+
+/**
+ * @return {Object|undefined} - latencies (in seconds) and sample rate
+ *  achieved by the audio stream: { inputLatency, outputLatency, totalLatency,
+ *  sampleRate, inputDevice, outputDevice, hostApi, framesPerBuffer,
+ *  blockAdapter }
+ */
+Napi::Value NodePd::GetStreamInfo(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  const PaStreamInfo *streamInfo = this->paWrapper_->getStreamInfo();
+
+  if (streamInfo == NULL) {
+    return env.Undefined();
+  }
+
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("inputLatency", Napi::Number::New(env, streamInfo->inputLatency));
+  obj.Set("outputLatency", Napi::Number::New(env, streamInfo->outputLatency));
+  obj.Set("totalLatency",
+          Napi::Number::New(env, streamInfo->inputLatency +
+                                     streamInfo->outputLatency));
+  obj.Set("sampleRate", Napi::Number::New(env, streamInfo->sampleRate));
+  obj.Set("inputDevice", Napi::Number::New(env, this->paWrapper_->inputDevice));
+  obj.Set("outputDevice",
+          Napi::Number::New(env, this->paWrapper_->outputDevice));
+  obj.Set("hostApi", Napi::Number::New(env, this->paWrapper_->hostApi));
+  obj.Set("framesPerBuffer",
+          Napi::Number::New(env, this->audioConfig_->framesPerBuffer));
+  obj.Set("blockAdapter",
+          Napi::Boolean::New(env, this->paWrapper_->usesBlockAdapter()));
+
+  return obj;
+}
+
+/**
+ * Initialize portaudio again to discover devices plugged since the device
+ * list was cached, fails if the audio stream is running.
+ */
+Napi::Value NodePd::RefreshDevices(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  return Napi::Boolean::New(env, this->paWrapper_->refreshDevices());
+}
+
+/**
+ * Convert PaDeviceInfo to object.
+ */
+Napi::Object NodePd::PaDeviceToObject_(Napi::Env env, PaDeviceInfo const * deviceInfo, int index) {
+  Napi::Object device = Napi::Object::New(env);
+
+  device.Set("structVersion", Napi::Number::New(env, deviceInfo->structVersion));
+  device.Set("index", Napi::Number::New(env, index));
+  device.Set("name", Napi::String::New(env, deviceInfo->name));
+  device.Set("maxInputChannels",
+              Napi::Number::New(env, deviceInfo->maxInputChannels));
+  device.Set("maxOutputChannels",
+              Napi::Number::New(env, deviceInfo->maxOutputChannels));
+  device.Set(
+      "defaultLowInputLatency",
+      Napi::Number::New(env, (double)deviceInfo->defaultLowInputLatency));
+  device.Set(
+      "defaultLowOutputLatency",
+      Napi::Number::New(env, (double)deviceInfo->defaultLowOutputLatency));
+  device.Set(
+      "defaultHighInputLatency",
+      Napi::Number::New(env, (double)deviceInfo->defaultHighInputLatency));
+  device.Set(
+      "defaultHighOutputLatency",
+      Napi::Number::New(env, (double)deviceInfo->defaultHighOutputLatency));
+  device.Set("defaultSampleRate",
+              Napi::Number::New(env, (double)deviceInfo->defaultSampleRate));
+
+  return device;
+}
+
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+//
+// PATCH
+//
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+
+/**
+ * open a pd patch
+ *
+ * @param {String} filename - filename of the patch (i.e. test.pd)
+ * @param {String} path - full path to the directory containing the patch
+ *
+ * @return {Object} - object containing informations about the patch
+ */
+Napi::Value NodePd::OpenPatch(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!this->initialized_) {
+    Napi::Error::New(env, "Can't openPatch before init")
+        .ThrowAsJavaScriptException();
+  }
+
+  if (!info[0].IsString() || !info[1].IsString()) {
+    Napi::Error::New(env, "Invalid Arguments: pd.openPatch(filename, path)")
+        .ThrowAsJavaScriptException();
+  } else {
+    std::string filename = info[0].As<Napi::String>().Utf8Value();
+    std::string path = info[1].As<Napi::String>().Utf8Value();
+
+    patch_infos_t patchInfos = this->pdWrapper_->openPatch(filename, path);
+    this->ValidateArrayViews_(env);
+    this->memoryLock_.relock();
+
+    // create a Plain Old Javascript Object to represent the patch
+    Napi::Object patch = Napi::Object::New(env);
+
+    patch.Set("isValid", patchInfos.isValid);
+    patch.Set("filename", patchInfos.filename);
+    patch.Set("path", patchInfos.path);
+    patch.Set("$0", patchInfos.dollarZero);
+
+    return patch;
+  }
+
+  return env.Undefined();
+}
+
+/**
+ * Close the given `NodePdPath` instance
+ * @param {Object} patch - A patch object as returned by open patch
+ */
+Napi::Value NodePd::ClosePatch(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!this->initialized_) {
+    Napi::Error::New(env, "Can't closePatch before init")
+        .ThrowAsJavaScriptException();
+  }
+
+  if (!info[0].IsObject()) {
+    Napi::Error::New(env, "Invalid Arguments: pd.closePatch(patch)")
+        .ThrowAsJavaScriptException();
+  } else {
+    Napi::Object patch = info[0].As<Napi::Object>();
+
+    if (!patch.Has("$0") || !patch.Has("filename") || !patch.Has("path") ||
+        !patch.Has("isValid")) {
+      Napi::Error::New(env, "Invalid Arguments: pd.closePatch(patch)")
+          .ThrowAsJavaScriptException();
+    }
+
+    int dollarZero = patch.Get("$0").As<Napi::Number>().Int32Value();
+    patch_infos_t patchInfos = this->pdWrapper_->closePatch(dollarZero);
+    // arrays owned by the patch are freed now
+    this->ValidateArrayViews_(env);
+
+    patch.Set("$0", patchInfos.dollarZero);
+    patch.Set("isValid", patchInfos.isValid);
+
+    return patch;
+  }
+
+  return env.Undefined();
+}
+
+/**
+ * Open a patch at a tick boundary, from the audio thread, so that the event
+ * loop is not blocked while the patch is loaded.
+ *
+ * @param {String} filename
+ * @param {String} path
+ * @return {Promise<Object>} - resolved with the patch object
+ */
+Napi::Value NodePd::OpenPatchAsync(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!this->initialized_) {
+    Napi::Error::New(env, "Can't openPatchAsync before init")
+        .ThrowAsJavaScriptException();
+  }
+
+  if (!info[0].IsString() || !info[1].IsString()) {
+    Napi::Error::New(env, "Invalid Arguments: pd.openPatchAsync(filename, path)")
+        .ThrowAsJavaScriptException();
+  }
+
+  std::string filename = info[0].As<Napi::String>().Utf8Value();
+  std::string path = info[1].As<Napi::String>().Utf8Value();
+
+  auto task = std::make_shared<OpenPatchTask>(this->pdWrapper_, filename, path);
+  OpenPatchWorker *worker = new OpenPatchWorker(
+      env, this->tickScheduler_, this->paWrapper_, &this->taskCompletions_,
+      this->pdWrapper_, task, [this](Napi::Env env) {
+        this->ValidateArrayViews_(env);
+        this->memoryLock_.relock();
+      });
+
+  Napi::Promise promise = worker->GetPromise();
+  worker->Queue();
+
+  return promise;
+}
+
+/**
+ * Close a patch at a tick boundary, from the audio thread.
+ *
+ * @param {Object} patch
+ * @return {Promise<Object>} - resolved with the given patch object
+ */
+Napi::Value NodePd::ClosePatchAsync(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!this->initialized_) {
+    Napi::Error::New(env, "Can't closePatchAsync before init")
+        .ThrowAsJavaScriptException();
+  }
+
+  if (!info[0].IsObject()) {
+    Napi::Error::New(env, "Invalid Arguments: pd.closePatchAsync(patch)")
+        .ThrowAsJavaScriptException();
+  }
+
+  Napi::Object patch = info[0].As<Napi::Object>();
+
+  if (!patch.Has("$0") || !patch.Has("filename") || !patch.Has("path") ||
+      !patch.Has("isValid")) {
+    Napi::Error::New(env, "Invalid Arguments: pd.closePatchAsync(patch)")
+        .ThrowAsJavaScriptException();
+  }
+
+  int dollarZero = patch.Get("$0").As<Napi::Number>().Int32Value();
+  // unregister now, so that the patch can't be closed twice
+  pd::Patch pdPatch = this->pdWrapper_->unregisterPatch(dollarZero);
+
+  if (!pdPatch.isValid()) {
+    // invalid or already closed
+    Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+    patch.Set("$0", 0);
+    patch.Set("isValid", false);
+    deferred.Resolve(patch);
+    return deferred.Promise();
+  }
+
+  auto task = std::make_shared<ClosePatchTask>(this->pdWrapper_, pdPatch);
+  ClosePatchWorker *worker = new ClosePatchWorker(
+      env, this->tickScheduler_, this->paWrapper_, &this->taskCompletions_,
+      task, patch,
+      [this](Napi::Env env) { this->ValidateArrayViews_(env); });
+
+  Napi::Promise promise = worker->GetPromise();
+  worker->Queue();
+
+  return promise;
+}
+
+// number of instances of a pool: an integer, not NaN nor negative
+static bool isPoolSize(const Napi::Value &value) {
+  if (!value.IsNumber()) {
+    return false;
+  }
+
+  const double size = value.As<Napi::Number>().DoubleValue();
+
+  return size >= 0 && size <= INT_MAX && std::floor(size) == size;
+}
+
+/**
+ * Open `size` instances of a patch up front.
+ *
+ * @param {String} filename
+ * @param {String} path
+ * @param {Number} size
+ * @return {Object|null} - { id, patches } or null if the patch can't be opened
+ */
+Napi::Value NodePd::CreatePatchPool(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!this->initialized_) {
+    Napi::Error::New(env, "Can't createPatchPool before init")
+        .ThrowAsJavaScriptException();
+  }
+
+  if (!info[0].IsString() || !info[1].IsString() ||
+      !isPoolSize(info[2])) {
+    Napi::Error::New(env, "Invalid Arguments: pd.createPatchPool(pathname, "
+                          "size, { grow=0 })")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  std::string filename = info[0].As<Napi::String>().Utf8Value();
+  std::string path = info[1].As<Napi::String>().Utf8Value();
+  int size = info[2].As<Napi::Number>().Int32Value();
+
+  std::vector<patch_infos_t> instances;
+  const int poolId =
+      this->pdWrapper_->createPatchPool(filename, path, size, instances);
+  this->ValidateArrayViews_(env);
+  this->memoryLock_.relock();
+
+  if (poolId == -1) {
+    return env.Null();
+  }
+
+  Napi::Array patches = Napi::Array::New(env, instances.size());
+
+  for (uint32_t i = 0; i < instances.size(); i++) {
+    Napi::Object patch = Napi::Object::New(env);
+
+    patch.Set("isValid", instances[i].isValid);
+    patch.Set("filename", instances[i].filename);
+    patch.Set("path", instances[i].path);
+    patch.Set("$0", instances[i].dollarZero);
+
+    patches.Set(i, patch);
+  }
+
+  Napi::Object pool = Napi::Object::New(env);
+  pool.Set("id", poolId);
+  pool.Set("patches", patches);
+
+  return pool;
+}
+
+/**
+ * Open new instances of a pooled patch in a worker thread.
+ *
+ * @param {Number} id - id of the pool
+ * @param {Number} num - number of instances to open
+ * @return {Promise<Array>} - resolved with the patch objects of the instances
+ *  added to the pool
+ */
+Napi::Value NodePd::GrowPatchPool(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  std::string filename;
+  std::string path;
+
+  if (!info[0].IsNumber() || !isPoolSize(info[1]) ||
+      !this->pdWrapper_->getPatchPoolSource(
+          info[0].As<Napi::Number>().Int32Value(), filename, path)) {
+    Napi::Error::New(env, "Invalid Arguments: pool.grow(num)")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  const int poolId = info[0].As<Napi::Number>().Int32Value();
+  const int num = info[1].As<Napi::Number>().Int32Value();
+
+  GrowPatchPoolWorker *worker = new GrowPatchPoolWorker(
+      env, this->pdWrapper_, poolId, filename, path, num,
+      [this](Napi::Env env) {
+        this->ValidateArrayViews_(env);
+        this->memoryLock_.relock();
+      });
+
+  Napi::Promise promise = worker->GetPromise();
+  worker->Queue();
+
+  return promise;
+}
+
+Napi::Value NodePd::AcquirePatch(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  const int poolId = info[0].As<Napi::Number>().Int32Value();
+
+  return Napi::Number::New(env, this->pdWrapper_->acquirePatch(poolId));
+}
+
+Napi::Value NodePd::ReleasePatch(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  const int poolId = info[0].As<Napi::Number>().Int32Value();
+  const int dollarZero = info[1].As<Napi::Number>().Int32Value();
+
+  return Napi::Boolean::New(
+      env, this->pdWrapper_->releasePatch(poolId, dollarZero));
+}
+
+Napi::Value NodePd::PatchPoolAvailable(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  const int poolId = info[0].As<Napi::Number>().Int32Value();
+
+  return Napi::Number::New(env, this->pdWrapper_->patchPoolAvailable(poolId));
+}
+
+Napi::Value NodePd::DestroyPatchPool(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  const int poolId = info[0].As<Napi::Number>().Int32Value();
+
+  const bool result = this->pdWrapper_->destroyPatchPool(poolId);
+  this->ValidateArrayViews_(env);
+
+  return Napi::Boolean::New(env, result);
+}
+
+Napi::Value NodePd::AddToSearchPath(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsString()) {
+    Napi::Error::New(env, "Invalid Arguments: pd.addToSearchPath(pathname)")
+        .ThrowAsJavaScriptException();
+  }
+
+  std::string pathname = info[0].As<Napi::String>().Utf8Value();
+  this->pdWrapper_->addToSearchPath(pathname);
+
+  return env.Undefined();
+}
+
+Napi::Value NodePd::ClearSearchPath(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  this->pdWrapper_->clearSearchPath();
+
+  return env.Undefined();
+}
+
+/**
+ * Keep the content of the opened patch files in memory, so that next
+ * instances of the same file are opened without reading and parsing it.
+ *
+ * @param {Boolean} [enabled=true]
+ */
+Napi::Value NodePd::EnablePatchCache(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  bool enabled = true;
+
+  if (info[0].IsBoolean()) {
+    enabled = info[0].As<Napi::Boolean>().Value();
+  }
+
+  this->pdWrapper_->enablePatchCache(enabled);
+
+  return env.Undefined();
+}
+
+Napi::Value NodePd::ClearPatchCache(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  this->pdWrapper_->clearPatchCache();
+
+  return env.Undefined();
+}
+
+/**
+ * @return {Object} - { enabled, entries, hits, misses, invalidations }
+ */
+Napi::Value NodePd::GetPatchCacheStats(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  patch_cache_stats_t stats = this->pdWrapper_->getPatchCacheStats();
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("enabled", this->pdWrapper_->isPatchCacheEnabled());
+  result.Set("entries", stats.entries);
+  result.Set("hits", stats.hits);
+  result.Set("misses", stats.misses);
+  result.Set("invalidations", stats.invalidations);
+
+  return result;
+}
+
+Napi::Value NodePd::CurrentTime(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!this->initialized_) {
+    Napi::Error::New(env, "Can't get currentTime before init")
+        .ThrowAsJavaScriptException();
+  }
+
+  double currentTime = this->paWrapper_->currentTime;
+  return Napi::Number::New(env, currentTime);
+}
+
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
 //
-// PATCH
+// MESSAGING
 //
 // --------------------------------------------------------------------------
 // --------------------------------------------------------------------------
 
 /**
- * open a pd patch
- *
- * @param {String} filename - filename of the patch (i.e. test.pd)
- * @param {String} path - full path to the directory containing the patch
+ * Send a message to pd. As pd only seems to only know 3 types (Float, Symbol,
+ * and bang), we follow this convertion: Number -> Float String -> Symbol
+ *  * -> bang
+ *  Array -> list
+ */
+Napi::Value NodePd::Send(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!this->initialized_) {
+    Napi::Error::New(env, "Can't send before init")
+        .ThrowAsJavaScriptException();
+  }
+
+  if (!info[0].IsString()) {
+    Napi::Error::New(
+        env, "Invalid Arguments: pd.send(channel, value[, scheduledTime])")
+        .ThrowAsJavaScriptException();
+  }
+
+  std::string channel = info[0].As<Napi::String>().Utf8Value();
+  // pd may have resized viewed arrays since control came back to js
+  this->ValidateArrayViews_(env);
+
+  double time = 0.;
+
+  if (info[2].IsNumber()) {
+    time = info[2].As<Napi::Number>().DoubleValue();
+  }
+
+  // symbol
+  if (info[1].IsString()) {
+    std::string symbol = info[1].As<Napi::String>().Utf8Value();
+    pd_scheduled_msg_t msg(channel, time, symbol);
+    this->backgroundProcess_->addScheduledMessage(msg);
+    // number
+  } else if (info[1].IsNumber()) {
+    const float num = info[1].As<Napi::Number>().FloatValue();
+    pd_scheduled_msg_t msg(channel, time, num);
+    this->backgroundProcess_->addScheduledMessage(msg);
+    // list
+  } else if (info[1].IsArray()) {
+    Napi::Array arr = info[1].As<Napi::Array>();
+    const int len = arr.Length();
+
+    if (len > 0) {
+      pd::List list;
+
+      for (int i = 0; i < len; i++) {
+        if (arr.Has(i)) {
+          Napi::Value val = arr.Get(i);
+
+          if (val.IsNumber()) {
+            const float num = val.As<Napi::Number>().FloatValue();
+            list.addFloat(num);
+          } else if (val.IsString()) {
+            std::string str = val.As<Napi::String>().Utf8Value();
+            list.addSymbol(str);
+          }
+        }
+      }
+
+      pd_scheduled_msg_t msg(channel, time, list);
+      this->backgroundProcess_->addScheduledMessage(msg);
+    } else {
+      // fallback to bang
+      pd_scheduled_msg_t msg(channel, time);
+      this->backgroundProcess_->addScheduledMessage(msg);
+    }
+  } else {
+    // default to bang
+    pd_scheduled_msg_t msg(channel, time);
+    this->backgroundProcess_->addScheduledMessage(msg);
+  }
+
+  return env.Undefined();
+}
+
+// these 2 method are hidden behind a js event emitter API
+Napi::Value NodePd::Subscribe(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!this->initialized_) {
+    Napi::Error::New(env, "Can't subscribe before init")
+        .ThrowAsJavaScriptException();
+  }
+
+  if (!info[0].IsString() || !info[1].IsFunction()) {
+    Napi::Error::New(env, "Invalid Arguments: pd.subscribe(channel, callback)")
+        .ThrowAsJavaScriptException();
+  } else {
+    Napi::String name = info[0].As<Napi::String>();
+    std::string channel = name.Utf8Value();
+    Napi::Function callback = info[1].As<Napi::Function>();
+
+    // the options of a channel are set by its first subscription
+    if (!this->subscriptions_.add(channel, name, callback)) {
+      return env.Undefined();
+    }
+
+    if (info.Length() > 2 && info[2].IsObject()) {
+      Napi::Object options = info[2].As<Napi::Object>();
+      channel_filter_t filter;
+
+      if (options.Has("coalesce")) {
+        Napi::Value coalesce = options.Get("coalesce");
+        filter.coalesce = coalesce.IsString()
+                              ? coalesce.As<Napi::String>().Utf8Value() == "latest"
+                              : coalesce.ToBoolean().Value();
+      }
+
+      if (options.Has("maxRate")) {
+        const double maxRate = options.Get("maxRate").As<Napi::Number>().DoubleValue();
+        filter.minInterval = maxRate > 0 ? (uint64_t)(1e9 / maxRate) : 0;
+      }
+
+      if (options.Has("deadband")) {
+        filter.deadband = options.Get("deadband").As<Napi::Number>().FloatValue();
+      }
+
+      this->channelFilters_.set(channel, filter);
+    }
+
+    this->pdWrapper_->subscribe(channel);
+  }
+
+  return env.Undefined();
+}
+
+Napi::Value NodePd::Unsubscribe(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!this->initialized_) {
+    Napi::Error::New(env, "Can't unsubscribe before init")
+        .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (!info[0].IsString()) {
+    Napi::Error::New(env, "Invalid Arguments: pd.unsubscribe(channel)")
+        .ThrowAsJavaScriptException();
+  } else {
+    std::string channel = info[0].As<Napi::String>().Utf8Value();
+    // if null, all callbacks of the channel are removed
+    Napi::Value callback = info.Length() > 1 ? info[1] : env.Null();
+
+    // messages still in the receive queue are skipped once torn down
+    if (this->subscriptions_.remove(channel, callback)) {
+      this->pdWrapper_->unsubscribe(channel);
+      this->channelFilters_.remove(channel);
+    }
+  }
+
+  return env.Undefined();
+}
+
+static void finalizeMailbox(Napi::Env env, void *data,
+                            std::shared_ptr<mailbox_t> *hint) {
+  delete hint;
+}
+
+/**
+ * Open the mailbox of the given channel, i.e. the latest value received on
+ * the channel written in an ArrayBuffer shared with js, see `mailbox_t`.
  *
- * @return {Object} - object containing informations about the patch
+ * @param {String} channel
+ * @return {ArrayBuffer}
  */
-Napi::Value NodePd::OpenPatch(const Napi::CallbackInfo &info) {
+Napi::Value NodePd::Mailbox(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
   if (!this->initialized_) {
-    Napi::Error::New(env, "Can't openPatch before init")
+    Napi::Error::New(env, "Can't open mailbox before init")
         .ThrowAsJavaScriptException();
   }
 
-  if (!info[0].IsString() || !info[1].IsString()) {
-    Napi::Error::New(env, "Invalid Arguments: pd.openPatch(filename, path)")
+  if (!info[0].IsString()) {
+    Napi::Error::New(env, "Invalid Arguments: pd.mailbox(channel)")
         .ThrowAsJavaScriptException();
-  } else {
-    std::string filename = info[0].As<Napi::String>().Utf8Value();
-    std::string path = info[1].As<Napi::String>().Utf8Value();
+  }
 
-    patch_infos_t patchInfos = this->pdWrapper_->openPatch(filename, path);
+  std::string channel = info[0].As<Napi::String>().Utf8Value();
+  bool created = false;
+  std::shared_ptr<mailbox_t> mailbox = this->mailboxes_.open(channel, created);
 
-    // create a Plain Old Javascript Object to represent the patch
-    Napi::Object patch = Napi::Object::New(env);
+  if (created) {
+    this->pdWrapper_->subscribe(channel);
+  }
 
-    patch.Set("isValid", patchInfos.isValid);
-    patch.Set("filename", patchInfos.filename);
-    patch.Set("path", patchInfos.path);
-    patch.Set("$0", patchInfos.dollarZero);
+  // the buffer keeps the mailbox alive after it has been closed
+  std::shared_ptr<mailbox_t> *hint = new std::shared_ptr<mailbox_t>(mailbox);
 
-    return patch;
+  return Napi::ArrayBuffer::New(env, (void *)mailbox.get(), sizeof(mailbox_t),
+                                finalizeMailbox, hint);
+}
+
+Napi::Value NodePd::CloseMailbox(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsString()) {
+    Napi::Error::New(env, "Invalid Arguments: pd.closeMailbox(channel)")
+        .ThrowAsJavaScriptException();
+  } else {
+    std::string channel = info[0].As<Napi::String>().Utf8Value();
+
+    if (this->mailboxes_.close(channel)) {
+      this->pdWrapper_->unsubscribe(channel);
+    }
   }
 
   return env.Undefined();
 }
 
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+//
+// ARRAYS
+//
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+
 /**
- * Close the given `NodePdPath` instance
- * @param {Object} patch - A patch object as returned by open patch
+ * @param {String} name
+ * @param {Float32Array} data
+ * @param {Number} [writeLen=data.length]
+ * @param {Number} [offset=0]
  */
-Napi::Value NodePd::ClosePatch(const Napi::CallbackInfo &info) {
+Napi::Value NodePd::WriteArray(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
   if (!this->initialized_) {
-    Napi::Error::New(env, "Can't closePatch before init")
+    Napi::Error::New(env, "Can't writeArray before init")
         .ThrowAsJavaScriptException();
   }
 
-  if (!info[0].IsObject()) {
-    Napi::Error::New(env, "Invalid Arguments: pd.closePatch(patch)")
+  if (!info[0].IsString() || !info[1].IsTypedArray()) {
+    Napi::Error::New(env, "Invalid Arguments: pd.writeArray(name, data, "
+                          "len=data.length, offset=0)")
         .ThrowAsJavaScriptException();
-  } else {
-    Napi::Object patch = info[0].As<Napi::Object>();
+  }
 
-    if (!patch.Has("$0") || !patch.Has("filename") || !patch.Has("path") ||
-        !patch.Has("isValid")) {
-      Napi::Error::New(env, "Invalid Arguments: pd.closePatch(patch)")
-          .ThrowAsJavaScriptException();
-    }
+  std::string name = info[0].As<Napi::String>().Utf8Value();
+  // cf.
+  // https://github.com/nodejs/node-addon-examples/blob/master/array_buffer_to_native/node-addon-api/array_buffer_to_native.cc
+  Napi::Float32Array buf = info[1].As<Napi::Float32Array>();
+  const float *ptr = reinterpret_cast<float *>(buf.Data());
+  const size_t len = buf.ByteLength() / sizeof(float);
 
-    int dollarZero = patch.Get("$0").As<Napi::Number>().Int32Value();
-    patch_infos_t patchInfos = this->pdWrapper_->closePatch(dollarZero);
+  std::vector<float> source(ptr, ptr + len);
 
-    patch.Set("$0", patchInfos.dollarZero);
-    patch.Set("isValid", patchInfos.isValid);
+  int writeLen = len;
+  int offset = 0;
 
-    return patch;
+  if (info[2].IsNumber()) {
+    writeLen = info[2].As<Napi::Number>().Int32Value();
   }
 
-  return env.Undefined();
+  if (info[3].IsNumber()) {
+    writeLen = info[3].As<Napi::Number>().Int32Value();
+  }
+
+  bool result = this->pdWrapper_->writeArray(name, source, writeLen, offset);
+
+  ArrayChangeTracker *tracker = this->FindArrayChangeTracker_(name);
+
+  if (result && tracker != NULL) {
+    tracker->markDirty(offset, writeLen);
+  }
+
+  return Napi::Boolean::New(env, result);
 }
 
-Napi::Value NodePd::AddToSearchPath(const Napi::CallbackInfo &info) {
+/**
+ * Same as `WriteArray` but the values are staged and copied into the pd
+ * array by the audio thread between two ticks, therefore the DSP never
+ * reads a partially written array.
+ *
+ * @param {String} name
+ * @param {Float32Array} data
+ * @param {Object} [options]
+ * @param {Number} [options.offset=0] - offset in the pd array
+ * @param {Number} [options.time=0] - audio time at which the values should be
+ *  applied, they are applied at the first tick starting after this time.
+ * @return {Boolean} - false if the array does not exists or is too small
+ */
+Napi::Value NodePd::WriteArrayAtomic(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
-  if (!info[0].IsString()) {
-    Napi::Error::New(env, "Invalid Arguments: pd.addToSearchPath(pathname)")
+  if (!this->initialized_) {
+    Napi::Error::New(env, "Can't writeArrayAtomic before init")
         .ThrowAsJavaScriptException();
   }
 
-  std::string pathname = info[0].As<Napi::String>().Utf8Value();
-  this->pdWrapper_->addToSearchPath(pathname);
+  if (!info[0].IsString() || !info[1].IsTypedArray()) {
+    Napi::Error::New(env, "Invalid Arguments: pd.writeArrayAtomic(name, data, "
+                          "{ offset=0, time=0 })")
+        .ThrowAsJavaScriptException();
+  }
 
-  return env.Undefined();
-}
+  std::string name = info[0].As<Napi::String>().Utf8Value();
+  Napi::Float32Array buf = info[1].As<Napi::Float32Array>();
+  const float *ptr = reinterpret_cast<float *>(buf.Data());
+  const size_t len = buf.ByteLength() / sizeof(float);
 
-Napi::Value NodePd::ClearSearchPath(const Napi::CallbackInfo &info) {
-  Napi::Env env = info.Env();
-  this->pdWrapper_->clearSearchPath();
+  int offset = 0;
+  double time = 0.;
 
-  return env.Undefined();
+  if (info[2].IsObject()) {
+    Napi::Object options = info[2].As<Napi::Object>();
+
+    if (options.Get("offset").IsNumber()) {
+      offset = options.Get("offset").As<Napi::Number>().Int32Value();
+    }
+
+    if (options.Get("time").IsNumber()) {
+      time = options.Get("time").As<Napi::Number>().DoubleValue();
+    }
+  }
+
+  // check now, errors would be silent in the audio thread
+  const int size = this->pdWrapper_->arraySize(name);
+
+  if (len == 0 || offset < 0 || offset + (int)len > size) {
+    return Napi::Boolean::New(env, false);
+  }
+
+  // stage the values here so that the audio thread only does a memcpy
+  std::vector<float> data(ptr, ptr + len);
+  auto task = std::make_shared<WriteArrayTask>(this->pdWrapper_, name,
+                                               std::move(data), offset, time);
+  this->tickScheduler_->add(task);
+
+  ArrayChangeTracker *tracker = this->FindArrayChangeTracker_(name);
+
+  if (tracker != NULL) {
+    tracker->markPending(task, offset, len);
+  }
+
+  return Napi::Boolean::New(env, true);
 }
 
-Napi::Value NodePd::CurrentTime(const Napi::CallbackInfo &info) {
+/**
+ * @param {String} name
+ * @param {Float32Arra} destBuffer
+ * @param {Number} [readLen=destBuffer.length]
+ * @param {Number} [offset=0]
+ */
+Napi::Value NodePd::ReadArray(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
   if (!this->initialized_) {
-    Napi::Error::New(env, "Can't get currentTime before init")
+    Napi::Error::New(env, "Can't readArray before init")
         .ThrowAsJavaScriptException();
   }
 
-  double currentTime = this->paWrapper_->currentTime;
-  return Napi::Number::New(env, currentTime);
-}
+  if (!info[0].IsString() || !info[1].IsTypedArray()) {
+    Napi::Error::New(env,
+                     "Invalid Arguments: pd.readArray(name, len=1, offset=0)")
+        .ThrowAsJavaScriptException();
+  }
 
-// --------------------------------------------------------------------------
-// --------------------------------------------------------------------------
-//
-// MESSAGING
-//
-// --------------------------------------------------------------------------
-// --------------------------------------------------------------------------
+  std::string name = info[0].As<Napi::String>().Utf8Value();
+
+  Napi::Float32Array buf = info[1].As<Napi::Float32Array>();
+  const float *ptr = reinterpret_cast<float *>(buf.Data());
+  const size_t len = buf.ByteLength() / sizeof(float);
+  std::vector<float> dest(ptr, ptr + len);
+
+  int readLen = len;
+  int offset = 0;
+
+  if (info[2].IsNumber()) {
+    readLen = info[2].As<Napi::Number>().Int32Value();
+  }
+
+  if (info[3].IsNumber()) {
+    offset = info[3].As<Napi::Number>().Int32Value();
+  }
+
+  bool result = this->pdWrapper_->readArray(name, dest, readLen, offset);
+
+  // copy back values in the given Float32Array,
+  // @note: this is weird, as it should be a reference to the same pointer
+  // from what I understand (which shows I don't really understand...)
+  for (int i = offset; i < readLen; i++) {
+    buf[i] = dest[i];
+  }
+
+  return Napi::Boolean::New(env, result);
+}
 
 /**
- * Send a message to pd. As pd only seems to only know 3 types (Float, Symbol,
- * and bang), we follow this convertion: Number -> Float String -> Symbol
- *  * -> bang
- *  Array -> list
+ * Read several pd arrays in one call, all copies being done while holding
+ * the pd lock once so that they reflect the same tick.
+ *
+ * @param {Array<Object>} reads - list of { name, target, offset=0,
+ *  length=target.length }
+ * @return {Array<Boolean>} - success of each read
  */
-Napi::Value NodePd::Send(const Napi::CallbackInfo &info) {
+Napi::Value NodePd::ReadArrays(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
   if (!this->initialized_) {
-    Napi::Error::New(env, "Can't send before init")
+    Napi::Error::New(env, "Can't readArrays before init")
         .ThrowAsJavaScriptException();
   }
 
-  if (!info[0].IsString()) {
-    Napi::Error::New(
-        env, "Invalid Arguments: pd.send(channel, value[, scheduledTime])")
-        .ThrowAsJavaScriptException();
+  const char *usage = "Invalid Arguments: pd.readArrays([{ name, target, "
+                      "offset=0, length=target.length }])";
+
+  if (!info[0].IsArray()) {
+    Napi::Error::New(env, usage).ThrowAsJavaScriptException();
   }
 
-  std::string channel = info[0].As<Napi::String>().Utf8Value();
+  Napi::Array list = info[0].As<Napi::Array>();
+  std::vector<array_read_t> reads(list.Length());
 
-  double time = 0.;
+  for (uint32_t i = 0; i < list.Length(); i++) {
+    Napi::Value entry = list.Get(i);
 
-  if (info[2].IsNumber()) {
-    time = info[2].As<Napi::Number>().DoubleValue();
-  }
+    if (!entry.IsObject()) {
+      Napi::Error::New(env, usage).ThrowAsJavaScriptException();
+    }
 
-  // symbol
-  if (info[1].IsString()) {
-    std::string symbol = info[1].As<Napi::String>().Utf8Value();
-    pd_scheduled_msg_t msg(channel, time, symbol);
-    this->backgroundProcess_->addScheduledMessage(msg);
-    // number
-  } else if (info[1].IsNumber()) {
-    const float num = info[1].As<Napi::Number>().FloatValue();
-    pd_scheduled_msg_t msg(channel, time, num);
-    this->backgroundProcess_->addScheduledMessage(msg);
-    // list
-  } else if (info[1].IsArray()) {
-    Napi::Array arr = info[1].As<Napi::Array>();
-    const int len = arr.Length();
+    Napi::Object options = entry.As<Napi::Object>();
 
-    if (len > 0) {
-      pd::List list;
+    if (!options.Get("name").IsString() ||
+        !options.Get("target").IsTypedArray()) {
+      Napi::Error::New(env, usage).ThrowAsJavaScriptException();
+    }
 
-      for (int i = 0; i < len; i++) {
-        if (arr.Has(i)) {
-          Napi::Value val = arr.Get(i);
+    Napi::Float32Array buf = options.Get("target").As<Napi::Float32Array>();
+    const int len = buf.ByteLength() / sizeof(float);
 
-          if (val.IsNumber()) {
-            const float num = val.As<Napi::Number>().FloatValue();
-            list.addFloat(num);
-          } else if (val.IsString()) {
-            std::string str = val.As<Napi::String>().Utf8Value();
-            list.addSymbol(str);
-          }
-        }
-      }
+    array_read_t &read = reads[i];
+    read.name = options.Get("name").As<Napi::String>().Utf8Value();
+    read.dest = reinterpret_cast<float *>(buf.Data());
+    read.length = len;
 
-      pd_scheduled_msg_t msg(channel, time, list);
-      this->backgroundProcess_->addScheduledMessage(msg);
-    } else {
-      // fallback to bang
-      pd_scheduled_msg_t msg(channel, time);
-      this->backgroundProcess_->addScheduledMessage(msg);
+    if (options.Get("offset").IsNumber()) {
+      read.offset = options.Get("offset").As<Napi::Number>().Int32Value();
+    }
+
+    if (options.Get("length").IsNumber()) {
+      // never write past the end of the target
+      read.length = std::min(
+          len, options.Get("length").As<Napi::Number>().Int32Value());
     }
-  } else {
-    // default to bang
-    pd_scheduled_msg_t msg(channel, time);
-    this->backgroundProcess_->addScheduledMessage(msg);
   }
 
-  return env.Undefined();
+  this->pdWrapper_->readArrays(reads);
+
+  Napi::Array result = Napi::Array::New(env, reads.size());
+
+  for (uint32_t i = 0; i < reads.size(); i++) {
+    result.Set(i, Napi::Boolean::New(env, reads[i].result));
+  }
+
+  return result;
 }
 
-// these 2 method are hidden behind a js event emitter API
-Napi::Value NodePd::Subscribe(const Napi::CallbackInfo &info) {
+Napi::Value NodePd::ArraySize(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
   if (!this->initialized_) {
-    Napi::Error::New(env, "Can't subscribe before init")
+    Napi::Error::New(env, "Can't arraySize before init")
         .ThrowAsJavaScriptException();
   }
 
   if (!info[0].IsString()) {
-    Napi::Error::New(env, "Invalid Arguments: pd.subscribe(channel)")
+    Napi::Error::New(env, "Invalid Arguments: pd.arraySize(name)")
         .ThrowAsJavaScriptException();
-  } else {
-    std::string channel = info[0].As<Napi::String>().Utf8Value();
-    this->pdWrapper_->subscribe(channel);
   }
 
-  return env.Undefined();
+  std::string name = info[0].As<Napi::String>().Utf8Value();
+  const int size = this->pdWrapper_->arraySize(name);
+
+  return Napi::Number::New(env, size);
 }
 
-Napi::Value NodePd::Unsubscribe(const Napi::CallbackInfo &info) {
+Napi::Value NodePd::ClearArray(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
   if (!this->initialized_) {
-    Napi::Error::New(env, "Can't unsubscribe before init")
+    Napi::Error::New(env, "Can't clearArray before init")
         .ThrowAsJavaScriptException();
   }
 
   if (!info[0].IsString()) {
-    Napi::Error::New(env, "Invalid Arguments: pd.subscribe(channel)")
+    Napi::Error::New(env, "Invalid Arguments: pd.clearArray(name, value=0)")
         .ThrowAsJavaScriptException();
-  } else {
-    std::string channel = info[0].As<Napi::String>().Utf8Value();
-    this->pdWrapper_->unsubscribe(channel);
+  }
+
+  std::string name = info[0].As<Napi::String>().Utf8Value();
+  int value = 0;
+
+  if (info[1].IsNumber()) {
+    value = info[1].As<Napi::Number>().Int32Value();
+  }
+
+  this->pdWrapper_->clearArray(name, value);
+
+  ArrayChangeTracker *tracker = this->FindArrayChangeTracker_(name);
+
+  if (tracker != NULL) {
+    tracker->markAll();
   }
 
   return env.Undefined();
 }
 
-// --------------------------------------------------------------------------
-// --------------------------------------------------------------------------
-//
-// ARRAYS
-//
-// --------------------------------------------------------------------------
-// --------------------------------------------------------------------------
+/**
+ * Write a (possibly large) Float32Array into a pd array without blocking,
+ * the copy is split in chunks applied between successive ticks.
+ *
+ * @param {String} name
+ * @param {Float32Array} data - must not be modified until the Promise is
+ *  settled
+ * @param {Object} [options]
+ * @param {Number} [options.offset=0]
+ * @param {Number} [options.chunkSize=16384] - number of values copied per tick
+ * @param {Function} [options.onProgress] - called with the progression (0 to 1)
+ * @return {Promise<Float32Array>} - resolves with `data`
+ */
+Napi::Value NodePd::WriteArrayAsync(const Napi::CallbackInfo &info) {
+  return this->ArrayTransfer_(info, ArrayTransferTask::Direction::WRITE);
+}
 
 /**
+ * Read a pd array into a (possibly large) Float32Array without blocking,
+ * the copy is split in chunks applied between successive ticks.
+ *
  * @param {String} name
- * @param {Float32Array} data
- * @param {Number} [writeLen=data.length]
- * @param {Number} [offset=0]
+ * @param {Float32Array} dest - must not be used until the Promise is settled
+ * @param {Object} [options]
+ * @param {Number} [options.offset=0]
+ * @param {Number} [options.chunkSize=16384] - number of values copied per tick
+ * @param {Function} [options.onProgress] - called with the progression (0 to 1)
+ * @return {Promise<Float32Array>} - resolves with `dest`
  */
-Napi::Value NodePd::WriteArray(const Napi::CallbackInfo &info) {
+Napi::Value NodePd::ReadArrayAsync(const Napi::CallbackInfo &info) {
+  return this->ArrayTransfer_(info, ArrayTransferTask::Direction::READ);
+}
+
+Napi::Value NodePd::ArrayTransfer_(const Napi::CallbackInfo &info,
+                                   ArrayTransferTask::Direction direction) {
   Napi::Env env = info.Env();
+  const bool write = direction == ArrayTransferTask::Direction::WRITE;
 
   if (!this->initialized_) {
-    Napi::Error::New(env, "Can't writeArray before init")
+    Napi::Error::New(env, write ? "Can't writeArrayAsync before init"
+                                : "Can't readArrayAsync before init")
         .ThrowAsJavaScriptException();
   }
 
   if (!info[0].IsString() || !info[1].IsTypedArray()) {
-    Napi::Error::New(env, "Invalid Arguments: pd.writeArray(name, data, "
-                          "len=data.length, offset=0)")
+    Napi::Error::New(env, write ? "Invalid Arguments: pd.writeArrayAsync(name, "
+                                  "data, { offset=0, chunkSize, onProgress })"
+                                : "Invalid Arguments: pd.readArrayAsync(name, "
+                                  "dest, { offset=0, chunkSize, onProgress })")
         .ThrowAsJavaScriptException();
   }
 
   std::string name = info[0].As<Napi::String>().Utf8Value();
-  // cf.
-  // https://github.com/nodejs/node-addon-examples/blob/master/array_buffer_to_native/node-addon-api/array_buffer_to_native.cc
   Napi::Float32Array buf = info[1].As<Napi::Float32Array>();
-  const float *ptr = reinterpret_cast<float *>(buf.Data());
-  const size_t len = buf.ByteLength() / sizeof(float);
-
-  std::vector<float> source(ptr, ptr + len);
+  float *ptr = reinterpret_cast<float *>(buf.Data());
+  const int len = buf.ByteLength() / sizeof(float);
 
-  int writeLen = len;
   int offset = 0;
+  int chunkSize = DEFAULT_ARRAY_CHUNK_SIZE;
+  Napi::Value onProgress = env.Undefined();
 
-  if (info[2].IsNumber()) {
-    writeLen = info[2].As<Napi::Number>().Int32Value();
+  if (info[2].IsObject()) {
+    Napi::Object options = info[2].As<Napi::Object>();
+
+    if (options.Get("offset").IsNumber()) {
+      offset = options.Get("offset").As<Napi::Number>().Int32Value();
+    }
+
+    if (options.Get("chunkSize").IsNumber()) {
+      chunkSize = options.Get("chunkSize").As<Napi::Number>().Int32Value();
+    }
+
+    onProgress = options.Get("onProgress");
   }
 
-  if (info[3].IsNumber()) {
-    writeLen = info[3].As<Napi::Number>().Int32Value();
+  const int size = this->pdWrapper_->arraySize(name);
+
+  if (offset < 0 || offset + len > size || chunkSize <= 0) {
+    Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+    deferred.Reject(Napi::Error::New(env, "Invalid array name, offset or length")
+                        .Value());
+    return deferred.Promise();
   }
 
-  bool result = this->pdWrapper_->writeArray(name, source, writeLen, offset);
-  return Napi::Boolean::New(env, result);
+  auto task = std::make_shared<ArrayTransferTask>(
+      this->pdWrapper_, direction, name, ptr, len, offset, chunkSize);
+
+  ArrayChangeTracker *tracker = this->FindArrayChangeTracker_(name);
+
+  if (write && tracker != NULL) {
+    tracker->markPending(task, offset, len);
+  }
+
+  TickTaskWorker *worker = new TickTaskWorker(
+      env, write ? "pd write array" : "pd read array", this->tickScheduler_,
+      this->paWrapper_, &this->taskCompletions_, task);
+  // the typed array must outlive the transfer
+  worker->Retain(buf);
+
+  if (onProgress.IsFunction()) {
+    worker->SetProgressCallback(onProgress.As<Napi::Function>());
+  }
+
+  Napi::Promise promise = worker->GetPromise();
+  worker->Queue();
+
+  return promise;
 }
 
 /**
- * @param {String} name
- * @param {Float32Arra} destBuffer
- * @param {Number} [readLen=destBuffer.length]
- * @param {Number} [offset=0]
+ * Decode a WAV or AIFF file in a worker thread and copy one of its channels
+ * into a pd array, the copy being applied at tick boundaries.
+ *
+ * @param {String} arrayName
+ * @param {String} pathname - absolute path to the soundfile
+ * @param {Object} [options]
+ * @param {Number} [options.channel=0] - channel of the file to load
+ * @param {Boolean} [options.resize=false] - resize the array to the length of
+ *  the file, else the file is truncated or the array padded with zeros
+ * @param {Function} [options.onProgress] - called with the progression of the
+ *  copy into the pd array (0 to 1)
+ * @return {Promise<Object>} - { arrayName, numFrames, numChannels, sampleRate,
+ *  channel }
  */
-Napi::Value NodePd::ReadArray(const Napi::CallbackInfo &info) {
+Napi::Value NodePd::LoadSoundfile(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
   if (!this->initialized_) {
-    Napi::Error::New(env, "Can't readArray before init")
+    Napi::Error::New(env, "Can't loadSoundfile before init")
         .ThrowAsJavaScriptException();
   }
 
-  if (!info[0].IsString() || !info[1].IsTypedArray()) {
-    Napi::Error::New(env,
-                     "Invalid Arguments: pd.readArray(name, len=1, offset=0)")
+  if (!info[0].IsString() || !info[1].IsString()) {
+    Napi::Error::New(env, "Invalid Arguments: pd.loadSoundfile(arrayName, "
+                          "pathname, { channel=0, resize=false, onProgress })")
         .ThrowAsJavaScriptException();
   }
 
-  std::string name = info[0].As<Napi::String>().Utf8Value();
+  std::string arrayName = info[0].As<Napi::String>().Utf8Value();
+  std::string pathname = info[1].As<Napi::String>().Utf8Value();
 
-  Napi::Float32Array buf = info[1].As<Napi::Float32Array>();
-  const float *ptr = reinterpret_cast<float *>(buf.Data());
-  const size_t len = buf.ByteLength() / sizeof(float);
-  std::vector<float> dest(ptr, ptr + len);
+  int channel = 0;
+  bool resize = false;
+  Napi::Value onProgress = env.Undefined();
 
-  int readLen = len;
-  int offset = 0;
+  if (info[2].IsObject()) {
+    Napi::Object options = info[2].As<Napi::Object>();
 
-  if (info[2].IsNumber()) {
-    readLen = info[2].As<Napi::Number>().Int32Value();
+    if (options.Get("channel").IsNumber()) {
+      channel = options.Get("channel").As<Napi::Number>().Int32Value();
+    }
+
+    if (options.Get("resize").IsBoolean()) {
+      resize = options.Get("resize").As<Napi::Boolean>().Value();
+    }
+
+    onProgress = options.Get("onProgress");
   }
 
-  if (info[3].IsNumber()) {
-    offset = info[3].As<Napi::Number>().Int32Value();
+  if (resize) {
+    // the storage may be reallocated at any time by the worker thread, detach
+    // the views now and refuse new ones until the load is done
+    auto search = this->arrayViews_.find(arrayName);
+
+    if (search != this->arrayViews_.end() && search->second.vec != NULL) {
+      this->InvalidateArrayView_(env, search->second);
+    }
+
+    this->resizingArrays_[arrayName] += 1;
   }
 
-  bool result = this->pdWrapper_->readArray(name, dest, readLen, offset);
+  SoundfileWorker *worker = new SoundfileWorker(
+      env, this->pdWrapper_, arrayName, pathname, channel, resize,
+      DEFAULT_ARRAY_CHUNK_SIZE, [this, arrayName, resize](Napi::Env env) {
+        if (resize && --this->resizingArrays_[arrayName] == 0) {
+          this->resizingArrays_.erase(arrayName);
+        }
 
-  // copy back values in the given Float32Array,
-  // @note: this is weird, as it should be a reference to the same pointer
-  // from what I understand (which shows I don't really understand...)
-  for (int i = offset; i < readLen; i++) {
-    buf[i] = dest[i];
+        this->ValidateArrayViews_(env);
+      });
+
+  if (onProgress.IsFunction()) {
+    worker->SetProgressCallback(onProgress.As<Napi::Function>());
   }
 
-  return Napi::Boolean::New(env, result);
+  Napi::Promise promise = worker->GetPromise();
+  worker->Queue();
+
+  return promise;
 }
 
-Napi::Value NodePd::ArraySize(const Napi::CallbackInfo &info) {
+/**
+ * Create a Float32Array over the storage of a pd array, without any copy.
+ * As the storage is made of `t_word` (cf. m_pd.h) the value at index `i` of
+ * the pd array is at index `i * stride` of the returned Float32Array.
+ * The underlying ArrayBuffer is detached, and `generation` incremented, the
+ * next time the js thread checks the views after pd resized or freed the
+ * array, see `ValidateArrayViews_`.
+ *
+ * @param {String} name
+ * @return {Object|undefined} - { name, data, stride, length, generation },
+ *  undefined if the array does not exist or is being resized by
+ *  `loadSoundfile`
+ */
+Napi::Value NodePd::ArrayView(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
   if (!this->initialized_) {
-    Napi::Error::New(env, "Can't arraySize before init")
+    Napi::Error::New(env, "Can't arrayView before init")
         .ThrowAsJavaScriptException();
   }
 
   if (!info[0].IsString()) {
-    Napi::Error::New(env, "Invalid Arguments: pd.arraySize(name)")
+    Napi::Error::New(env, "Invalid Arguments: pd.arrayView(name)")
         .ThrowAsJavaScriptException();
   }
 
   std::string name = info[0].As<Napi::String>().Utf8Value();
-  const int size = this->pdWrapper_->arraySize(name);
+  // make sure we don't share a generation with stale views
+  this->ValidateArrayViews_(env);
 
-  return Napi::Number::New(env, size);
-}
+  // storage is about to be reallocated by `loadSoundfile`
+  if (this->resizingArrays_.count(name) > 0) {
+    return env.Undefined();
+  }
 
-Napi::Value NodePd::ClearArray(const Napi::CallbackInfo &info) {
-  Napi::Env env = info.Env();
+  t_word *vec = NULL;
+  int size = 0;
 
-  if (!this->initialized_) {
-    Napi::Error::New(env, "Can't clearArray before init")
-        .ThrowAsJavaScriptException();
+  if (!this->pdWrapper_->getArrayWords(name, &vec, &size)) {
+    return env.Undefined();
   }
 
+  array_view_t &view = this->arrayViews_[name];
+  view.vec = vec;
+  view.size = size;
+
+  const size_t stride = sizeof(t_word) / sizeof(float);
+  // memory is owned by pd, hence no finalizer
+  Napi::ArrayBuffer buffer =
+      Napi::ArrayBuffer::New(env, (void *)vec, size * sizeof(t_word));
+  Napi::Float32Array data =
+      Napi::Float32Array::New(env, size * stride, buffer, 0);
+
+  view.buffers.push_back(Napi::Weak(buffer));
+  this->backgroundProcess_->watchArrays(true);
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("name", name);
+  result.Set("data", data);
+  result.Set("stride", Napi::Number::New(env, stride));
+  result.Set("length", Napi::Number::New(env, size));
+  result.Set("generation", Napi::Number::New(env, view.generation));
+
+  return result;
+}
+
+/**
+ * Current generation of the views of the given array, a view whose
+ * generation differs from this value has been detached.
+ *
+ * @param {String} name
+ * @return {Number}
+ */
+Napi::Value NodePd::ArrayViewGeneration(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
   if (!info[0].IsString()) {
-    Napi::Error::New(env, "Invalid Arguments: pd.clearArray(name, value=0)")
+    Napi::Error::New(env, "Invalid Arguments: pd.arrayViewGeneration(name)")
         .ThrowAsJavaScriptException();
   }
 
   std::string name = info[0].As<Napi::String>().Utf8Value();
-  int value = 0;
+  this->ValidateArrayViews_(env);
 
-  if (info[1].IsNumber()) {
-    value = info[1].As<Napi::Number>().Int32Value();
+  auto search = this->arrayViews_.find(name);
+
+  if (search == this->arrayViews_.end()) {
+    return Napi::Number::New(env, 0);
   }
 
-  this->pdWrapper_->clearArray(name, value);
+  return Napi::Number::New(env, search->second.generation);
+}
 
-  return env.Undefined();
+/**
+ * Drop the references to buffers that have been garbage collected, so that
+ * views created in a loop do not accumulate.
+ */
+static void pruneArrayViewBuffers(array_view_t &view) {
+  auto &buffers = view.buffers;
+
+  buffers.erase(std::remove_if(buffers.begin(), buffers.end(),
+                               [](const Napi::Reference<Napi::ArrayBuffer> &ref) {
+                                 Napi::Value buffer = ref.Value();
+                                 return buffer.IsEmpty() ||
+                                        buffer.IsUndefined();
+                               }),
+                buffers.end());
+}
+
+/**
+ * Detach all views whose pd array has been resized, reallocated or freed.
+ * Called by the native calls that can change the arrays, by `send` and
+ * before the messages received from pd are dispatched.
+ */
+void NodePd::ValidateArrayViews_(Napi::Env env) {
+  bool watch = false;
+
+  for (auto &entry : this->arrayViews_) {
+    array_view_t &view = entry.second;
+
+    // already detached
+    if (view.vec == NULL) {
+      continue;
+    }
+
+    t_word *vec = NULL;
+    int size = 0;
+
+    const bool found = this->pdWrapper_->getArrayWords(entry.first, &vec, &size);
+
+    if (!found || vec != view.vec || size != view.size) {
+      this->InvalidateArrayView_(env, view);
+    } else {
+      pruneArrayViewBuffers(view);
+      watch = true;
+    }
+  }
+
+  if (this->backgroundProcess_ != NULL) {
+    this->backgroundProcess_->watchArrays(watch);
+  }
+}
+
+void NodePd::InvalidateArrayView_(Napi::Env env, array_view_t &view) {
+  for (auto &ref : view.buffers) {
+    Napi::Value buffer = ref.Value();
+
+    // may have been garbage collected already
+    if (!buffer.IsEmpty() && !buffer.IsUndefined()) {
+      napi_detach_arraybuffer(env, buffer);
+    }
+  }
+
+  view.buffers.clear();
+  view.vec = NULL;
+  view.size = 0;
+  view.generation += 1;
 }
 
 // --------------------------------------------------------------------------
@@ -868,4 +2541,113 @@ Napi::Value NodePd::StopGUI(const Napi::CallbackInfo &info) {
   return env.Undefined();
 }
 
+/**
+ * Start tracking the changes made to a pd array.
+ *
+ * @param {String} name
+ * @param {Object} [options]
+ * @param {Boolean} [options.compare=true] - compare the array against a shadow
+ *  copy on each read to catch the writes made from pd
+ */
+Napi::Value NodePd::TrackArrayChanges(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsString()) {
+    Napi::Error::New(env, "Invalid Arguments: pd.trackArrayChanges(name, "
+                          "{ compare=true })")
+        .ThrowAsJavaScriptException();
+  }
+
+  std::string name = info[0].As<Napi::String>().Utf8Value();
+  bool compare = true;
+
+  if (info[1].IsObject()) {
+    Napi::Object options = info[1].As<Napi::Object>();
+
+    if (options.Get("compare").IsBoolean()) {
+      compare = options.Get("compare").As<Napi::Boolean>().Value();
+    }
+  }
+
+  this->arrayChanges_.erase(name);
+  this->arrayChanges_.emplace(name, ArrayChangeTracker(compare));
+
+  return env.Undefined();
+}
+
+/**
+ * Stop tracking the changes made to a pd array.
+ *
+ * @param {String} name
+ */
+Napi::Value NodePd::UntrackArrayChanges(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsString()) {
+    Napi::Error::New(env, "Invalid Arguments: pd.untrackArrayChanges(name)")
+        .ThrowAsJavaScriptException();
+  }
+
+  std::string name = info[0].As<Napi::String>().Utf8Value();
+  this->arrayChanges_.erase(name);
+
+  return env.Undefined();
+}
+
+/**
+ * Copy the values of a tracked pd array that changed since the last call
+ * into `dest`, at the same offsets.
+ *
+ * @param {String} name
+ * @param {Float32Array} dest - must be at least as large as the pd array
+ * @return {Array|null} - list of [offset, length] of the changed spans, null
+ *  if the array is not tracked, does not exists or is larger than `dest`
+ */
+Napi::Value NodePd::ReadArrayChanges(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!this->initialized_) {
+    Napi::Error::New(env, "Can't readArrayChanges before init")
+        .ThrowAsJavaScriptException();
+  }
+
+  if (!info[0].IsString() || !info[1].IsTypedArray()) {
+    Napi::Error::New(env, "Invalid Arguments: pd.readArrayChanges(name, dest)")
+        .ThrowAsJavaScriptException();
+  }
+
+  std::string name = info[0].As<Napi::String>().Utf8Value();
+  Napi::Float32Array buf = info[1].As<Napi::Float32Array>();
+  float *ptr = reinterpret_cast<float *>(buf.Data());
+  const int len = buf.ByteLength() / sizeof(float);
+
+  ArrayChangeTracker *tracker = this->FindArrayChangeTracker_(name);
+
+  if (tracker == NULL) {
+    return env.Null();
+  }
+
+  std::vector<ArrayChangeTracker::span_t> spans;
+
+  if (!this->pdWrapper_->readArrayChanges(name, *tracker, ptr, len, spans)) {
+    return env.Null();
+  }
+
+  Napi::Array result = Napi::Array::New(env, spans.size());
+
+  for (size_t i = 0; i < spans.size(); i++) {
+    Napi::Array span = Napi::Array::New(env, 2);
+    span.Set((uint32_t)0, Napi::Number::New(env, spans[i].first));
+    span.Set((uint32_t)1, Napi::Number::New(env, spans[i].second));
+    result.Set(i, span);
+  }
+
+  return result;
+}
+
+ArrayChangeTracker *NodePd::FindArrayChangeTracker_(const std::string &name) {
+  auto it = this->arrayChanges_.find(name);
+  return it != this->arrayChanges_.end() ? &it->second : NULL;
+}
+
 } // namespace node_lib_pd
@@ -1,22 +1,46 @@
 #pragma once
 
+#include <algorithm>
 #include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstring>
 #include <iostream>
+#include <map>
+#include <sched.h>
 #include <thread>
 // #include <vector>
 // #include <iterator>
 
 #include "./BackgroundProcess.h"
 #include "./LockedQueue.h"
+#include "./MemoryLock.h"
 #include "./PaWrapper.h"
 #include "./PdReceiver.h"
 #include "./PdWrapper.h"
+#include "./TickScheduler.h"
+#include "./ArrayTasks.h"
+#include "./TickTaskWorker.h"
+#include "./SoundfileWorker.h"
+#include "./PatchWorkers.h"
+#include "./InitWorker.h"
 #include "PdBase.hpp"
 #include "types.h"
 #include <napi.h>
 
 namespace node_lib_pd {
 
+/**
+ * Bookkeeping of the js views created over the storage of a given pd array,
+ * used to detach them when pd reallocates or frees the array.
+ */
+struct array_view_t {
+  t_word *vec = NULL;
+  int size = 0;
+  uint32_t generation = 0;
+  std::vector<Napi::Reference<Napi::ArrayBuffer>> buffers;
+};
+
 /**
  *
  */
@@ -33,18 +57,58 @@ private:
   static const int DEFAULT_NUM_OUTPUT_CHANNELS = 2;
   static const int DEFAULT_SAMPLE_RATE = 48000;
   static const int DEFAULT_NUM_TICKS = 1;
-
+  // ms to wait for the first audio callback before giving up init
+  static const int DEFAULT_INIT_TIMEOUT = 5000;
+  // ratio of a tick duration that can be spent applying tick tasks
+  static constexpr double TICK_TASKS_BUDGET = 0.25;
+  // number of values copied per tick by async array transfers
+  static const int DEFAULT_ARRAY_CHUNK_SIZE = 16384;
+
+  int ConfigureAudio_(Napi::Object config);
+  bool StartAudio_(bool computeAudio, std::string &error);
+  void StopAudio_();
+  void StartBackgroundProcess_(Napi::Env env);
+  Napi::Object InitTimings_(Napi::Env env);
+  void ParseThreadSettings_(Napi::Object obj, thread_settings_t &settings);
+  void ParseQueueConfig_(Napi::Object obj, queue_config_t &config);
+  void ParseLogConfig_(Napi::Object obj);
+  Napi::Object QueueStatsToObject_(Napi::Env env, const queue_stats_t &stats);
+  Napi::Value ThreadReportToObject_(Napi::Env env,
+                                    const thread_report_t &report);
+  Napi::Object HistogramToObject_(Napi::Env env, const Histogram &histogram);
   Napi::Object PaDeviceToObject_(Napi::Env env, PaDeviceInfo const * deviceInfo, int index);
+  void ValidateArrayViews_(Napi::Env env);
+  void InvalidateArrayView_(Napi::Env env, array_view_t &view);
+  ArrayChangeTracker *FindArrayChangeTracker_(const std::string &name);
+  Napi::Value ArrayTransfer_(const Napi::CallbackInfo &info,
+                             ArrayTransferTask::Direction direction);
 
   bool initialized_;
+  bool initializing_;
+  double pdInitDuration_;
+  thread_report_t messageThread_;
+  MemoryLock memoryLock_;
+  LatencyTracer latencyTracer_;
+  ChannelFilters channelFilters_;
+  SubscriptionTable subscriptions_;
+  Mailboxes mailboxes_;
+  LogRing logRing_;
+  TaskCompletions taskCompletions_;
   audio_config_t *audioConfig_;
   LockedQueue<pd_msg_t> *msgQueue_;
   PaWrapper *paWrapper_;
   PdWrapper *pdWrapper_;
   PdReceiver *pdReceiver_;
   BackgroundProcess *backgroundProcess_;
+  TickScheduler *tickScheduler_;
+  std::map<std::string, array_view_t> arrayViews_;
+  // arrays being resized by `loadSoundfile`, no view can be created
+  std::map<std::string, int> resizingArrays_;
+  std::map<std::string, ArrayChangeTracker> arrayChanges_;
 
   Napi::Value Initialize(const Napi::CallbackInfo &info);
+  Napi::Value InitializeAsync(const Napi::CallbackInfo &info);
+  Napi::Value GetInitTimings(const Napi::CallbackInfo &info);
   Napi::Value Destroy(const Napi::CallbackInfo &info);
 
   Napi::Value ComputeAudio(const Napi::CallbackInfo &info);
@@ -56,21 +120,56 @@ private:
   Napi::Value GetInputDevices(const Napi::CallbackInfo &info);
   Napi::Value GetOutputDevices(const Napi::CallbackInfo &info);
   Napi::Value GetDeviceAtIndex(const Napi::CallbackInfo &info);
+  Napi::Value RefreshDevices(const Napi::CallbackInfo &info);
+  Napi::Value GetStreamInfo(const Napi::CallbackInfo &info);
+  Napi::Value GetThreadSettings(const Napi::CallbackInfo &info);
+  Napi::Value GetMemoryLock(const Napi::CallbackInfo &info);
+  Napi::Value GetAudioStats(const Napi::CallbackInfo &info);
+  Napi::Value GetDspLoad(const Napi::CallbackInfo &info);
+  Napi::Value ResetDspLoad(const Napi::CallbackInfo &info);
+  Napi::Value EnableLatencyTracing(const Napi::CallbackInfo &info);
+  Napi::Value GetLatencyStats(const Napi::CallbackInfo &info);
+  Napi::Value ResetLatencyStats(const Napi::CallbackInfo &info);
+  Napi::Value GetQueueStats(const Napi::CallbackInfo &info);
+  Napi::Value GetLogStats(const Napi::CallbackInfo &info);
 
   Napi::Value OpenPatch(const Napi::CallbackInfo &info);
   Napi::Value ClosePatch(const Napi::CallbackInfo &info);
+  Napi::Value OpenPatchAsync(const Napi::CallbackInfo &info);
+  Napi::Value ClosePatchAsync(const Napi::CallbackInfo &info);
+  Napi::Value CreatePatchPool(const Napi::CallbackInfo &info);
+  Napi::Value GrowPatchPool(const Napi::CallbackInfo &info);
+  Napi::Value AcquirePatch(const Napi::CallbackInfo &info);
+  Napi::Value ReleasePatch(const Napi::CallbackInfo &info);
+  Napi::Value PatchPoolAvailable(const Napi::CallbackInfo &info);
+  Napi::Value DestroyPatchPool(const Napi::CallbackInfo &info);
   Napi::Value AddToSearchPath(const Napi::CallbackInfo &info);
   Napi::Value ClearSearchPath(const Napi::CallbackInfo &info);
+  Napi::Value EnablePatchCache(const Napi::CallbackInfo &info);
+  Napi::Value ClearPatchCache(const Napi::CallbackInfo &info);
+  Napi::Value GetPatchCacheStats(const Napi::CallbackInfo &info);
 
   Napi::Value CurrentTime(const Napi::CallbackInfo &info);
   Napi::Value Send(const Napi::CallbackInfo &info);
   Napi::Value Subscribe(const Napi::CallbackInfo &info);
   Napi::Value Unsubscribe(const Napi::CallbackInfo &info);
+  Napi::Value Mailbox(const Napi::CallbackInfo &info);
+  Napi::Value CloseMailbox(const Napi::CallbackInfo &info);
 
   Napi::Value WriteArray(const Napi::CallbackInfo &info);
+  Napi::Value WriteArrayAtomic(const Napi::CallbackInfo &info);
   Napi::Value ArraySize(const Napi::CallbackInfo &info);
   Napi::Value ReadArray(const Napi::CallbackInfo &info);
+  Napi::Value ReadArrays(const Napi::CallbackInfo &info);
   Napi::Value ClearArray(const Napi::CallbackInfo &info);
+  Napi::Value WriteArrayAsync(const Napi::CallbackInfo &info);
+  Napi::Value ReadArrayAsync(const Napi::CallbackInfo &info);
+  Napi::Value LoadSoundfile(const Napi::CallbackInfo &info);
+  Napi::Value ArrayView(const Napi::CallbackInfo &info);
+  Napi::Value ArrayViewGeneration(const Napi::CallbackInfo &info);
+  Napi::Value TrackArrayChanges(const Napi::CallbackInfo &info);
+  Napi::Value UntrackArrayChanges(const Napi::CallbackInfo &info);
+  Napi::Value ReadArrayChanges(const Napi::CallbackInfo &info);
 
   Napi::Value StartGUI(const Napi::CallbackInfo &info);
   Napi::Value PollGUI(const Napi::CallbackInfo &info);
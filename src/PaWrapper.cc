@@ -1,87 +1,261 @@
 #include "./PaWrapper.h"
 
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+#include "./Interleave.h"
+#include "./MemoryLock.h"
+
 namespace node_lib_pd {
 
-PaWrapper::PaWrapper() : currentTime(0), paInitErr_(Pa_Initialize()) {}
+PaWrapper::PaWrapper(LogRing *logRing)
+    : currentTime(0), started(false), paInitializeDuration(0),
+      streamOpenDuration(0), firstCallbackDuration(0), inputDevice(paNoDevice),
+      outputDevice(paNoDevice), hostApi(-1), logRing_(logRing),
+      paInitialized_(false), paInitErr_(paNotInitialized), paStream_(NULL),
+      defaultInputDevice_(paNoDevice), defaultOutputDevice_(paNoDevice),
+      useBlockAdapter_(false), offline_(false), offlineRunning_(false) {}
 
 PaWrapper::~PaWrapper() {
 #ifdef DEBUG
   std::cout << "[node-libpd] closing portaudio stream" << std::endl;
 #endif
 
-  if (this->paInitErr_ == paNoError) {
+  if (this->offline_) {
+    this->stopStream();
+  }
+
+  if (this->paInitialized_) {
     PaError err = this->closeStream();
     if (err != paNoError) {
-      std::cout << "[node-libpd] failed to close portaudio stream"
-                << std::endl;
+      this->logRing_->push(LogLevel::ERROR, "portaudio",
+                           "failed to close portaudio stream");
+    }
+
+    Pa_Terminate();
+  }
+}
+
+bool PaWrapper::initialize() {
+  if (!this->paInitialized_) {
+    auto start = std::chrono::steady_clock::now();
+    this->paInitErr_ = Pa_Initialize();
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    this->paInitializeDuration = elapsed.count();
+
+    this->paInitialized_ = this->paInitErr_ == paNoError;
+
+    if (this->paInitialized_) {
+      this->cacheDevices_();
+    }
+  }
+
+  return this->paInitialized_;
+}
+
+bool PaWrapper::refreshDevices() {
+  if (this->paStream_ != NULL) {
+    return false;
+  }
+
+  if (this->paInitialized_) {
+    Pa_Terminate();
+    this->paInitialized_ = false;
+    this->devices_.clear();
+  }
+
+  return this->initialize();
+}
+
+void PaWrapper::cacheDevices_() {
+  const int numDevices = Pa_GetDeviceCount();
+  this->devices_.clear();
+
+  for (int i = 0; i < numDevices; i++) {
+    const PaDeviceInfo *deviceInfo = Pa_GetDeviceInfo(i);
+
+    // keep indices aligned with portaudio ones
+    if (deviceInfo == NULL) {
+      break;
     }
+
+    this->devices_.push_back(*deviceInfo);
   }
+
+  this->defaultInputDevice_ = Pa_GetDefaultInputDevice();
+  this->defaultOutputDevice_ = Pa_GetDefaultOutputDevice();
 }
 
-bool PaWrapper::init(audio_config_t *audioConfig, pd::PdBase *pd) {
+bool PaWrapper::init(audio_config_t *audioConfig, pd::PdBase *pd,
+                     TickScheduler *tickScheduler) {
   this->audioConfig_ = audioConfig;
   this->pd_ = pd;
+  this->tickScheduler_ = tickScheduler;
+  this->started = false;
+  this->audioStats.reset();
+  this->dspLoad.reset();
+  this->dspThread.applied = false;
+  this->inputDevice = paNoDevice;
+  this->outputDevice = paNoDevice;
 
   const int numInputChannels = audioConfig->numInputChannels;
   const int numOutputChannels = audioConfig->numOutputChannels;
   const int sampleRate = audioConfig->sampleRate;
   const int framesPerBuffer = audioConfig->framesPerBuffer;
 
-  if (this->paInitErr_ != paNoError) {
-    std::cout << "An error occured while using the portaudio stream"
-              << std::endl;
-    std::cout << "Error number: " << this->paInitErr_ << std::endl;
-    std::cout << "Error message: " << Pa_GetErrorText(this->paInitErr_)
-              << std::endl;
+  this->offline_ = audioConfig->backend == BACKEND_OFFLINE;
+
+  if (!this->offline_ && !this->initialize()) {
+    this->logError_("Failed to initialize portaudio", this->paInitErr_);
     return false;
   }
 
-  std::cout << "------------------------------------------------" << std::endl;
-  std::cout << ">>> Config:" << std::endl;
-  std::cout << "numInputChannels: " << audioConfig->numInputChannels
-            << std::endl;
-  std::cout << "numOutputChannels: " << audioConfig->numOutputChannels
-            << std::endl;
-  std::cout << "sampleRate: " << audioConfig->sampleRate << std::endl;
-  std::cout << "blockSize: " << audioConfig->blockSize << std::endl;
-  std::cout << "ticks: " << audioConfig->ticks << std::endl;
-  std::cout << "framesPerBuffer: " << audioConfig->framesPerBuffer << std::endl;
-  std::cout.precision(9);
-  std::cout << "bufferDuration: " << std::fixed << audioConfig->bufferDuration
-            << std::endl;
+  // summary of the stream, logged at once as a debug line
+  std::ostringstream config;
+  config << "numInputChannels: " << audioConfig->numInputChannels
+         << ", numOutputChannels: " << audioConfig->numOutputChannels
+         << ", sampleRate: " << audioConfig->sampleRate
+         << ", blockSize: " << audioConfig->blockSize
+         << ", ticks: " << audioConfig->ticks
+         << ", framesPerBuffer: " << audioConfig->framesPerBuffer;
+  config.precision(9);
+  config << ", bufferDuration: " << std::fixed << audioConfig->bufferDuration;
 
   PaStreamParameters inputParameters;
   PaStreamParameters outputParameters;
 
+  if (this->offline_) {
+    config << ", backend: offline" << (audioConfig->realtime ? "" : " (non realtime)");
+  } else if (!this->setupDevices_(config, inputParameters, outputParameters)) {
+    return false;
+  }
+
+  // pd only processes whole blocks, adapt other (or variable) host buffer
+  // sizes through intermediate FIFOs
+  this->useBlockAdapter_ =
+      framesPerBuffer == paFramesPerBufferUnspecified ||
+      framesPerBuffer % audioConfig->blockSize != 0;
+
+  if (this->useBlockAdapter_) {
+    this->blockAdapter_.setup(audioConfig->blockSize, numInputChannels,
+                              numOutputChannels);
+    config << ", blockAdapter: enabled";
+  }
+
+  // non-interleaved buffers for `libpd_process_raw`
+  if (audioConfig->processRaw) {
+    this->rawInput_.assign(audioConfig->blockSize * numInputChannels, 0.f);
+    this->rawOutput_.assign(audioConfig->blockSize * numOutputChannels, 0.f);
+    config << ", processRaw: " << interleave::implementation();
+  }
+
+  PaError err;
+  auto openStart = std::chrono::steady_clock::now();
+
+  err = this->openStream(
+    audioConfig->numInputChannels > 0 ? &inputParameters : NULL,
+    audioConfig->numOutputChannels > 0 ? &outputParameters : NULL, 
+    sampleRate,
+    framesPerBuffer
+  );
+
+  if (err != paNoError) {
+    this->logError_("Failed to open stream", err);
+    return false;
+  }
+
+  const PaDeviceIndex usedDevice = this->outputDevice != paNoDevice
+                                       ? this->outputDevice
+                                       : this->inputDevice;
+  const PaDeviceInfo *usedDeviceInfo =
+      this->offline_ ? NULL : Pa_GetDeviceInfo(usedDevice);
+  this->hostApi = usedDeviceInfo != NULL ? usedDeviceInfo->hostApi : -1;
+
+  const PaStreamInfo *streamInfo = Pa_GetStreamInfo(this->paStream_);
+
+  if (streamInfo != NULL) {
+    config << ", achieved inputLatency: " << streamInfo->inputLatency
+           << ", achieved outputLatency: " << streamInfo->outputLatency;
+  }
+
+  this->logRing_->push(LogLevel::DEBUG, "portaudio", config.str());
+
+  this->streamStartTime_ = std::chrono::steady_clock::now();
+  err = this->startStream(); // Pa_StartStream(this->paStream_);
+
+  std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - openStart;
+  this->streamOpenDuration = elapsed.count();
+
+  if (err != paNoError) {
+    this->logError_("Failed to start stream", err);
+  }
+
+  return true;
+}
+
+bool PaWrapper::setupDevices_(std::ostringstream &config,
+                              PaStreamParameters &inputParameters,
+                              PaStreamParameters &outputParameters) {
+  const int numInputChannels = this->audioConfig_->numInputChannels;
+  const int numOutputChannels = this->audioConfig_->numOutputChannels;
+  audio_config_t *audioConfig = this->audioConfig_;
+
+  // host API preference, used to pick the default devices
+  const int hostApi = audioConfig->hostApi;
+  const PaHostApiInfo *hostApiInfo = NULL;
+
+  if (hostApi != -1) {
+    hostApiInfo = Pa_GetHostApiInfo(hostApi);
+
+    if (hostApiInfo == NULL) {
+      this->logRing_->push(LogLevel::ERROR, "portaudio", "Unknown host API");
+      return false;
+    }
+
+    config << ", hostApi: " << hostApiInfo->name;
+  }
+
   // -------------------------------------------------------------
   // INPUT PARAMETERS
   // -------------------------------------------------------------
 
   if (numInputChannels > 0) {
-    PaDeviceIndex index = Pa_GetDefaultInputDevice();
+    PaDeviceIndex index = audioConfig->inputDevice;
+
+    if (index == -1) {
+      index = hostApiInfo != NULL ? hostApiInfo->defaultInputDevice
+                                  : Pa_GetDefaultInputDevice();
+    }
 
     inputParameters.device = index;
 
     if (inputParameters.device == paNoDevice) {
-      std::cout << "[Error] No input device found" << std::endl;
+      this->logRing_->push(LogLevel::ERROR, "portaudio",
+                           "No input device found");
       return false;
     }
 
     const PaDeviceInfo *pInputInfo = Pa_GetDeviceInfo(index);
 
-    if (pInputInfo != 0) {
-      std::cout << "" << std::endl;
-      std::cout << ">>> Input:" << std::endl;
-      std::cout << "Input device name: " << pInputInfo->name << std::endl;
-      std::cout << "DefaultLowInputLatency: "
-                << pInputInfo->defaultLowOutputLatency << std::endl;
-      std::cout << "DefaultHighInputLatency: "
-                << pInputInfo->defaultHighOutputLatency << std::endl;
+    if (pInputInfo == NULL) {
+      this->logRing_->push(LogLevel::ERROR, "portaudio",
+                           "Invalid input device: " + std::to_string(index));
+      return false;
     }
 
+    config << ", input device: " << pInputInfo->name
+           << " (low latency: " << pInputInfo->defaultLowInputLatency
+           << ", high latency: " << pInputInfo->defaultHighInputLatency << ")";
+
+    this->inputDevice = index;
     inputParameters.channelCount = numInputChannels;
     inputParameters.sampleFormat = paFloat32;
-    inputParameters.suggestedLatency = pInputInfo->defaultLowOutputLatency;
+    inputParameters.suggestedLatency =
+        audioConfig->inputLatency >= 0 ? audioConfig->inputLatency
+                                       : pInputInfo->defaultLowInputLatency;
     inputParameters.hostApiSpecificStreamInfo = NULL;
   }
 
@@ -90,62 +264,51 @@ bool PaWrapper::init(audio_config_t *audioConfig, pd::PdBase *pd) {
   // -------------------------------------------------------------
 
   if (numOutputChannels > 0) {
-    PaDeviceIndex index = Pa_GetDefaultOutputDevice();
+    PaDeviceIndex index = audioConfig->outputDevice;
+
+    if (index == -1) {
+      index = hostApiInfo != NULL ? hostApiInfo->defaultOutputDevice
+                                  : Pa_GetDefaultOutputDevice();
+    }
 
     outputParameters.device = index;
 
     if (outputParameters.device == paNoDevice) {
-      std::cout << "[Error] No output device found" << std::endl;
+      this->logRing_->push(LogLevel::ERROR, "portaudio",
+                           "No output device found");
       return false;
     }
 
     const PaDeviceInfo *pOutputInfo = Pa_GetDeviceInfo(index);
 
-    if (pOutputInfo != 0) {
-      std::cout << std::endl;
-      std::cout << ">>> Ouput:" << std::endl;
-      std::cout << "Output device name: " << pOutputInfo->name << std::endl;
-      std::cout << "DefaultLowOutputLatency: "
-                << pOutputInfo->defaultLowOutputLatency << std::endl;
-      std::cout << "DefaultHighOutputLatency: "
-                << pOutputInfo->defaultHighOutputLatency << std::endl;
+    if (pOutputInfo == NULL) {
+      this->logRing_->push(LogLevel::ERROR, "portaudio",
+                           "Invalid output device: " + std::to_string(index));
+      return false;
     }
 
-    outputParameters.channelCount = numOutputChannels; 
+    config << ", output device: " << pOutputInfo->name
+           << " (low latency: " << pOutputInfo->defaultLowOutputLatency
+           << ", high latency: " << pOutputInfo->defaultHighOutputLatency << ")";
+
+    this->outputDevice = index;
+    outputParameters.channelCount = numOutputChannels;
     outputParameters.sampleFormat = paFloat32;
-    outputParameters.suggestedLatency = pOutputInfo->defaultLowOutputLatency;
+    outputParameters.suggestedLatency =
+        audioConfig->outputLatency >= 0 ? audioConfig->outputLatency
+                                        : pOutputInfo->defaultLowOutputLatency;
     outputParameters.hostApiSpecificStreamInfo = NULL;
   }
 
-  std::cout << "------------------------------------------------" << std::endl;
-
-  PaError err;
-
-  err = this->openStream(
-    audioConfig->numInputChannels > 0 ? &inputParameters : NULL,
-    audioConfig->numOutputChannels > 0 ? &outputParameters : NULL, 
-    sampleRate,
-    framesPerBuffer
-  );
-
-  if (err != paNoError) {
-    std::cout << "[Error] Failed to open stream" << std::endl;
-    std::cout << "Error number: " << err << std::endl;
-    std::cout << "Error message: " << Pa_GetErrorText(err) << std::endl;
-    return false;
-  }
-
-  err = this->startStream(); // Pa_StartStream(this->paStream_);
-
-  if (err != paNoError) {
-    std::cout << "[Error] Failed to start stream" << std::endl;
-    std::cout << "Error number: " << err << std::endl;
-    std::cout << "Error message: " << Pa_GetErrorText(err) << std::endl;
-  }
-
   return true;
 }
 
+void PaWrapper::logError_(const std::string &message, PaError err) {
+  this->logRing_->push(LogLevel::ERROR, "portaudio",
+                       message + ": " + Pa_GetErrorText(err) + " (" +
+                           std::to_string(err) + ")");
+}
+
 // --------------------------------------------------------------------------
 // --------------------------------------------------------------------------
 //
@@ -156,15 +319,39 @@ bool PaWrapper::init(audio_config_t *audioConfig, pd::PdBase *pd) {
 
 PaStream *PaWrapper::getStream() { return this->paStream_; }
 
+bool PaWrapper::isActive() {
+  if (this->offline_) {
+    return this->offlineRunning_.load();
+  }
+
+  return this->paStream_ != NULL && Pa_IsStreamActive(this->paStream_) == 1;
+}
+
+bool PaWrapper::usesBlockAdapter() const { return this->useBlockAdapter_; }
+
+const PaStreamInfo *PaWrapper::getStreamInfo() {
+  if (this->paStream_ == NULL) {
+    return NULL;
+  }
+
+  return Pa_GetStreamInfo(this->paStream_);
+}
+
 PaError PaWrapper::openStream(PaStreamParameters *inputParameters, PaStreamParameters *outputParameters, int sampleRate, int framesPerBuffer) {
+  // the offline thread is created on start
+  if (this->offline_) {
+    return paNoError;
+  }
+
   return Pa_OpenStream(
       &this->paStream_,
       inputParameters,
       outputParameters, 
       sampleRate,
       framesPerBuffer,
-      paClipOff, // we won't output out of range samples so don't bother
-                 // clipping them
+      // defaults to paClipOff, we won't output out of range samples so
+      // don't bother clipping them
+      this->audioConfig_->streamFlags,
       &PaWrapper::paCallback,
       this // Using 'this' for userData so we can cast to LibPdWorker* in
            // paCallback method
@@ -172,50 +359,248 @@ PaError PaWrapper::openStream(PaStreamParameters *inputParameters, PaStreamParam
 }
 
 PaError PaWrapper::closeStream() {
-  return Pa_CloseStream(this->paStream_);
+  if (this->paStream_ == NULL) {
+    return paNoError;
+  }
+
+  PaError err = Pa_CloseStream(this->paStream_);
+  this->paStream_ = NULL;
+
+  return err;
 }
 
 PaError PaWrapper::startStream() {
+  if (this->offline_) {
+    if (!this->offlineRunning_.exchange(true)) {
+      this->offlineThread_ = std::thread(&PaWrapper::runOffline_, this);
+    }
+
+    return paNoError;
+  }
+
   return Pa_StartStream(this->paStream_);
 }
 
 PaError PaWrapper::stopStream() {
+  if (this->offline_) {
+    this->offlineRunning_ = false;
+
+    if (this->offlineThread_.joinable()) {
+      this->offlineThread_.join();
+    }
+
+    return paNoError;
+  }
+
   return Pa_StopStream(this->paStream_);
 }
 
+/**
+ * Offline backend: drive the audio callback with silent input from our own
+ * thread, at the pace of the sample rate or as fast as possible when
+ * `realtime` is false (e.g. benchmarks or tests on machines without any
+ * audio device).
+ */
+void PaWrapper::runOffline_() {
+  const int blockSize = this->audioConfig_->blockSize;
+  int framesPerBuffer = this->audioConfig_->framesPerBuffer;
+
+  if (framesPerBuffer <= 0) {
+    framesPerBuffer = blockSize * this->audioConfig_->ticks;
+  }
+
+  std::vector<float> input(
+      framesPerBuffer * this->audioConfig_->numInputChannels, 0.f);
+  std::vector<float> output(
+      framesPerBuffer * this->audioConfig_->numOutputChannels, 0.f);
+
+  const std::chrono::nanoseconds period((int64_t)(
+      (double)framesPerBuffer / this->audioConfig_->sampleRate * 1e9));
+  auto deadline = std::chrono::steady_clock::now();
+
+  while (this->offlineRunning_.load()) {
+    // input is never written by pd, only clear the output
+    std::fill(output.begin(), output.end(), 0.f);
+
+    this->paCallbackMethod(input.empty() ? NULL : input.data(),
+                           output.empty() ? NULL : output.data(),
+                           framesPerBuffer, NULL, 0);
+
+    if (this->audioConfig_->realtime) {
+      deadline += period;
+      std::this_thread::sleep_until(deadline);
+    }
+  }
+}
+
 
 /**
  * Get number of devices returned by `portaudio`.
  */
-int PaWrapper::getDeviceCount() { return Pa_GetDeviceCount(); }
+int PaWrapper::getDeviceCount() {
+  this->initialize();
+  return this->devices_.size();
+}
 
 /**
  * Get `portaudio` default input device index.
  */
-PaDeviceIndex PaWrapper::getDefaultInputDevice() { return Pa_GetDefaultInputDevice(); }
+PaDeviceIndex PaWrapper::getDefaultInputDevice() {
+  this->initialize();
+  return this->defaultInputDevice_;
+}
 
 /**
  * Get `portaudio` default output device index.
  */
-PaDeviceIndex PaWrapper::getDefaultOutputDevice() { return Pa_GetDefaultOutputDevice(); }
+PaDeviceIndex PaWrapper::getDefaultOutputDevice() {
+  this->initialize();
+  return this->defaultOutputDevice_;
+}
 
 /**
- * Get audio device at specific index from `portaudio`.
+ * Get audio device at specific index from the cached device list.
  */
 const PaDeviceInfo *PaWrapper::getDeviceAtIndex(int index) {
-  return Pa_GetDeviceInfo(index);
+  this->initialize();
+
+  if (index < 0 || index >= (int)this->devices_.size()) {
+    return NULL;
+  }
+
+  return &this->devices_[index];
+}
+
+PaHostApiIndex PaWrapper::findHostApi(const std::string &name) {
+  if (!this->initialize()) {
+    return -1;
+  }
+
+  auto lower = [](std::string str) {
+    std::transform(str.begin(), str.end(), str.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    return str;
+  };
+
+  const std::string needle = lower(name);
+  const PaHostApiIndex numHostApis = Pa_GetHostApiCount();
+
+  for (PaHostApiIndex i = 0; i < numHostApis; i++) {
+    const PaHostApiInfo *hostApiInfo = Pa_GetHostApiInfo(i);
+
+    if (hostApiInfo != NULL && lower(hostApiInfo->name) == needle) {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+void PaWrapper::processTicks_(int ticks, const float *in, float *out) {
+  if (!this->audioConfig_->processRaw) {
+    this->pd_->processFloat(ticks, in, out);
+    return;
+  }
+
+  const int blockSize = this->audioConfig_->blockSize;
+  const int numInputChannels = this->audioConfig_->numInputChannels;
+  const int numOutputChannels = this->audioConfig_->numOutputChannels;
+
+  for (int i = 0; i < ticks; i++) {
+    if (in != NULL && numInputChannels > 0) {
+      interleave::deinterleave(in + i * blockSize * numInputChannels,
+                               this->rawInput_.data(), numInputChannels,
+                               blockSize);
+    }
+
+    this->pd_->processRaw(this->rawInput_.data(), this->rawOutput_.data());
+
+    if (out != NULL && numOutputChannels > 0) {
+      interleave::interleave(this->rawOutput_.data(),
+                             out + i * blockSize * numOutputChannels,
+                             numOutputChannels, blockSize);
+    }
+  }
 }
 
 int PaWrapper::paCallbackMethod(const void *inputBuffer, void *outputBuffer,
                                 unsigned long framesPerBuffer,
                                 const PaStreamCallbackTimeInfo *timeInfo,
                                 PaStreamCallbackFlags statusFlags) {
+  // the callback thread is owned by portaudio, configure it from the inside
+  if (!this->dspThread.applied.load(std::memory_order_relaxed)) {
+    applyThreadSettings(this->audioConfig_->dspThread, this->dspThread);
+
+    if (this->audioConfig_->lockMemory) {
+      MemoryLock::prefaultStack();
+    }
+  }
+
+  this->audioStats.record(statusFlags, framesPerBuffer, this->currentTime);
+
+  const auto processStart = std::chrono::steady_clock::now();
+
   float *in = (float *)inputBuffer;
   float *out = (float *)outputBuffer;
+  const int ticks = this->audioConfig_->ticks;
+
+  if (this->useBlockAdapter_) {
+    // host buffers are not made of whole pd blocks, run one tick each time
+    // the adapter has accumulated a full block of input
+    const int numInputChannels = this->audioConfig_->numInputChannels;
+    const int numOutputChannels = this->audioConfig_->numOutputChannels;
+    const double sampleRate = (double)this->audioConfig_->sampleRate;
+    unsigned long offset = 0;
+
+    while (offset < framesPerBuffer) {
+      offset += this->blockAdapter_.exchange(
+          in != NULL ? in + offset * numInputChannels : NULL,
+          out != NULL ? out + offset * numOutputChannels : NULL,
+          framesPerBuffer - offset);
+
+      if (this->blockAdapter_.ready()) {
+        if (this->tickScheduler_->hasPending()) {
+          this->tickScheduler_->process(this->currentTime +
+                                        (double)offset / sampleRate);
+        }
+
+        this->processTicks_(1, this->blockAdapter_.inputBlock(),
+                            this->blockAdapter_.outputBlock());
+        this->blockAdapter_.rewind();
+      }
+    }
+  } else if (!this->tickScheduler_->hasPending()) {
+    this->processTicks_(ticks, in, out);
+  } else {
+    // process tick by tick to apply the tasks between ticks
+    const int blockSize = this->audioConfig_->blockSize;
+    const int inStride = blockSize * this->audioConfig_->numInputChannels;
+    const int outStride = blockSize * this->audioConfig_->numOutputChannels;
+    const double tickDuration =
+        (double)blockSize / (double)this->audioConfig_->sampleRate;
+
+    for (int i = 0; i < ticks; i++) {
+      this->tickScheduler_->process(this->currentTime + i * tickDuration);
+      this->processTicks_(1, in != NULL ? in + i * inStride : NULL,
+                          out != NULL ? out + i * outStride : NULL);
+    }
+  }
 
-  this->pd_->processFloat(this->audioConfig_->ticks, in, out);
-  this->currentTime +=
+  const std::chrono::nanoseconds processDuration =
+      std::chrono::steady_clock::now() - processStart;
+  const double bufferDuration =
       (double)framesPerBuffer / (double)this->audioConfig_->sampleRate;
+  this->dspLoad.record((uint64_t)processDuration.count(),
+                       (uint64_t)(bufferDuration * 1e9));
+
+  this->currentTime += bufferDuration;
+
+  if (!this->started.load(std::memory_order_relaxed)) {
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - this->streamStartTime_;
+    this->firstCallbackDuration = elapsed.count();
+    this->started = true;
+  }
 
   return paContinue;
 }
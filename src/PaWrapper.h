@@ -1,5 +1,17 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "./AudioStats.h"
+#include "./BlockAdapter.h"
+#include "./DspLoad.h"
+#include "./LogRing.h"
+#include "./TickScheduler.h"
 #include "./types.h"
 #include "libpd/PdBase.hpp"
 #include "portaudio.h"
@@ -13,42 +25,155 @@ namespace node_lib_pd {
  */
 class PaWrapper {
 public:
-  PaWrapper();
+  PaWrapper(LogRing *logRing);
   ~PaWrapper();
 
   /**
    * init the port audio stream and store the informations needed in audio
    * callback
    */
-  bool init(audio_config_t *audioConfig, pd::PdBase *pd);
+  bool init(audio_config_t *audioConfig, pd::PdBase *pd,
+            TickScheduler *tickScheduler);
   // void clear();
+
+  /**
+   * initialize portaudio on first call, so that devices are not probed
+   * until a realtime stream or a device list is requested
+   */
+  bool initialize();
+
+  /**
+   * initialize portaudio again to discover new devices, fails if a stream
+   * is opened
+   */
+  bool refreshDevices();
+
   PaDeviceIndex getDefaultInputDevice();
   PaDeviceIndex getDefaultOutputDevice();
   int getDeviceCount();
   const PaDeviceInfo *getDeviceAtIndex(int index);
 
+  /**
+   * index of the host API whose name matches `name` (case insensitive),
+   * -1 if not found
+   */
+  PaHostApiIndex findHostApi(const std::string &name);
+
+  /**
+   * latencies and sample rate achieved by the opened stream, NULL if no
+   * stream is opened
+   */
+  const PaStreamInfo *getStreamInfo();
+
   PaError openStream(PaStreamParameters *inputParameters, PaStreamParameters *outputParameters, int sampleRate, int framesPerBuffer);
   PaError closeStream();
   PaError startStream();
   PaError stopStream();
 
   /**
-   * accessor for the PaStream
+   * accessor for the PaStream, NULL with the offline backend
    */
   PaStream *getStream();
 
+  /**
+   * true while the stream (or the offline thread) is running
+   */
+  bool isActive();
+
   /**
    * last `Pa::timeInfo->outputBufferDacTime`
    */
   double currentTime;
 
+  /**
+   * true once the first audio callback has returned
+   */
+  std::atomic<bool> started;
+
+  /**
+   * durations (in ms) of `Pa_Initialize`, of opening and starting the stream
+   * and between the start of the stream and the end of the first callback
+   */
+  double paInitializeDuration;
+  double streamOpenDuration;
+  std::atomic<double> firstCallbackDuration;
+
+  /**
+   * devices and host API used by the opened stream (paNoDevice if unused)
+   */
+  PaDeviceIndex inputDevice;
+  PaDeviceIndex outputDevice;
+  PaHostApiIndex hostApi;
+
+  /**
+   * status flags and xruns reported to the audio callback
+   */
+  AudioStats audioStats;
+
+  /**
+   * processing time of the audio callback relative to the buffer duration
+   */
+  DspLoad dspLoad;
+
+  /**
+   * scheduling of the audio callback thread, applied on first callback
+   */
+  thread_report_t dspThread;
+
+  /**
+   * true if the host buffers are adapted to pd blocks, which adds one block
+   * of latency
+   */
+  bool usesBlockAdapter() const;
+
 private:
+  void logError_(const std::string &message, PaError err);
+
+  LogRing *logRing_;
   audio_config_t *audioConfig_;
   pd::PdBase *pd_;
+  TickScheduler *tickScheduler_;
 
+  bool paInitialized_;
   PaError paInitErr_;
   PaStream *paStream_;
 
+  // device list cached at initialization, valid until `Pa_Terminate`
+  std::vector<PaDeviceInfo> devices_;
+  PaDeviceIndex defaultInputDevice_;
+  PaDeviceIndex defaultOutputDevice_;
+
+  void cacheDevices_();
+
+  // used when the host buffer size is not a multiple of the pd block size
+  bool useBlockAdapter_;
+  BlockAdapter blockAdapter_;
+
+  // non-interleaved pd buffers used when `processRaw` is set
+  std::vector<float> rawInput_;
+  std::vector<float> rawOutput_;
+
+  /**
+   * process `ticks` pd blocks from and to interleaved buffers, either with
+   * `libpd_process_float` or with `libpd_process_raw` and simd conversions
+   */
+  void processTicks_(int ticks, const float *in, float *out);
+
+  std::chrono::steady_clock::time_point streamStartTime_;
+
+  // offline backend
+  bool offline_;
+  std::atomic<bool> offlineRunning_;
+  std::thread offlineThread_;
+  void runOffline_();
+
+  /**
+   * pick the host API and devices, fill the stream parameters
+   */
+  bool setupDevices_(std::ostringstream &config,
+                     PaStreamParameters &inputParameters,
+                     PaStreamParameters &outputParameters);
+
   /**
    * The instance callback, where we have access to every method/variable in
    * object of class Sine
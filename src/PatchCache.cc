@@ -0,0 +1,163 @@
+#include "./PatchCache.h"
+
+#include <fstream>
+#include <iterator>
+#include <sys/stat.h>
+
+// not exposed by m_pd.h
+extern "C" {
+  void pd_doloadbang(void);
+  void canvas_initbang(t_canvas *x);
+  extern t_class *canvas_class;
+}
+
+namespace node_lib_pd {
+
+patch_source_s::patch_source_s(t_binbuf *binbuf, const std::string &filename,
+                               const std::string &path)
+  : binbuf(binbuf)
+  , filename(filename)
+  , path(path)
+{}
+
+patch_source_s::~patch_source_s() {
+  binbuf_free(this->binbuf);
+}
+
+PatchCache::PatchCache() {}
+
+PatchCache::~PatchCache() {
+  this->clear();
+}
+
+patch_source_ptr PatchCache::load(const std::string &filename,
+                                  const std::string &path) {
+  const std::string pathname = path + "/" + filename;
+  struct stat st;
+
+  if (stat(pathname.c_str(), &st) != 0) {
+    return nullptr;
+  }
+
+#ifdef __APPLE__
+  const int64_t mtime = (int64_t)st.st_mtimespec.tv_sec * 1000000000 +
+                        st.st_mtimespec.tv_nsec;
+#else
+  const int64_t mtime = (int64_t)st.st_mtim.tv_sec * 1000000000 +
+                        st.st_mtim.tv_nsec;
+#endif
+  const int64_t size = st.st_size;
+
+  std::lock_guard<std::mutex> lock(this->mutex_);
+  auto search = this->entries_.find(pathname);
+
+  if (search != this->entries_.end()) {
+    if (search->second.mtime == mtime && search->second.size == size) {
+      this->stats_.hits += 1;
+      return search->second.source;
+    }
+
+    // file changed on disk, tasks holding the old source keep it alive
+    this->entries_.erase(search);
+    this->stats_.invalidations += 1;
+  }
+
+  this->stats_.misses += 1;
+
+  patch_source_ptr source = PatchCache::read_(filename, path);
+
+  if (source) {
+    this->entries_[pathname] = { source, mtime, size };
+  }
+
+  this->stats_.entries = this->entries_.size();
+
+  return source;
+}
+
+void *PatchCache::instantiate(const patch_source_t &source) {
+  // same as `glob_evalfile` and `binbuf_evalfile`, except that the content
+  // is already parsed
+  sys_lock();
+
+  t_pd *x = NULL;
+  int dspstate = canvas_suspend_dsp();
+  t_pd *boundx = s__X.s_thing;
+  s__X.s_thing = NULL;
+
+  glob_setfilename(NULL, gensym(source.filename.c_str()),
+                   gensym(source.path.c_str()));
+
+  // `#N canvas` lines create the canvases through `pd_canvasmaker`, the
+  // bindings of #N and #A are restored afterward
+  t_symbol *s__A = gensym("#A");
+  t_pd *bounda = s__A->s_thing;
+  t_pd *boundn = s__N.s_thing;
+  s__A->s_thing = NULL;
+  s__N.s_thing = &pd_canvasmaker;
+
+  binbuf_eval(source.binbuf, NULL, 0, NULL);
+
+  if (s__X.s_thing && *s__X.s_thing == canvas_class) {
+    canvas_initbang((t_canvas *)s__X.s_thing);
+  }
+
+  s__A->s_thing = bounda;
+  s__N.s_thing = boundn;
+
+  glob_setfilename(NULL, &s_, &s_);
+
+  while (x != s__X.s_thing && s__X.s_thing) {
+    x = s__X.s_thing;
+    pd_vmess(x, gensym("pop"), (char *)"i", 1);
+  }
+
+  pd_doloadbang();
+  canvas_resume_dsp(dspstate);
+  s__X.s_thing = boundx;
+
+  sys_unlock();
+
+  return x;
+}
+
+void PatchCache::clear() {
+  std::lock_guard<std::mutex> lock(this->mutex_);
+
+  this->entries_.clear();
+  this->stats_.entries = 0;
+}
+
+patch_cache_stats_t PatchCache::stats() {
+  std::lock_guard<std::mutex> lock(this->mutex_);
+  return this->stats_;
+}
+
+// same as `binbuf_read`, except that the file is read outside the pd lock,
+// which is only taken to parse the text as it interns symbols
+patch_source_ptr PatchCache::read_(const std::string &filename,
+                                   const std::string &path) {
+  const std::string pathname = path + "/" + filename;
+  std::ifstream file(pathname, std::ios::in | std::ios::binary);
+
+  if (!file) {
+    return nullptr;
+  }
+
+  std::string text((std::istreambuf_iterator<char>(file)),
+                   std::istreambuf_iterator<char>());
+
+  if (file.bad()) {
+    return nullptr;
+  }
+
+  t_binbuf *binbuf = binbuf_new();
+
+  sys_lock();
+  binbuf_text(binbuf, text.c_str(), text.size());
+  sys_unlock();
+
+  return std::make_shared<patch_source_t>(binbuf, filename, path);
+}
+
+}; // namespace
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <ctime>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "PdBase.hpp"
+
+namespace node_lib_pd {
+
+typedef struct patch_cache_stats_s {
+  long hits = 0;
+  long misses = 0;
+  long invalidations = 0;
+  int entries = 0;
+} patch_cache_stats_t;
+
+/**
+ * Parsed content of a patch file. The binbuf is freed with the last
+ * reference, which must not be released from the audio thread.
+ */
+typedef struct patch_source_s {
+  patch_source_s(t_binbuf *binbuf, const std::string &filename,
+                 const std::string &path);
+  ~patch_source_s();
+
+  t_binbuf *binbuf;
+  const std::string filename;
+  const std::string path;
+} patch_source_t;
+
+typedef std::shared_ptr<patch_source_t> patch_source_ptr;
+
+/**
+ * In memory cache of the parsed content of the patch files, so that opening
+ * the same patch several times (e.g. voices) does not read and parse the
+ * file again. An entry is invalidated when the modification time or the size
+ * of the file change.
+ *
+ * Files are read and parsed by `load` on the calling thread, the audio
+ * thread only evaluates an already parsed source with `instantiate`.
+ */
+class PatchCache {
+  public:
+    PatchCache();
+    ~PatchCache();
+
+    /**
+     * Get the parsed patch file from the cache, reading and parsing it if
+     * needed. Returns NULL if the file cannot be read. Does file I/O, must
+     * not be called from the audio thread.
+     */
+    patch_source_ptr load(const std::string &filename,
+                          const std::string &path);
+
+    /**
+     * Open an instance of a parsed patch as `libpd_openfile` does, returns
+     * the handle of the patch canvas. Only takes the pd lock, so it can be
+     * called from the audio thread.
+     */
+    static void *instantiate(const patch_source_t &source);
+
+    void clear();
+    patch_cache_stats_t stats();
+
+  private:
+    struct entry_t {
+      patch_source_ptr source;
+      int64_t mtime; // nanoseconds
+      int64_t size;
+    };
+
+    std::map<std::string, entry_t> entries_;
+    patch_cache_stats_t stats_;
+    std::mutex mutex_;
+
+    static patch_source_ptr read_(const std::string &filename,
+                                  const std::string &path);
+};
+
+}; // namespace
@@ -0,0 +1,35 @@
+#include "./PatchTasks.h"
+
+namespace node_lib_pd {
+
+OpenPatchTask::OpenPatchTask(PdWrapper *pdWrapper, const std::string &filename,
+                             const std::string &path)
+  : TickTask(0.)
+  , pdWrapper_(pdWrapper)
+  , filename_(filename)
+  , path_(path)
+{}
+
+void OpenPatchTask::prepare() {
+  this->source_ = this->pdWrapper_->readPatch(this->filename_, this->path_);
+}
+
+bool OpenPatchTask::process() {
+  this->patch =
+      this->pdWrapper_->loadPatch(this->source_, this->filename_, this->path_);
+
+  return true;
+}
+
+ClosePatchTask::ClosePatchTask(PdWrapper *pdWrapper, pd::Patch patch)
+  : TickTask(0.)
+  , pdWrapper_(pdWrapper)
+  , patch_(patch)
+{}
+
+bool ClosePatchTask::process() {
+  this->pdWrapper_->unloadPatch(this->patch_);
+  return true;
+}
+
+}; // namespace
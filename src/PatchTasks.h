@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+
+#include "./PdWrapper.h"
+#include "./TickScheduler.h"
+
+namespace node_lib_pd {
+
+/**
+ * Open an instance of a patch at a tick boundary. If the patch cache is
+ * enabled, the file is read and parsed by `prepare` before the task is
+ * scheduled, so that the audio thread only instantiates it, otherwise it is
+ * opened by libpd from the file. The patch is registered by the main thread
+ * once the task is done.
+ */
+class OpenPatchTask : public TickTask {
+  public:
+    OpenPatchTask(PdWrapper *pdWrapper, const std::string &filename,
+                  const std::string &path);
+
+    // must be called before the task is scheduled, not from the audio thread
+    void prepare();
+    bool process();
+
+    pd::Patch patch;
+
+  private:
+    PdWrapper *pdWrapper_;
+    std::string filename_;
+    std::string path_;
+    // released with the task, in the main thread
+    patch_source_ptr source_;
+};
+
+/**
+ * Close an instance of a patch at a tick boundary. The patch must have been
+ * unregistered by the main thread before the task is scheduled.
+ */
+class ClosePatchTask : public TickTask {
+  public:
+    ClosePatchTask(PdWrapper *pdWrapper, pd::Patch patch);
+
+    bool process();
+
+  private:
+    PdWrapper *pdWrapper_;
+    pd::Patch patch_;
+};
+
+}; // namespace
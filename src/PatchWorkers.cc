@@ -0,0 +1,155 @@
+#include "./PatchWorkers.h"
+
+namespace node_lib_pd {
+
+OpenPatchWorker::OpenPatchWorker(
+  Napi::Env env,
+  TickScheduler* tickScheduler,
+  PaWrapper* paWrapper,
+  TaskCompletions* completions,
+  PdWrapper* pdWrapper,
+  std::shared_ptr<OpenPatchTask> task,
+  std::function<void(Napi::Env)> onComplete)
+  : TickTaskWorker(env, "pd open patch", tickScheduler, paWrapper,
+                   completions, task)
+  , pdWrapper_(pdWrapper)
+  , openPatchTask_(task)
+  , onComplete_(onComplete)
+{}
+
+// read and parse the file in the worker thread
+bool OpenPatchWorker::Prepare_() {
+  this->openPatchTask_->prepare();
+  return true;
+}
+
+Napi::Value OpenPatchWorker::Result_(Napi::Env env) {
+  patch_infos_t patchInfos =
+      this->pdWrapper_->registerPatch(this->openPatchTask_->patch);
+
+  this->onComplete_(env);
+
+  // same object as returned by `openPatch`
+  Napi::Object patch = Napi::Object::New(env);
+
+  patch.Set("isValid", patchInfos.isValid);
+  patch.Set("filename", patchInfos.filename);
+  patch.Set("path", patchInfos.path);
+  patch.Set("$0", patchInfos.dollarZero);
+
+  return patch;
+}
+
+ClosePatchWorker::ClosePatchWorker(
+  Napi::Env env,
+  TickScheduler* tickScheduler,
+  PaWrapper* paWrapper,
+  TaskCompletions* completions,
+  std::shared_ptr<ClosePatchTask> task,
+  Napi::Object patch,
+  std::function<void(Napi::Env)> onComplete)
+  : TickTaskWorker(env, "pd close patch", tickScheduler, paWrapper,
+                   completions, task)
+  , patch_(Napi::Persistent(patch))
+  , onComplete_(onComplete)
+{}
+
+Napi::Value ClosePatchWorker::Result_(Napi::Env env) {
+  this->onComplete_(env);
+
+  Napi::Object patch = this->patch_.Value();
+  patch.Set("$0", 0);
+  patch.Set("isValid", false);
+
+  return patch;
+}
+
+GrowPatchPoolWorker::GrowPatchPoolWorker(
+  Napi::Env env,
+  PdWrapper* pdWrapper,
+  int poolId,
+  const std::string& filename,
+  const std::string& path,
+  int num,
+  std::function<void(Napi::Env)> onComplete)
+  : Napi::AsyncWorker(env, "pd grow patch pool")
+  , pdWrapper_(pdWrapper)
+  , poolId_(poolId)
+  , filename_(filename)
+  , path_(path)
+  , num_(num)
+  , onComplete_(onComplete)
+  , deferred_(Napi::Promise::Deferred::New(env))
+{}
+
+Napi::Promise GrowPatchPoolWorker::GetPromise() {
+  return this->deferred_.Promise();
+}
+
+void GrowPatchPoolWorker::Execute() {
+  // NULL if the patch cache is disabled, each instance is then opened from
+  // the file by libpd
+  patch_source_ptr source =
+      this->pdWrapper_->readPatch(this->filename_, this->path_);
+
+  // the pd lock is taken for each instance, so that the audio thread is
+  // only stalled for the instantiation of one patch at a time
+  for (int i = 0; i < this->num_; i++) {
+    pd::Patch patch =
+        this->pdWrapper_->loadPatch(source, this->filename_, this->path_);
+
+    if (!patch.isValid()) {
+      break;
+    }
+
+    this->patches_.push_back(patch);
+  }
+
+  // all or nothing, the instances are not registered yet
+  if ((int)this->patches_.size() < this->num_) {
+    for (pd::Patch &patch : this->patches_) {
+      this->pdWrapper_->unloadPatch(patch);
+    }
+
+    this->patches_.clear();
+    this->SetError("can't open patch " + this->filename_);
+  }
+}
+
+void GrowPatchPoolWorker::OnOK() {
+  Napi::HandleScope scope(Env());
+  Napi::Array result = Napi::Array::New(Env());
+
+  for (pd::Patch &pdPatch : this->patches_) {
+    patch_infos_t patchInfos = this->pdWrapper_->registerPatch(pdPatch);
+
+    // the pool has been destroyed in the meantime
+    if (!this->pdWrapper_->addToPatchPool(this->poolId_,
+                                          patchInfos.dollarZero)) {
+      this->pdWrapper_->closePatch(patchInfos.dollarZero);
+      continue;
+    }
+
+    // same object as returned by `openPatch`
+    Napi::Object patch = Napi::Object::New(Env());
+
+    patch.Set("isValid", patchInfos.isValid);
+    patch.Set("filename", patchInfos.filename);
+    patch.Set("path", patchInfos.path);
+    patch.Set("$0", patchInfos.dollarZero);
+
+    result.Set(result.Length(), patch);
+  }
+
+  this->onComplete_(Env());
+  this->deferred_.Resolve(result);
+}
+
+void GrowPatchPoolWorker::OnError(const Napi::Error& e) {
+  Napi::HandleScope scope(Env());
+  // instances may have been opened and closed in the meantime
+  this->onComplete_(Env());
+  this->deferred_.Reject(e.Value());
+}
+
+}; // namespace
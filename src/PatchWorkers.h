@@ -0,0 +1,104 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <napi.h>
+
+#include "./PatchTasks.h"
+#include "./PdWrapper.h"
+#include "./TickTaskWorker.h"
+
+namespace node_lib_pd {
+
+/**
+ * Open a patch at a tick boundary and resolve a Promise with the patch
+ * object, `onComplete` is called in the js thread once the patch is opened.
+ */
+class OpenPatchWorker : public TickTaskWorker
+{
+  public:
+    OpenPatchWorker(
+        Napi::Env env,
+        TickScheduler* tickScheduler,
+        PaWrapper* paWrapper,
+        TaskCompletions* completions,
+        PdWrapper* pdWrapper,
+        std::shared_ptr<OpenPatchTask> task,
+        std::function<void(Napi::Env)> onComplete);
+
+  protected:
+    bool Prepare_();
+    Napi::Value Result_(Napi::Env env);
+
+  private:
+    PdWrapper* pdWrapper_;
+    std::shared_ptr<OpenPatchTask> openPatchTask_;
+    std::function<void(Napi::Env)> onComplete_;
+};
+
+/**
+ * Close a patch at a tick boundary and resolve a Promise with the given
+ * patch object, `onComplete` is called in the js thread once the patch is
+ * closed.
+ */
+class ClosePatchWorker : public TickTaskWorker
+{
+  public:
+    ClosePatchWorker(
+        Napi::Env env,
+        TickScheduler* tickScheduler,
+        PaWrapper* paWrapper,
+        TaskCompletions* completions,
+        std::shared_ptr<ClosePatchTask> task,
+        Napi::Object patch,
+        std::function<void(Napi::Env)> onComplete);
+
+  protected:
+    Napi::Value Result_(Napi::Env env);
+
+  private:
+    Napi::ObjectReference patch_;
+    std::function<void(Napi::Env)> onComplete_;
+};
+
+/**
+ * Open new instances of a pooled patch in a worker thread, under the pd lock
+ * as `openPatch` does but without blocking the event loop nor instantiating
+ * anything in the audio callback. The instances are registered and added to
+ * the pool in the js thread, the Promise is resolved with their patch
+ * objects. The Promise is rejected, and no instance added, if any of them
+ * can't be opened.
+ */
+class GrowPatchPoolWorker : public Napi::AsyncWorker
+{
+  public:
+    GrowPatchPoolWorker(
+        Napi::Env env,
+        PdWrapper* pdWrapper,
+        int poolId,
+        const std::string& filename,
+        const std::string& path,
+        int num,
+        std::function<void(Napi::Env)> onComplete);
+
+    Napi::Promise GetPromise();
+
+    // This code will be executed on the worker thread
+    void Execute();
+    void OnOK();
+    void OnError(const Napi::Error& e);
+
+  private:
+    PdWrapper* pdWrapper_;
+    int poolId_;
+    std::string filename_;
+    std::string path_;
+    int num_;
+    std::function<void(Napi::Env)> onComplete_;
+    Napi::Promise::Deferred deferred_;
+    std::vector<pd::Patch> patches_;
+};
+
+}; // namespace
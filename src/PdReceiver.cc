@@ -1,8 +1,17 @@
 #include "./PdReceiver.h"
 
+#include <cmath>
+
 namespace node_lib_pd {
 
-PdReceiver::PdReceiver(LockedQueue<pd_msg_t> *msgQueue) : msgQueue_(msgQueue) {}
+PdReceiver::PdReceiver(LockedQueue<pd_msg_t> *msgQueue,
+                       LatencyTracer *latencyTracer,
+                       ChannelFilters *channelFilters,
+                       SubscriptionTable *subscriptions,
+                       Mailboxes *mailboxes, LogRing *logRing)
+    : msgQueue_(msgQueue), latencyTracer_(latencyTracer),
+      channelFilters_(channelFilters), subscriptions_(subscriptions),
+      mailboxes_(mailboxes), logRing_(logRing) {}
 
 PdReceiver::~PdReceiver() {}
 
@@ -11,30 +20,73 @@ void PdReceiver::print(const std::string &message) {
 #ifdef DEBUG
   std::cout << message << std::endl;
 #endif
-  auto ptr = std::make_shared<pd_msg_t>("print", message);
-  this->msgQueue_->push(ptr);
+  // kept apart from the control messages
+  this->logRing_->pushPd(message);
 }
 
 //--------------------------------------------------------------
 void PdReceiver::receiveBang(const std::string &channel) {
+  this->mailboxes_->write(channel, NULL, 0);
+
   auto ptr = std::make_shared<pd_msg_t>(channel);
-  this->msgQueue_->push(ptr);
+  this->push_(ptr);
 }
 
 void PdReceiver::receiveFloat(const std::string &channel, float num) {
+  this->mailboxes_->write(channel, &num, 1);
+
   auto ptr = std::make_shared<pd_msg_t>(channel, num);
-  this->msgQueue_->push(ptr);
+  this->push_(ptr);
 }
 
 void PdReceiver::receiveSymbol(const std::string &channel,
                                const std::string &symbol) {
   auto ptr = std::make_shared<pd_msg_t>(channel, symbol);
-  this->msgQueue_->push(ptr);
+  this->push_(ptr);
 }
 
 void PdReceiver::receiveList(const std::string &channel, const pd::List &list) {
+  if (!this->mailboxes_->empty()) {
+    float values[mailbox_t::MAX_VALUES];
+    int len = list.len();
+
+    if (len > mailbox_t::MAX_VALUES) {
+      len = mailbox_t::MAX_VALUES;
+    }
+
+    // symbols can't be polled
+    for (int i = 0; i < len; i++) {
+      values[i] = list.isFloat(i) ? list.getFloat(i) : NAN;
+    }
+
+    this->mailboxes_->write(channel, values, len);
+  }
+
   auto ptr = std::make_shared<pd_msg_t>(channel, list);
-  this->msgQueue_->push(ptr);
+  this->push_(ptr);
+}
+
+void PdReceiver::push_(std::shared_ptr<pd_msg_t> msg) {
+  // nobody would listen to the message in js
+  if (!this->subscriptions_->resolve(*msg)) {
+    return;
+  }
+
+  if (this->latencyTracer_->isEnabled()) {
+    msg->timestamp = LatencyTracer::now();
+    const uint64_t injected = this->latencyTracer_->takeInjected();
+
+    if (injected != 0) {
+      this->latencyTracer_->record(LatencyTracer::PD,
+                                   msg->timestamp - injected);
+    }
+  }
+
+  if (this->channelFilters_->filter(msg)) {
+    return;
+  }
+
+  this->msgQueue_->push(msg);
 }
 
 }; // namespace node_lib_pd
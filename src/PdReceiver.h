@@ -6,6 +6,11 @@
 #include "PdBase.hpp"
 #include "./types.h"
 #include "./LockedQueue.h"
+#include "./LatencyTracer.h"
+#include "./ChannelFilters.h"
+#include "./LogRing.h"
+#include "./Mailboxes.h"
+#include "./SubscriptionTable.h"
 
 namespace node_lib_pd {
 
@@ -13,7 +18,10 @@ namespace node_lib_pd {
 class PdReceiver : public pd::PdReceiver {
 
   public:
-    PdReceiver(LockedQueue<pd_msg_t> * msgQueue);
+    PdReceiver(LockedQueue<pd_msg_t> * msgQueue, LatencyTracer * latencyTracer,
+               ChannelFilters * channelFilters,
+               SubscriptionTable * subscriptions, Mailboxes * mailboxes,
+               LogRing * logRing);
     // should be virtual in base class
     virtual ~PdReceiver();
 
@@ -37,6 +45,15 @@ class PdReceiver : public pd::PdReceiver {
 
   private:
     LockedQueue<pd_msg_t> * msgQueue_;
+    LatencyTracer * latencyTracer_;
+    ChannelFilters * channelFilters_;
+    SubscriptionTable * subscriptions_;
+    Mailboxes * mailboxes_;
+    LogRing * logRing_;
+
+    // stamp the message if tracing and push it to the queue, unless its
+    // channel is not subscribed or the message is consumed by its filter
+    void push_(std::shared_ptr<pd_msg_t> msg);
 };
 
 }; // namespace
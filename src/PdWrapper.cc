@@ -1,8 +1,12 @@
 #include "./PdWrapper.h"
 
+#include <algorithm>
+
 namespace node_lib_pd {
 
-PdWrapper::PdWrapper() { this->pd_ = new pd::PdBase(); }
+PdWrapper::PdWrapper() : patchPoolCounter_(0), patchCacheEnabled_(false) {
+  this->pd_ = new pd::PdBase();
+}
 
 PdWrapper::~PdWrapper() {
 #ifdef DEBUG
@@ -52,8 +56,79 @@ void PdWrapper::computeAudio(bool compute_audio) {
 
 patch_infos_t PdWrapper::openPatch(const std::string filename,
                                    const std::string path) {
-  pd::Patch patch = this->pd_->openPatch(filename, path);
+  pd::Patch patch = this->loadPatch(filename, path);
+  return this->registerPatch(patch);
+}
+
+patch_infos_t PdWrapper::closePatch(int dollarZero) {
+  patch_infos_t emptyPatch;
+  pd::Patch patch = this->unregisterPatch(dollarZero);
+
+  // patch invalid or already closed
+  if (!patch.isValid()) {
+    return emptyPatch;
+  }
 
+  this->unloadPatch(patch);
+
+  return this->createPatchInfos_(patch);
+}
+
+/**
+ * Read and parse a patch file through the patch cache, returns NULL if the
+ * cache is disabled or if the file can't be read. Must not be called from
+ * the audio thread.
+ */
+patch_source_ptr PdWrapper::readPatch(const std::string &filename,
+                                      const std::string &path) {
+  if (!this->patchCacheEnabled_) {
+    return nullptr;
+  }
+
+  return this->patchCache_.load(filename, path);
+}
+
+/**
+ * Open an instance of a patch without registering it, from its parsed
+ * source if any or else with `libpd_openfile`. Can be called from the
+ * audio thread, which then only does file I/O if there is no source.
+ */
+pd::Patch PdWrapper::loadPatch(const patch_source_ptr &source,
+                               const std::string &filename,
+                               const std::string &path) {
+  if (!source) {
+    return this->pd_->openPatch(filename, path);
+  }
+
+  pd::Patch patch;
+  void *handle = PatchCache::instantiate(*source);
+
+  if (handle != NULL) {
+    patch = pd::Patch(handle, libpd_getdollarzero(handle), source->filename,
+                      source->path);
+  }
+
+  return patch;
+}
+
+/**
+ * Read and open an instance of a patch without registering it, must not be
+ * called from the audio thread.
+ */
+pd::Patch PdWrapper::loadPatch(const std::string &filename,
+                               const std::string &path) {
+  return this->loadPatch(this->readPatch(filename, path), filename, path);
+}
+
+/**
+ * Close an instance of a patch previously unregistered, can be called from
+ * the audio thread.
+ */
+void PdWrapper::unloadPatch(pd::Patch &patch) {
+  this->pd_->closePatch(patch);
+}
+
+patch_infos_t PdWrapper::registerPatch(pd::Patch patch) {
   if (patch.isValid()) {
     std::pair<int, pd::Patch> element = {patch.dollarZero(), patch};
     this->patches_.insert(element);
@@ -62,25 +137,192 @@ patch_infos_t PdWrapper::openPatch(const std::string filename,
   return this->createPatchInfos_(patch);
 }
 
-patch_infos_t PdWrapper::closePatch(int dollarZero) {
-  patch_infos_t emptyPatch;
-  // patch invalid or already closed
+pd::Patch PdWrapper::unregisterPatch(int dollarZero) {
+  pd::Patch patch;
+
   if (dollarZero != 0) {
     auto search = this->patches_.find(dollarZero);
 
     if (search != this->patches_.end()) {
-      pd::Patch patch = search->second;
-
-      this->pd_->closePatch(patch);
+      patch = search->second;
       this->patches_.erase(search);
 
-      return this->createPatchInfos_(patch);
+      // a pooled instance closed directly must leave its pool
+      auto pooled = this->pooledPatches_.find(dollarZero);
+
+      if (pooled != this->pooledPatches_.end()) {
+        patch_pool_t &pool = this->patchPools_[pooled->second.poolId];
+        const int slot = pooled->second.slot;
+
+        if (!pool.slots[slot].acquired) {
+          auto &available = pool.available;
+          available.erase(
+              std::remove(available.begin(), available.end(), slot),
+              available.end());
+        }
+
+        pool.slots[slot] = { 0, false };
+        this->pooledPatches_.erase(pooled);
+      }
     }
+  }
 
-    return emptyPatch;
+  return patch;
+}
+
+// --------------------------------------------------------------------------
+// PATCH POOLS
+// --------------------------------------------------------------------------
+
+/**
+ * Open `size` instances of a patch up front, returns the id of the pool or
+ * -1 if the patch can't be opened.
+ */
+int PdWrapper::createPatchPool(const std::string &filename,
+                               const std::string &path, int size,
+                               std::vector<patch_infos_t> &instances) {
+  const int poolId = this->patchPoolCounter_++;
+  patch_pool_t &pool = this->patchPools_[poolId];
+  pool.filename = filename;
+  pool.path = path;
+
+  // read and parse the file once for all the instances if the cache is on
+  patch_source_ptr source = this->readPatch(filename, path);
+
+  for (int i = 0; i < size; i++) {
+    patch_infos_t patchInfos =
+        this->registerPatch(this->loadPatch(source, filename, path));
+
+    if (!patchInfos.isValid) {
+      break;
+    }
+
+    this->addToPatchPool(poolId, patchInfos.dollarZero);
+    instances.push_back(patchInfos);
+  }
+
+  if (size > 0 && instances.empty()) {
+    this->patchPools_.erase(poolId);
+    return -1;
+  }
+
+  return poolId;
+}
+
+/**
+ * Add an already opened and registered instance to a pool, e.g. when
+ * growing the pool with instances opened in a worker thread.
+ */
+bool PdWrapper::addToPatchPool(int poolId, int dollarZero) {
+  auto search = this->patchPools_.find(poolId);
+
+  if (search == this->patchPools_.end() ||
+      this->patches_.find(dollarZero) == this->patches_.end() ||
+      this->pooledPatches_.find(dollarZero) != this->pooledPatches_.end()) {
+    return false;
+  }
+
+  patch_pool_t &pool = search->second;
+  const int slot = pool.slots.size();
+
+  pool.slots.push_back({ dollarZero, false });
+  pool.available.push_back(slot);
+  this->pooledPatches_[dollarZero] = { poolId, slot };
+
+  return true;
+}
+
+// returns the dollarZero of a free instance, or 0 if none is available
+int PdWrapper::acquirePatch(int poolId) {
+  auto search = this->patchPools_.find(poolId);
+
+  if (search == this->patchPools_.end() || search->second.available.empty()) {
+    return 0;
+  }
+
+  patch_pool_t &pool = search->second;
+  const int slot = pool.available.back();
+  pool.available.pop_back();
+  pool.slots[slot].acquired = true;
+
+  return pool.slots[slot].dollarZero;
+}
+
+bool PdWrapper::releasePatch(int poolId, int dollarZero) {
+  auto pooled = this->pooledPatches_.find(dollarZero);
+
+  // unknown or member of another pool
+  if (pooled == this->pooledPatches_.end() ||
+      pooled->second.poolId != poolId) {
+    return false;
+  }
+
+  patch_pool_t &pool = this->patchPools_[poolId];
+  const int slot = pooled->second.slot;
+
+  // already released
+  if (!pool.slots[slot].acquired) {
+    return false;
+  }
+
+  pool.slots[slot].acquired = false;
+  pool.available.push_back(slot);
+
+  return true;
+}
+
+int PdWrapper::patchPoolAvailable(int poolId) {
+  auto search = this->patchPools_.find(poolId);
+
+  if (search == this->patchPools_.end()) {
+    return 0;
   }
 
-  return emptyPatch;
+  return search->second.available.size();
+}
+
+/**
+ * Filename and path of the instances of a pool, returns false if the pool
+ * does not exist.
+ */
+bool PdWrapper::getPatchPoolSource(int poolId, std::string &filename,
+                                   std::string &path) {
+  auto search = this->patchPools_.find(poolId);
+
+  if (search == this->patchPools_.end()) {
+    return false;
+  }
+
+  filename = search->second.filename;
+  path = search->second.path;
+
+  return true;
+}
+
+// close all the instances of the pool
+bool PdWrapper::destroyPatchPool(int poolId) {
+  auto search = this->patchPools_.find(poolId);
+
+  if (search == this->patchPools_.end()) {
+    return false;
+  }
+
+  std::vector<int> members;
+
+  for (auto &slot : search->second.slots) {
+    if (slot.dollarZero != 0) {
+      members.push_back(slot.dollarZero);
+      this->pooledPatches_.erase(slot.dollarZero);
+    }
+  }
+
+  this->patchPools_.erase(search);
+
+  for (int dollarZero : members) {
+    this->closePatch(dollarZero);
+  }
+
+  return true;
 }
 
 patch_infos_t PdWrapper::createPatchInfos_(pd::Patch patch) {
@@ -101,6 +343,22 @@ void PdWrapper::addToSearchPath(const std::string pathname) {
 
 void PdWrapper::clearSearchPath() { this->pd_->clearSearchPath(); }
 
+void PdWrapper::enablePatchCache(bool enabled) {
+  this->patchCacheEnabled_ = enabled;
+
+  if (!enabled) {
+    this->patchCache_.clear();
+  }
+}
+
+bool PdWrapper::isPatchCacheEnabled() { return this->patchCacheEnabled_; }
+
+void PdWrapper::clearPatchCache() { this->patchCache_.clear(); }
+
+patch_cache_stats_t PdWrapper::getPatchCacheStats() {
+  return this->patchCache_.stats();
+}
+
 // --------------------------------------------------------------------------
 // COMMUNICATIONS
 // --------------------------------------------------------------------------
@@ -129,11 +387,22 @@ void PdWrapper::setReceiver(PdReceiver *receiver) {
 }
 
 void PdWrapper::subscribe(const std::string &channel) {
-  this->pd_->subscribe(channel);
+  if (this->subscriptions_[channel]++ == 0) {
+    this->pd_->subscribe(channel);
+  }
 }
 
 void PdWrapper::unsubscribe(const std::string &channel) {
-  this->pd_->unsubscribe(channel);
+  auto search = this->subscriptions_.find(channel);
+
+  if (search == this->subscriptions_.end()) {
+    return;
+  }
+
+  if (--search->second == 0) {
+    this->subscriptions_.erase(search);
+    this->pd_->unsubscribe(channel);
+  }
 }
 
 // --------------------------------------------------------------------------
@@ -154,10 +423,116 @@ bool PdWrapper::readArray(const std::string &name, std::vector<float> &dest,
   return this->pd_->readArray(name, dest, readLen, offset);
 }
 
+// raw versions, the caller is responsible of the bounds checks
+bool PdWrapper::writeArray(const std::string &name, const float *source,
+                           int writeLen, int offset) {
+  return libpd_write_array(name.c_str(), offset, (float *)source, writeLen) == 0;
+}
+
+bool PdWrapper::readArray(const std::string &name, float *dest, int readLen,
+                          int offset) {
+  return libpd_read_array(dest, name.c_str(), offset, readLen) == 0;
+}
+
 void PdWrapper::clearArray(const std::string &name, int value) {
   return this->pd_->clearArray(name, value);
 }
 
+/**
+ * Resize a garray, as the [array size] object does. Note that this triggers
+ * a rebuild of the DSP graph if the array is used by some DSP object.
+ */
+bool PdWrapper::resizeArray(const std::string &name, long size) {
+  sys_lock();
+  t_garray *garray = this->findArray_(name);
+
+  if (garray != NULL) {
+    garray_resize_long(garray, size);
+  }
+
+  sys_unlock();
+
+  return garray != NULL;
+}
+
+/**
+ * Retrieve the storage of a garray. The returned pointer is owned by pd and
+ * stays valid until the array is resized or freed (e.g. when its patch is
+ * closed). Note that on 64-bit platforms a `t_word` is larger than a float,
+ * so values are not contiguous in memory.
+ */
+bool PdWrapper::getArrayWords(const std::string &name, t_word **vec,
+                              int *size) {
+  sys_lock();
+  t_garray *garray = this->findArray_(name);
+  const bool found = garray != NULL && garray_getfloatwords(garray, size, vec);
+  sys_unlock();
+
+  return found;
+}
+
+/**
+ * Copy several arrays while holding the pd lock once, so that all copies
+ * reflect the state of pd at the same tick.
+ */
+void PdWrapper::readArrays(std::vector<array_read_t> &reads) {
+  // resolve each name once, even if read several times
+  std::map<std::string, t_garray *> garrays;
+
+  sys_lock();
+
+  for (auto &read : reads) {
+    auto it = garrays.find(read.name);
+
+    if (it == garrays.end()) {
+      it = garrays.emplace(read.name, this->findArray_(read.name)).first;
+    }
+
+    t_word *vec = NULL;
+    int size = 0;
+
+    read.result = it->second != NULL &&
+                  garray_getfloatwords(it->second, &size, &vec) &&
+                  read.offset >= 0 && read.length >= 0 &&
+                  read.offset + read.length <= size;
+
+    if (read.result) {
+      t_word *src = vec + read.offset;
+
+      for (int i = 0; i < read.length; i++) {
+        read.dest[i] = src[i].w_float;
+      }
+    }
+  }
+
+  sys_unlock();
+}
+
+bool PdWrapper::readArrayChanges(
+    const std::string &name, ArrayChangeTracker &tracker, float *dest,
+    int destLen, std::vector<ArrayChangeTracker::span_t> &spans) {
+  sys_lock();
+  t_garray *garray = this->findArray_(name);
+  t_word *vec = NULL;
+  int size = 0;
+  bool found = garray != NULL && garray_getfloatwords(garray, &size, &vec);
+
+  if (found && size <= destLen) {
+    tracker.collect(vec, size, dest, spans);
+  } else {
+    found = false;
+  }
+
+  sys_unlock();
+
+  return found;
+}
+
+// must be called while holding the pd lock
+t_garray *PdWrapper::findArray_(const std::string &name) {
+  return (t_garray *)pd_findbyclass(gensym(name.c_str()), garray_class);
+}
+
 // --------------------------------------------------------------------------
 // GUI
 // --------------------------------------------------------------------------
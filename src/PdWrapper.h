@@ -1,13 +1,39 @@
 #pragma once
 
+#include <atomic>
 #include <iostream>
+#include <unordered_map>
 
+#include "./ArrayChangeTracker.h"
+#include "./PatchCache.h"
 #include "./PdReceiver.h"
 #include "./types.h"
 #include "libpd/PdBase.hpp"
 
 namespace node_lib_pd {
 
+/**
+ * Instances of the same patch opened up front. Each instance has a slot and
+ * `available` is a free-list of slots, so that acquire and release are O(1).
+ */
+struct patch_pool_slot_t {
+  int dollarZero; // 0 once the instance has been closed
+  bool acquired;
+};
+
+struct patch_pool_t {
+  std::string filename;
+  std::string path;
+  std::vector<patch_pool_slot_t> slots;
+  std::vector<int> available;
+};
+
+// pool and slot of a pooled instance
+struct pooled_patch_t {
+  int poolId;
+  int slot;
+};
+
 class PdWrapper {
 public:
   PdWrapper();
@@ -23,10 +49,39 @@ public:
 
   patch_infos_t openPatch(const std::string patch, const std::string path);
   patch_infos_t closePatch(int dollarZero);
+  // split versions of openPatch and closePatch, `patches_` must only be
+  // accessed from the main thread while patches can be (un)loaded anywhere.
+  // `readPatch` gets the parsed patch from the patch cache and must not be
+  // called from the audio thread, the source is then instantiated by
+  // `loadPatch`, which opens the file with libpd when there is no source
+  patch_source_ptr readPatch(const std::string &filename,
+                             const std::string &path);
+  pd::Patch loadPatch(const patch_source_ptr &source,
+                      const std::string &filename, const std::string &path);
+  pd::Patch loadPatch(const std::string &filename, const std::string &path);
+  void unloadPatch(pd::Patch &patch);
+  patch_infos_t registerPatch(pd::Patch patch);
+  pd::Patch unregisterPatch(int dollarZero);
+
+  int createPatchPool(const std::string &filename, const std::string &path,
+                      int size, std::vector<patch_infos_t> &instances);
+  bool addToPatchPool(int poolId, int dollarZero);
+  int acquirePatch(int poolId);
+  bool releasePatch(int poolId, int dollarZero);
+  int patchPoolAvailable(int poolId);
+  bool getPatchPoolSource(int poolId, std::string &filename,
+                          std::string &path);
+  bool destroyPatchPool(int poolId);
   void addToSearchPath(const std::string path);
   void clearSearchPath();
+  void enablePatchCache(bool enabled);
+  bool isPatchCacheEnabled();
+  void clearPatchCache();
+  patch_cache_stats_t getPatchCacheStats();
 
   void setReceiver(PdReceiver *receiver);
+  // reference counted, a channel can be used both by js subscriptions and
+  // by a mailbox
   void subscribe(const std::string &channel);
   void unsubscribe(const std::string &channel);
   void sendMessage(const pd_scheduled_msg_t);
@@ -43,7 +98,17 @@ public:
                   int writeLen = -1, int offset = 0);
   bool readArray(const std::string &name, std::vector<float> &dest,
                  int readLen = -1, int offset = 0);
+  bool writeArray(const std::string &name, const float *source, int writeLen,
+                  int offset);
+  bool readArray(const std::string &name, float *dest, int readLen,
+                 int offset);
   void clearArray(const std::string &name, int value = 0);
+  bool resizeArray(const std::string &name, long size);
+  bool getArrayWords(const std::string &name, t_word **vec, int *size);
+  void readArrays(std::vector<array_read_t> &reads);
+  bool readArrayChanges(const std::string &name, ArrayChangeTracker &tracker,
+                        float *dest, int destLen,
+                        std::vector<ArrayChangeTracker::span_t> &spans);
 
   int startGUI(const std::string &path);
   void pollGUI();
@@ -52,8 +117,15 @@ public:
 private:
   pd::PdBase *pd_;
   std::map<int, pd::Patch> patches_;
+  std::unordered_map<int, patch_pool_t> patchPools_;
+  std::unordered_map<int, pooled_patch_t> pooledPatches_; // by dollarZero
+  int patchPoolCounter_;
+  PatchCache patchCache_;
+  std::atomic<bool> patchCacheEnabled_;
+  std::map<std::string, int> subscriptions_;
 
   patch_infos_t createPatchInfos_(pd::Patch);
+  t_garray *findArray_(const std::string &name);
 };
 
 }; // namespace node_lib_pd
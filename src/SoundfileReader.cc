@@ -0,0 +1,326 @@
+#include "./SoundfileReader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace node_lib_pd {
+
+// number of frames decoded at once
+static const long READ_BLOCK_SIZE = 4096;
+// larger than any valid WAV format or AIFF common chunk
+static const uint32_t MAX_FORMAT_CHUNK_SIZE = 1024;
+
+static uint32_t readLE(const unsigned char *b, int n) {
+  uint32_t value = 0;
+  for (int i = n - 1; i >= 0; i--) value = (value << 8) | b[i];
+  return value;
+}
+
+static uint32_t readBE(const unsigned char *b, int n) {
+  uint32_t value = 0;
+  for (int i = 0; i < n; i++) value = (value << 8) | b[i];
+  return value;
+}
+
+// 80 bit IEEE 754 extended float used by AIFF for the sample rate
+static double readExtended(const unsigned char *b) {
+  const int exponent = ((b[0] & 0x7f) << 8) | b[1];
+  const uint32_t hiMantissa = readBE(b + 2, 4);
+  const uint32_t loMantissa = readBE(b + 6, 4);
+
+  if (exponent == 0 && hiMantissa == 0 && loMantissa == 0) {
+    return 0.;
+  }
+
+  double value = std::ldexp((double)hiMantissa, exponent - 16383 - 31);
+  value += std::ldexp((double)loMantissa, exponent - 16383 - 63);
+
+  return (b[0] & 0x80) ? -value : value;
+}
+
+SoundfileReader::SoundfileReader()
+  : numChannels(0)
+  , sampleRate(0)
+  , numFrames(0)
+  , bytesPerSample_(0)
+  , isFloat_(false)
+  , bigEndian_(false)
+  , unsigned8_(false)
+  , framesRead_(0)
+{}
+
+SoundfileReader::~SoundfileReader() {
+  this->close();
+}
+
+bool SoundfileReader::open(const std::string &pathname) {
+  this->file_.open(pathname, std::ios::in | std::ios::binary);
+
+  if (!this->file_.is_open()) {
+    this->error = "Cannot open file \"" + pathname + "\"";
+    return false;
+  }
+
+  unsigned char header[12];
+
+  if (!this->file_.read((char *)header, 12)) {
+    this->error = "Cannot read header of \"" + pathname + "\"";
+    return false;
+  }
+
+  bool parsed = false;
+
+  if (memcmp(header, "RIFF", 4) == 0 && memcmp(header + 8, "WAVE", 4) == 0) {
+    parsed = this->parseWave_();
+  } else if (memcmp(header, "FORM", 4) == 0 &&
+             (memcmp(header + 8, "AIFF", 4) == 0 ||
+              memcmp(header + 8, "AIFC", 4) == 0)) {
+    parsed = this->parseAiff_();
+  } else {
+    this->error = "Unsupported file format, expect WAV or AIFF";
+  }
+
+  if (!parsed) {
+    return false;
+  }
+
+  this->buffer_.resize(READ_BLOCK_SIZE * this->numChannels * this->bytesPerSample_);
+
+  return true;
+}
+
+void SoundfileReader::close() {
+  if (this->file_.is_open()) {
+    this->file_.close();
+  }
+}
+
+bool SoundfileReader::parseWave_() {
+  unsigned char chunk[8];
+  bool hasFormat = false;
+
+  while (this->file_.read((char *)chunk, 8)) {
+    const uint32_t size = readLE(chunk + 4, 4);
+
+    if (memcmp(chunk, "fmt ", 4) == 0) {
+      if (size < 16 || size > MAX_FORMAT_CHUNK_SIZE) {
+        this->error = "Invalid WAV format chunk";
+        return false;
+      }
+
+      std::vector<unsigned char> fmt(size + (size & 1));
+
+      if (!this->file_.read((char *)fmt.data(), fmt.size())) {
+        this->error = "Invalid WAV format chunk";
+        return false;
+      }
+
+      int format = readLE(&fmt[0], 2);
+      // WAVE_FORMAT_EXTENSIBLE, format is the first 2 bytes of the GUID
+      if (format == 0xFFFE && size >= 26) {
+        format = readLE(&fmt[24], 2);
+      }
+
+      this->numChannels = readLE(&fmt[2], 2);
+      this->sampleRate = readLE(&fmt[4], 4);
+      this->isFloat_ = format == 3;
+      this->bigEndian_ = false;
+      this->unsigned8_ = true;
+
+      if (format != 1 && format != 3) {
+        this->error = "Unsupported WAV encoding, expect PCM or float";
+        return false;
+      }
+
+      if (!this->checkFormat_(readLE(&fmt[14], 2))) {
+        return false;
+      }
+
+      hasFormat = true;
+    } else if (memcmp(chunk, "data", 4) == 0) {
+      if (!hasFormat) {
+        this->error = "WAV data chunk found before format chunk";
+        return false;
+      }
+
+      this->numFrames = size / (this->numChannels * this->bytesPerSample_);
+      // file is positionned at the beginning of the samples
+      return true;
+    } else {
+      this->file_.seekg(size + (size & 1), std::ios::cur);
+    }
+  }
+
+  this->error = "No data found in WAV file";
+  return false;
+}
+
+bool SoundfileReader::parseAiff_() {
+  unsigned char chunk[8];
+  bool hasCommon = false;
+
+  while (this->file_.read((char *)chunk, 8)) {
+    const uint32_t size = readBE(chunk + 4, 4);
+
+    if (memcmp(chunk, "COMM", 4) == 0) {
+      if (size < 18 || size > MAX_FORMAT_CHUNK_SIZE) {
+        this->error = "Invalid AIFF common chunk";
+        return false;
+      }
+
+      std::vector<unsigned char> comm(size + (size & 1));
+
+      if (!this->file_.read((char *)comm.data(), comm.size())) {
+        this->error = "Invalid AIFF common chunk";
+        return false;
+      }
+
+      int bitsPerSample = readBE(&comm[6], 2);
+
+      this->numChannels = readBE(&comm[0], 2);
+      this->numFrames = readBE(&comm[2], 4);
+      this->sampleRate = (int)readExtended(&comm[8]);
+      this->isFloat_ = false;
+      this->bigEndian_ = true;
+      this->unsigned8_ = false;
+
+      // AIFC compression type
+      if (size >= 22) {
+        const unsigned char *type = &comm[18];
+
+        if (memcmp(type, "sowt", 4) == 0) {
+          this->bigEndian_ = false;
+        } else if (memcmp(type, "fl32", 4) == 0 || memcmp(type, "FL32", 4) == 0) {
+          this->isFloat_ = true;
+          bitsPerSample = 32;
+        } else if (memcmp(type, "fl64", 4) == 0 || memcmp(type, "FL64", 4) == 0) {
+          this->isFloat_ = true;
+          bitsPerSample = 64;
+        } else if (memcmp(type, "NONE", 4) != 0) {
+          this->error = "Unsupported AIFC compression type";
+          return false;
+        }
+      }
+
+      if (!this->checkFormat_(bitsPerSample)) {
+        return false;
+      }
+
+      hasCommon = true;
+    } else if (memcmp(chunk, "SSND", 4) == 0) {
+      if (!hasCommon) {
+        this->error = "AIFF sound chunk found before common chunk";
+        return false;
+      }
+
+      unsigned char ssnd[8];
+
+      if (!this->file_.read((char *)ssnd, 8)) {
+        this->error = "Invalid AIFF sound chunk";
+        return false;
+      }
+
+      // skip block alignment offset
+      this->file_.seekg(readBE(ssnd, 4), std::ios::cur);
+      return true;
+    } else {
+      this->file_.seekg(size + (size & 1), std::ios::cur);
+    }
+  }
+
+  this->error = "No data found in AIFF file";
+  return false;
+}
+
+// must be called before any size arithmetic, so that a malformed header
+// can't lead to a division by zero
+bool SoundfileReader::checkFormat_(int bitsPerSample) {
+  if (this->numChannels <= 0) {
+    this->error = "Invalid soundfile header, no channel";
+    return false;
+  }
+
+  const bool supported = this->isFloat_
+    ? bitsPerSample == 32 || bitsPerSample == 64
+    : bitsPerSample == 8 || bitsPerSample == 16 || bitsPerSample == 24 ||
+      bitsPerSample == 32;
+
+  if (!supported) {
+    this->error = "Unsupported sample format, expect 8, 16, 24 or 32 bit "
+                  "integer or 32 or 64 bit float";
+    return false;
+  }
+
+  this->bytesPerSample_ = bitsPerSample / 8;
+
+  return true;
+}
+
+float SoundfileReader::decode_(const unsigned char *sample) const {
+  const int n = this->bytesPerSample_;
+  const uint32_t raw = n <= 4
+    ? (this->bigEndian_ ? readBE(sample, n) : readLE(sample, n))
+    : 0;
+
+  if (this->isFloat_) {
+    if (n == 4) {
+      float value;
+      memcpy(&value, &raw, 4);
+      return value;
+    }
+
+    // 64 bit
+    uint64_t hi = this->bigEndian_ ? readBE(sample, 4) : readLE(sample + 4, 4);
+    uint64_t lo = this->bigEndian_ ? readBE(sample + 4, 4) : readLE(sample, 4);
+    uint64_t bits = (hi << 32) | lo;
+    double value;
+    memcpy(&value, &bits, 8);
+    return (float)value;
+  }
+
+  switch (n) {
+    case 1:
+      return this->unsigned8_ ? ((int)raw - 128) / 128.f : (int8_t)raw / 128.f;
+    case 2:
+      return (int16_t)raw / 32768.f;
+    case 3:
+      return ((int32_t)(raw << 8) >> 8) / 8388608.f;
+    case 4:
+      return (int32_t)raw / 2147483648.f;
+    default:
+      return 0.f;
+  }
+}
+
+long SoundfileReader::readChannel(int channel, float *dest, long numFrames) {
+  const int frameSize = this->numChannels * this->bytesPerSample_;
+  const int sampleOffset = channel * this->bytesPerSample_;
+  long remaining = std::min(numFrames, this->numFrames - this->framesRead_);
+  long read = 0;
+
+  while (remaining > 0) {
+    const long blockSize = std::min(remaining, READ_BLOCK_SIZE);
+
+    this->file_.read((char *)this->buffer_.data(), blockSize * frameSize);
+    const long frames = this->file_.gcount() / frameSize;
+
+    for (long i = 0; i < frames; i++) {
+      dest[read + i] = this->decode_(&this->buffer_[i * frameSize + sampleOffset]);
+    }
+
+    read += frames;
+    remaining -= frames;
+    this->framesRead_ += frames;
+
+    // truncated file
+    if (frames < blockSize) {
+      break;
+    }
+  }
+
+  return read;
+}
+
+}; // namespace
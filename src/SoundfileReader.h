@@ -0,0 +1,53 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace node_lib_pd {
+
+/**
+ * Minimal streaming reader for uncompressed WAV and AIFF / AIFC files, i.e.
+ * 8, 16, 24 and 32 bit integer or 32 and 64 bit float samples. Frames are read
+ * by blocks so that decoding a file never requires more than one block of
+ * raw data in memory.
+ */
+class SoundfileReader {
+  public:
+    SoundfileReader();
+    ~SoundfileReader();
+
+    /**
+     * open the file and parse its header, return false and set `error` if
+     * the file can't be read or its format is not supported
+     */
+    bool open(const std::string &pathname);
+    void close();
+
+    /**
+     * read the next `numFrames` frames of the given channel into `dest`,
+     * return the number of frames actually read
+     */
+    long readChannel(int channel, float *dest, long numFrames);
+
+    int numChannels;
+    int sampleRate;
+    long numFrames;
+    std::string error;
+
+  private:
+    bool parseWave_();
+    bool parseAiff_();
+    bool checkFormat_(int bitsPerSample);
+    float decode_(const unsigned char *sample) const;
+
+    std::ifstream file_;
+    int bytesPerSample_;
+    bool isFloat_;
+    bool bigEndian_;
+    bool unsigned8_; // 8 bit WAV is unsigned, 8 bit AIFF (even sowt) is signed
+    long framesRead_;
+    std::vector<unsigned char> buffer_;
+};
+
+}; // namespace
@@ -0,0 +1,153 @@
+#include "./SoundfileWorker.h"
+
+#include <algorithm>
+
+namespace node_lib_pd {
+
+// minimum progression between two progress events
+static const float PROGRESS_STEP = 0.01f;
+
+SoundfileWorker::SoundfileWorker(
+  Napi::Env env,
+  PdWrapper* pdWrapper,
+  const std::string& arrayName,
+  const std::string& pathname,
+  int channel,
+  bool resize,
+  int chunkSize,
+  std::function<void(Napi::Env)> onComplete)
+  : Napi::AsyncProgressWorker<float>(env, "pd load soundfile")
+  , pdWrapper_(pdWrapper)
+  , arrayName_(arrayName)
+  , pathname_(pathname)
+  , channel_(channel)
+  , resize_(resize)
+  , chunkSize_(chunkSize)
+  , onComplete_(onComplete)
+  , deferred_(Napi::Promise::Deferred::New(env))
+  , numChannels_(0)
+  , sampleRate_(0)
+  , numFrames_(0)
+{}
+
+Napi::Promise SoundfileWorker::GetPromise() {
+  return this->deferred_.Promise();
+}
+
+void SoundfileWorker::SetProgressCallback(Napi::Function callback) {
+  this->progressCallback_ = Napi::Persistent(callback);
+}
+
+// this is called in the worker thread
+void SoundfileWorker::Execute(const ExecutionProgress& progress) {
+  SoundfileReader reader;
+
+  if (!reader.open(this->pathname_)) {
+    this->SetError(reader.error);
+    return;
+  }
+
+  if (this->channel_ < 0 || this->channel_ >= reader.numChannels) {
+    this->SetError("Invalid channel " + std::to_string(this->channel_) +
+                   " for a file with " + std::to_string(reader.numChannels) +
+                   " channel(s)");
+    return;
+  }
+
+  t_word *vec = NULL;
+  int arraySize = 0;
+
+  if (!this->pdWrapper_->getArrayWords(this->arrayName_, &vec, &arraySize)) {
+    this->SetError("Cannot write to unknown array \"" + this->arrayName_ + "\"");
+    return;
+  }
+
+  // reallocation and DSP graph rebuild happen here, under the pd lock,
+  // rather than in the audio callback
+  if (this->resize_ && reader.numFrames != arraySize) {
+    if (!this->pdWrapper_->resizeArray(this->arrayName_, reader.numFrames)) {
+      this->SetError("array \"" + this->arrayName_ + "\" changed during load");
+      return;
+    }
+
+    arraySize = reader.numFrames;
+  }
+
+  // as soundfiler, fill the remaining of the array with zeros if not resized
+  const long length = arraySize;
+  const long numFrames = std::min(length, reader.numFrames);
+  std::vector<float> chunk(std::min<long>(this->chunkSize_, std::max(length, 1L)));
+  float lastProgress = 0.f;
+  long written = 0;
+
+  while (written < length) {
+    const long len = std::min<long>(chunk.size(), length - written);
+    long read = 0;
+
+    if (written < numFrames) {
+      read = reader.readChannel(this->channel_, chunk.data(),
+                                std::min(len, numFrames - written));
+      this->numFrames_ += read;
+    }
+
+    std::fill(chunk.begin() + read, chunk.begin() + len, 0.f);
+
+    // the pd lock is held for one chunk only
+    if (!this->pdWrapper_->writeArray(this->arrayName_, chunk.data(), len,
+                                      written)) {
+      this->SetError("array \"" + this->arrayName_ + "\" changed during load");
+      return;
+    }
+
+    written += len;
+
+    const float currentProgress = (float)written / (float)length;
+
+    if (currentProgress - lastProgress >= PROGRESS_STEP) {
+      progress.Send(&currentProgress, 1);
+      lastProgress = currentProgress;
+    }
+  }
+
+  if (lastProgress < 1.f) {
+    const float done = 1.f;
+    progress.Send(&done, 1);
+  }
+
+  this->numChannels_ = reader.numChannels;
+  this->sampleRate_ = reader.sampleRate;
+}
+
+// this is called in the js event loop
+void SoundfileWorker::OnProgress(const float* data, size_t size) {
+  if (this->progressCallback_.IsEmpty() || size == 0) {
+    return;
+  }
+
+  Napi::HandleScope scope(Env());
+  this->progressCallback_.Call({ Napi::Number::New(Env(), data[size - 1]) });
+}
+
+void SoundfileWorker::OnOK() {
+  Napi::HandleScope scope(Env());
+  // views over the array must not see the previous storage
+  this->onComplete_(Env());
+
+  Napi::Object result = Napi::Object::New(Env());
+
+  result.Set("arrayName", this->arrayName_);
+  result.Set("numFrames", Napi::Number::New(Env(), this->numFrames_));
+  result.Set("numChannels", Napi::Number::New(Env(), this->numChannels_));
+  result.Set("sampleRate", Napi::Number::New(Env(), this->sampleRate_));
+  result.Set("channel", Napi::Number::New(Env(), this->channel_));
+
+  this->deferred_.Resolve(result);
+}
+
+void SoundfileWorker::OnError(const Napi::Error& e) {
+  Napi::HandleScope scope(Env());
+  this->onComplete_(Env());
+  this->deferred_.Reject(e.Value());
+}
+
+}; // namespace
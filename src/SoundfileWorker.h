@@ -0,0 +1,62 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <napi.h>
+
+#include "./PdWrapper.h"
+#include "./SoundfileReader.h"
+
+namespace node_lib_pd {
+
+/**
+ * Decode a soundfile in a worker thread and copy one of its channels into a
+ * pd array. The file is decoded by chunks, each chunk being written while
+ * holding the pd lock, so that neither the whole file nor a long stall of
+ * the audio thread is needed. The array is resized from the worker thread
+ * too, never in the audio callback.
+ */
+class SoundfileWorker : public Napi::AsyncProgressWorker<float>
+{
+  public:
+    SoundfileWorker(
+        Napi::Env env,
+        PdWrapper* pdWrapper,
+        const std::string& arrayName,
+        const std::string& pathname,
+        int channel,
+        bool resize,
+        int chunkSize,
+        std::function<void(Napi::Env)> onComplete);
+
+    Napi::Promise GetPromise();
+
+    /**
+     * function called with the progression of the copy (between 0 and 1)
+     */
+    void SetProgressCallback(Napi::Function callback);
+
+    // This code will be executed on the worker thread
+    void Execute(const ExecutionProgress& progress);
+    void OnProgress(const float* data, size_t size);
+    void OnOK();
+    void OnError(const Napi::Error& e);
+
+  private:
+    PdWrapper* pdWrapper_;
+    std::string arrayName_;
+    std::string pathname_;
+    int channel_;
+    bool resize_;
+    int chunkSize_;
+    std::function<void(Napi::Env)> onComplete_;
+    Napi::Promise::Deferred deferred_;
+    Napi::FunctionReference progressCallback_;
+
+    int numChannels_;
+    int sampleRate_;
+    long numFrames_;
+};
+
+}; // namespace
@@ -0,0 +1,184 @@
+#include "./SubscriptionTable.h"
+
+namespace node_lib_pd {
+
+SubscriptionTable::SubscriptionTable()
+  : ids_(new ids_t())
+  , readers_(0)
+{}
+
+SubscriptionTable::~SubscriptionTable() {
+  delete this->ids_.load();
+
+  for (const ids_t *ids : this->retired_) {
+    delete ids;
+  }
+}
+
+bool SubscriptionTable::add(const std::string &channel, Napi::String name,
+                            Napi::Function listener) {
+  // the js thread is the only one replacing the table
+  const ids_t *ids = this->ids_.load();
+  auto search = ids->find(channel);
+
+  if (search != ids->end()) {
+    slot_t &slot = this->slots_[search->second.slot];
+    slot.listeners.push_back(Napi::Persistent(listener));
+    return false;
+  }
+
+  int index;
+
+  if (!this->freeSlots_.empty()) {
+    index = this->freeSlots_.back();
+    this->freeSlots_.pop_back();
+  } else {
+    index = this->slots_.size();
+    this->slots_.emplace_back();
+  }
+
+  slot_t &slot = this->slots_[index];
+  slot.active = true;
+  slot.listeners.push_back(Napi::Persistent(listener));
+
+  if (this->names_.IsEmpty()) {
+    this->names_ = Napi::Persistent(Napi::Array::New(name.Env()).As<Napi::Object>());
+  }
+
+  this->names_.Value().Set((uint32_t)index, name);
+
+  ids_t *next = new ids_t(*ids);
+  (*next)[channel] = { index, slot.generation };
+  this->publish_(next);
+
+  return true;
+}
+
+bool SubscriptionTable::remove(const std::string &channel,
+                               Napi::Value listener) {
+  const ids_t *ids = this->ids_.load();
+  auto search = ids->find(channel);
+
+  if (search == ids->end()) {
+    return false;
+  }
+
+  const int index = search->second.slot;
+  slot_t &slot = this->slots_[index];
+
+  if (!listener.IsEmpty() && listener.IsFunction()) {
+    for (auto it = slot.listeners.begin(); it != slot.listeners.end(); ++it) {
+      if (it->Value().StrictEquals(listener)) {
+        slot.listeners.erase(it);
+        break;
+      }
+    }
+
+    if (!slot.listeners.empty()) {
+      return false;
+    }
+  }
+
+  slot.active = false;
+  slot.generation += 1;
+  this->names_.Value().Set((uint32_t)index, listener.Env().Undefined());
+  slot.listeners.clear();
+
+  this->freeSlots_.push_back(index);
+
+  ids_t *next = new ids_t(*ids);
+  next->erase(channel);
+  this->publish_(next);
+
+  return true;
+}
+
+bool SubscriptionTable::has(const std::string &channel) {
+  const ids_t *ids = this->ids_.load();
+  return ids->find(channel) != ids->end();
+}
+
+bool SubscriptionTable::resolve(pd_msg_t &msg) {
+  // announce the read before loading the table, see `reclaim_`
+  this->readers_.fetch_add(1);
+  const ids_t *ids = this->ids_.load();
+  auto search = ids->find(msg.channel);
+  const bool found = search != ids->end();
+
+  if (found) {
+    msg.channelId = search->second.slot;
+    msg.generation = search->second.generation;
+  }
+
+  this->readers_.fetch_sub(1);
+
+  return found;
+}
+
+bool SubscriptionTable::listeners(const pd_msg_t &msg,
+                                  std::vector<Napi::Function> &dest,
+                                  Napi::Value &name) {
+  // slots are only modified by the js thread
+  if (msg.channelId < 0 || msg.channelId >= (int)this->slots_.size()) {
+    return false;
+  }
+
+  const slot_t &slot = this->slots_[msg.channelId];
+
+  if (!slot.active || slot.generation != msg.generation) {
+    return false;
+  }
+
+  return this->copyListeners_(msg.channelId, dest, name);
+}
+
+bool SubscriptionTable::listeners(const std::string &channel,
+                                  std::vector<Napi::Function> &dest,
+                                  Napi::Value &name) {
+  const ids_t *ids = this->ids_.load();
+  auto search = ids->find(channel);
+
+  if (search == ids->end()) {
+    return false;
+  }
+
+  return this->copyListeners_(search->second.slot, dest, name);
+}
+
+bool SubscriptionTable::copyListeners_(int index,
+                                       std::vector<Napi::Function> &dest,
+                                       Napi::Value &name) {
+  // listeners may unsubscribe while being called, so they are copied
+  const slot_t &slot = this->slots_[index];
+  dest.clear();
+
+  for (auto &listener : slot.listeners) {
+    dest.push_back(listener.Value());
+  }
+
+  name = this->names_.Value().Get((uint32_t)index);
+
+  return true;
+}
+
+void SubscriptionTable::publish_(const ids_t *ids) {
+  this->retired_.push_back(this->ids_.exchange(ids));
+  this->reclaim_();
+}
+
+void SubscriptionTable::reclaim_() {
+  // sequentially consistent with `resolve`: if no reader is seen after the
+  // exchange, readers starting afterwards load the new table, otherwise the
+  // retired tables are kept until a later change
+  if (this->readers_.load() != 0) {
+    return;
+  }
+
+  for (const ids_t *ids : this->retired_) {
+    delete ids;
+  }
+
+  this->retired_.clear();
+}
+
+}; // namespace
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <napi.h>
+
+#include "./types.h"
+
+namespace node_lib_pd {
+
+/**
+ * Routing table of the subscribed channels. Each subscribed channel owns a
+ * slot holding its listeners and its name as a js string, messages received
+ * from pd are stamped with the slot and generation of their channel so that
+ * they can be dispatched without any string work on the js thread.
+ *
+ * A slot is reused once its channel is torn down, its generation is then
+ * incremented so that the messages still in flight for the previous channel
+ * are skipped.
+ *
+ * The channel ids read by the threads running pd are published as an
+ * immutable table: the js thread copies and swaps it on each change, so that
+ * `resolve` neither locks nor waits for js. A replaced table is deleted by
+ * the js thread once no `resolve` is in progress.
+ *
+ * `resolve` can be called from any thread, all other methods must be called
+ * from the js thread.
+ */
+class SubscriptionTable {
+  public:
+    SubscriptionTable();
+    ~SubscriptionTable();
+
+    // return true if this is the first listener of the channel
+    bool add(const std::string &channel, Napi::String name,
+             Napi::Function listener);
+    // remove the given listener or all listeners if empty, return true if
+    // the channel has been torn down
+    bool remove(const std::string &channel, Napi::Value listener);
+    bool has(const std::string &channel);
+
+    // stamp the message with the slot of its channel, false if the channel
+    // is not subscribed
+    bool resolve(pd_msg_t &msg);
+
+    // copy the listeners of the message channel to `dest`, false if the
+    // channel has been torn down since the message was received
+    bool listeners(const pd_msg_t &msg, std::vector<Napi::Function> &dest,
+                   Napi::Value &name);
+    // same as above for channels not received from pd (e.g. xrun)
+    bool listeners(const std::string &channel,
+                   std::vector<Napi::Function> &dest, Napi::Value &name);
+
+  private:
+    struct slot_t {
+      uint32_t generation = 0;
+      bool active = false;
+      std::vector<Napi::FunctionReference> listeners;
+    };
+
+    struct channel_id_t {
+      int slot;
+      uint32_t generation;
+    };
+
+    typedef std::map<std::string, channel_id_t> ids_t;
+
+    bool copyListeners_(int slot, std::vector<Napi::Function> &dest,
+                        Napi::Value &name);
+    // publish `ids` in place of the current table, which is retired
+    void publish_(const ids_t *ids);
+    void reclaim_();
+
+    std::vector<slot_t> slots_;
+    // js names of the channels indexed by slot, strings can't be referenced
+    // by themselves with older N-API versions
+    Napi::ObjectReference names_;
+    std::vector<int> freeSlots_;
+    // read by the threads running pd, only replaced by the js thread
+    std::atomic<const ids_t *> ids_;
+    // number of `resolve` in progress
+    std::atomic<int> readers_;
+    std::vector<const ids_t *> retired_;
+};
+
+}; // namespace
@@ -0,0 +1,92 @@
+#include "./TaskCompletions.h"
+
+#include <utility>
+
+#include "./TickTaskWorker.h"
+
+namespace node_lib_pd {
+
+// minimum progression between two progress events
+static const float PROGRESS_STEP = 0.01f;
+
+TaskCompletions::TaskCompletions() {}
+
+TaskCompletions::~TaskCompletions() {
+  for (auto worker : this->workers_) {
+    delete worker;
+  }
+}
+
+void TaskCompletions::add(TickTaskWorker *worker) {
+  std::lock_guard<std::mutex> lock(this->mut_);
+  this->workers_.push_back(worker);
+}
+
+bool TaskCompletions::poll() {
+  std::lock_guard<std::mutex> lock(this->mut_);
+
+  for (auto worker : this->workers_) {
+    if (worker->task_->isDone() ||
+        worker->task_->progress() - worker->reportedProgress_ >= PROGRESS_STEP) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void TaskCompletions::dispatch(Napi::Env env) {
+  std::vector<TickTaskWorker *> finished;
+  std::vector<std::pair<TickTaskWorker *, float>> progressed;
+
+  {
+    std::lock_guard<std::mutex> lock(this->mut_);
+    auto it = this->workers_.begin();
+
+    while (it != this->workers_.end()) {
+      TickTaskWorker *worker = *it;
+
+      if (worker->task_->isDone()) {
+        finished.push_back(worker);
+        it = this->workers_.erase(it);
+        continue;
+      }
+
+      const float progress = worker->task_->progress();
+
+      if (progress - worker->reportedProgress_ >= PROGRESS_STEP) {
+        worker->reportedProgress_ = progress;
+        progressed.push_back(std::make_pair(worker, progress));
+      }
+
+      ++it;
+    }
+  }
+
+  // callbacks are called without the lock, they may schedule new tasks
+  for (auto &entry : progressed) {
+    entry.first->ReportProgress_(env, entry.second);
+  }
+
+  for (auto worker : finished) {
+    worker->Settle_(env, worker->task_->error);
+    delete worker;
+  }
+}
+
+void TaskCompletions::cancel(Napi::Env env, const std::string &error) {
+  std::vector<TickTaskWorker *> pending;
+
+  {
+    std::lock_guard<std::mutex> lock(this->mut_);
+    this->workers_.swap(pending);
+  }
+
+  for (auto worker : pending) {
+    // tasks applied right before the stream stopped are not lost
+    worker->Settle_(env, worker->task_->isDone() ? worker->task_->error : error);
+    delete worker;
+  }
+}
+
+}; // namespace
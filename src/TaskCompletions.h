@@ -0,0 +1,50 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <napi.h>
+
+namespace node_lib_pd {
+
+class TickTaskWorker;
+
+/**
+ * Tick tasks scheduled from js and not yet settled. The audio thread only
+ * marks the tasks as done, the background process polls them and wakes the
+ * js thread which reports the progression and settles the Promises, so that
+ * no worker thread is held while a task is pending.
+ */
+class TaskCompletions {
+  public:
+    TaskCompletions();
+    ~TaskCompletions();
+
+    /**
+     * take ownership of a worker whose task has been scheduled, js thread
+     */
+    void add(TickTaskWorker *worker);
+
+    /**
+     * true if a task is done or has progressed since the last report, called
+     * from the background process
+     */
+    bool poll();
+
+    /**
+     * report progressions and settle the finished tasks, js thread
+     */
+    void dispatch(Napi::Env env);
+
+    /**
+     * reject every pending task, js thread. The audio stream must be stopped
+     * as the buffers of the tasks are released
+     */
+    void cancel(Napi::Env env, const std::string &error);
+
+  private:
+    std::vector<TickTaskWorker *> workers_;
+    std::mutex mut_;
+};
+
+}; // namespace
@@ -0,0 +1,124 @@
+#include "./ThreadSettings.h"
+
+#include <errno.h>
+
+namespace node_lib_pd {
+
+thread_report_t::thread_report_t()
+  : applied(false)
+  , policy(-1)
+  , priority(0)
+  , cpuMask(0)
+  , priorityError(0)
+  , affinityError(0)
+{}
+
+void applyThreadSettings(const thread_settings_t &settings,
+                         thread_report_t &report) {
+  pthread_t thread = pthread_self();
+
+  report.priorityError = 0;
+  report.affinityError = 0;
+
+  if (settings.policy != -1) {
+    const int min = sched_get_priority_min(settings.policy);
+    const int max = sched_get_priority_max(settings.policy);
+
+    if (min == -1 || max == -1) {
+      report.priorityError = EINVAL;
+    } else {
+      struct sched_param param;
+      param.sched_priority = settings.priority < min
+                                 ? min
+                                 : (settings.priority > max ? max
+                                                            : settings.priority);
+
+      report.priorityError =
+          pthread_setschedparam(thread, settings.policy, &param);
+    }
+  }
+
+#ifdef __linux__
+  if (settings.cpuMask != 0) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+
+    for (int i = 0; i < 64; i++) {
+      if (settings.cpuMask & ((uint64_t)1 << i)) {
+        CPU_SET(i, &cpus);
+      }
+    }
+
+    report.affinityError =
+        pthread_setaffinity_np(thread, sizeof(cpu_set_t), &cpus);
+  }
+
+  cpu_set_t current;
+  CPU_ZERO(&current);
+  report.cpuMask = 0;
+
+  if (pthread_getaffinity_np(thread, sizeof(cpu_set_t), &current) == 0) {
+    for (int i = 0; i < 64; i++) {
+      if (CPU_ISSET(i, &current)) {
+        report.cpuMask |= (uint64_t)1 << i;
+      }
+    }
+  }
+#else
+  // no portable affinity api (e.g. macOS only has affinity tags)
+  if (settings.cpuMask != 0) {
+    report.affinityError = ENOTSUP;
+  }
+
+  report.cpuMask = 0;
+#endif
+
+  int policy;
+  struct sched_param param;
+
+  if (pthread_getschedparam(thread, &policy, &param) == 0) {
+    report.policy = policy;
+    report.priority = param.sched_priority;
+  }
+
+  report.applied = true;
+}
+
+thread_state_t::thread_state_t()
+  : saved(false)
+  , policy(SCHED_OTHER)
+{
+  this->param.sched_priority = 0;
+#ifdef __linux__
+  this->hasAffinity = false;
+  CPU_ZERO(&this->cpus);
+#endif
+}
+
+void saveThreadState(thread_state_t &state) {
+  pthread_t thread = pthread_self();
+
+  state.saved =
+      pthread_getschedparam(thread, &state.policy, &state.param) == 0;
+
+#ifdef __linux__
+  state.hasAffinity =
+      pthread_getaffinity_np(thread, sizeof(cpu_set_t), &state.cpus) == 0;
+#endif
+}
+
+void restoreThreadState(const thread_state_t &state) {
+  pthread_t thread = pthread_self();
+
+  if (state.saved) {
+    pthread_setschedparam(thread, state.policy, &state.param);
+  }
+
+#ifdef __linux__
+  if (state.hasAffinity) {
+    pthread_setaffinity_np(thread, sizeof(cpu_set_t), &state.cpus);
+  }
+#endif
+}
+
+}; // namespace
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+
+namespace node_lib_pd {
+
+// requested scheduling of a thread, part of `audio_config_t`
+typedef struct thread_settings_s {
+  int policy;       // -1 to keep the current policy, SCHED_OTHER, SCHED_FIFO
+                    // or SCHED_RR otherwise
+  int priority;     // clamped to the range of the policy
+  uint64_t cpuMask; // cpus the thread may run on, 0 to keep the current ones
+} thread_settings_t;
+
+/**
+ * Scheduling of a thread as read back once the settings have been applied.
+ * Written once by the thread itself, fields are safe to read when `applied`
+ * is true.
+ */
+struct thread_report_t {
+  thread_report_t();
+
+  std::atomic<bool> applied;
+  int policy;
+  int priority;
+  uint64_t cpuMask; // 0 if unknown (i.e. not supported by the platform)
+  int priorityError; // errno of the failed call, 0 on success
+  int affinityError;
+};
+
+/**
+ * Scheduling of a thread before settings are applied to it, so that a
+ * borrowed thread (e.g. from the libuv pool) can be given back unchanged.
+ */
+struct thread_state_t {
+  thread_state_t();
+
+  bool saved;
+  int policy;
+  struct sched_param param;
+#ifdef __linux__
+  bool hasAffinity;
+  cpu_set_t cpus;
+#endif
+};
+
+/**
+ * Save the scheduling of the calling thread in `state`.
+ */
+void saveThreadState(thread_state_t &state);
+
+/**
+ * Give the calling thread back the scheduling saved in `state`.
+ */
+void restoreThreadState(const thread_state_t &state);
+
+/**
+ * Apply `settings` to the calling thread and fill `report`. Failures (e.g.
+ * missing permissions for realtime policies) leave the thread unchanged and
+ * are only recorded in the report. Does not allocate, so that it can be
+ * called from the audio callback.
+ */
+void applyThreadSettings(const thread_settings_t &settings,
+                         thread_report_t &report);
+
+}; // namespace
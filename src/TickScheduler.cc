@@ -0,0 +1,111 @@
+#include "./TickScheduler.h"
+
+#include <algorithm>
+
+namespace node_lib_pd {
+
+// number of finished tasks we can store without allocating in audio thread
+static const size_t FINISHED_TASKS_RESERVE = 256;
+
+std::atomic<long> TickTask::counter(0);
+
+TickTask::TickTask(double time)
+  : time(time)
+  , index(counter++)
+  , done_(false)
+{}
+
+float TickTask::progress() const {
+  return this->isDone() ? 1.f : 0.f;
+}
+
+bool TickTask::isDone() const {
+  return this->done_.load(std::memory_order_acquire);
+}
+
+void TickTask::setDone() {
+  this->done_.store(true, std::memory_order_release);
+}
+
+TickScheduler::TickScheduler()
+  : numPending_(0)
+  , budget_(0.)
+  , mut_()
+{
+  this->finishedTasks_.reserve(FINISHED_TASKS_RESERVE);
+}
+
+TickScheduler::~TickScheduler() {}
+
+void TickScheduler::add(std::shared_ptr<TickTask> task) {
+  std::lock_guard<std::mutex> lock(this->mut_);
+  this->pendingTasks_.push(task);
+  this->numPending_ += 1;
+  // every pending task must find a slot when it finishes
+  this->reserveFinished_();
+}
+
+void TickScheduler::reserveFinished_() {
+  const size_t needed =
+      this->finishedTasks_.size() + this->pendingTasks_.size();
+
+  if (needed > this->finishedTasks_.capacity()) {
+    this->finishedTasks_.reserve(
+        std::max(needed, 2 * this->finishedTasks_.capacity()));
+  }
+}
+
+bool TickScheduler::hasPending() const {
+  return this->numPending_.load() > 0;
+}
+
+void TickScheduler::setBudget(double budget) {
+  this->budget_ = std::chrono::duration<double>(budget);
+}
+
+void TickScheduler::process(double time) {
+  std::unique_lock<std::mutex> lock(this->mut_, std::try_to_lock);
+
+  // a task is being added, don't wait, we will retry at next tick
+  if (!lock.owns_lock()) {
+    return;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+
+  while (!this->pendingTasks_.empty() && this->pendingTasks_.top()->time <= time) {
+    // never allocate here, capacity is reserved by `add` and `collect`
+    if (this->finishedTasks_.size() == this->finishedTasks_.capacity()) {
+      break;
+    }
+
+    std::shared_ptr<TickTask> task = this->pendingTasks_.top();
+
+    // task needs more ticks, keep the order of the tasks
+    if (!task->process()) {
+      break;
+    }
+
+    this->pendingTasks_.pop();
+    this->finishedTasks_.push_back(task);
+    this->numPending_ -= 1;
+    // must be the last access, the owner is allowed to release the task now
+    task->setDone();
+
+    if (std::chrono::steady_clock::now() - start >= this->budget_) {
+      break;
+    }
+  }
+}
+
+void TickScheduler::collect() {
+  std::vector<std::shared_ptr<TickTask>> finished;
+  finished.reserve(FINISHED_TASKS_RESERVE);
+
+  std::lock_guard<std::mutex> lock(this->mut_);
+  this->finishedTasks_.swap(finished);
+  this->reserveFinished_();
+  // tasks are released when `finished` goes out of scope, after unlock
+}
+
+}; // namespace
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <vector>
+
+namespace node_lib_pd {
+
+/**
+ * Unit of work executed by the audio thread between two pd ticks, i.e. while
+ * no DSP is running. `process` is called once per tick until it returns true,
+ * which allows to split long operations over several ticks.
+ */
+class TickTask {
+  public:
+    TickTask(double time);
+    virtual ~TickTask() = default;
+
+    /**
+     * called in the audio thread, return true when the task is finished
+     */
+    virtual bool process() = 0;
+
+    /**
+     * progression of the task between 0 and 1, can be called from any thread
+     */
+    virtual float progress() const;
+
+    bool isDone() const;
+    void setDone();
+
+    // audio time at which the task should start, 0 means asap
+    double time;
+    long index;
+    // set by `process` if the task failed, safe to read once done
+    std::string error;
+
+  private:
+    std::atomic<bool> done_;
+
+    static std::atomic<long> counter;
+};
+
+struct compare_task_time_t {
+  bool operator()(std::shared_ptr<TickTask> const & task1, std::shared_ptr<TickTask> const & task2) {
+    if (task1->time > task2->time) {
+      return true;
+    } else if (task1->time == task2->time) {
+      return task1->index > task2->index;
+    } else {
+      return false;
+    }
+  }
+};
+
+/**
+ * Queue of tasks to be applied at tick boundaries by the audio callback.
+ *
+ * The audio thread never blocks on the queue (if the lock is owned by another
+ * thread the tasks are just delayed to the next tick) and never releases a
+ * task: finished tasks are kept until `collect` is called from a non realtime
+ * thread.
+ */
+class TickScheduler {
+  public:
+    TickScheduler();
+    ~TickScheduler();
+
+    void add(std::shared_ptr<TickTask> task);
+
+    /**
+     * true if some tasks are waiting to be processed, lock free
+     */
+    bool hasPending() const;
+
+    /**
+     * max time spent (in sec) in `process`, a task that has been started is
+     * however never interrupted
+     */
+    void setBudget(double budget);
+
+    /**
+     * process all tasks due at `time`, called in the audio thread between
+     * two ticks
+     */
+    void process(double time);
+
+    /**
+     * release finished tasks, must not be called in the audio thread
+     */
+    void collect();
+
+  private:
+    /**
+     * grow `finishedTasks_` so that all pending tasks fit, called with `mut_`
+     * owned from a non realtime thread
+     */
+    void reserveFinished_();
+
+    std::priority_queue<std::shared_ptr<TickTask>, std::vector<std::shared_ptr<TickTask>>, compare_task_time_t> pendingTasks_;
+    std::vector<std::shared_ptr<TickTask>> finishedTasks_;
+    std::atomic<int> numPending_;
+    std::chrono::duration<double> budget_;
+
+    mutable std::mutex mut_;
+};
+
+}; // namespace
@@ -0,0 +1,96 @@
+#include "./TickTaskWorker.h"
+
+namespace node_lib_pd {
+
+TickTaskWorker::TickTaskWorker(
+  Napi::Env env,
+  const char* resourceName,
+  TickScheduler* tickScheduler,
+  PaWrapper* paWrapper,
+  TaskCompletions* completions,
+  std::shared_ptr<TickTask> task)
+  : Napi::AsyncWorker(env, resourceName)
+  , task_(task)
+  , tickScheduler_(tickScheduler)
+  , paWrapper_(paWrapper)
+  , completions_(completions)
+  , deferred_(Napi::Promise::Deferred::New(env))
+  , reportedProgress_(0.f)
+{}
+
+TickTaskWorker::~TickTaskWorker() {}
+
+Napi::Promise TickTaskWorker::GetPromise() {
+  return this->deferred_.Promise();
+}
+
+void TickTaskWorker::SetProgressCallback(Napi::Function callback) {
+  this->progressCallback_ = Napi::Persistent(callback);
+}
+
+void TickTaskWorker::Retain(Napi::Object object) {
+  this->retained_ = Napi::Persistent(object);
+}
+
+bool TickTaskWorker::Prepare_() {
+  return true;
+}
+
+Napi::Value TickTaskWorker::Result_(Napi::Env env) {
+  if (!this->retained_.IsEmpty()) {
+    return this->retained_.Value();
+  }
+
+  return Napi::Boolean::New(env, true);
+}
+
+// this is called in the worker thread, which is released as soon as the task
+// is scheduled
+void TickTaskWorker::Execute() {
+  if (!this->Prepare_()) {
+    return;
+  }
+
+  // the task would never be applied
+  if (!this->paWrapper_->isActive()) {
+    this->SetError("audio stream is not running");
+    return;
+  }
+
+  this->tickScheduler_->add(this->task_);
+}
+
+// this is called in the js event loop
+void TickTaskWorker::OnOK() {
+  // owned by `completions_` until the task is applied
+  this->SuppressDestruct();
+  this->completions_->add(this);
+}
+
+void TickTaskWorker::OnError(const Napi::Error& e) {
+  Napi::HandleScope scope(Env());
+  this->deferred_.Reject(e.Value());
+}
+
+void TickTaskWorker::ReportProgress_(Napi::Env env, float progress) {
+  if (this->progressCallback_.IsEmpty()) {
+    return;
+  }
+
+  Napi::HandleScope scope(env);
+  this->progressCallback_.Call({ Napi::Number::New(env, progress) });
+}
+
+void TickTaskWorker::Settle_(Napi::Env env, const std::string& error) {
+  Napi::HandleScope scope(env);
+
+  if (!error.empty()) {
+    this->deferred_.Reject(Napi::Error::New(env, error).Value());
+    return;
+  }
+
+  this->ReportProgress_(env, 1.f);
+  this->deferred_.Resolve(this->Result_(env));
+}
+
+}; // namespace
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <napi.h>
+
+#include "portaudio.h"
+#include "./PaWrapper.h"
+#include "./TaskCompletions.h"
+#include "./TickScheduler.h"
+
+namespace node_lib_pd {
+
+/**
+ * Run a TickTask from js: the task is prepared and scheduled from a worker
+ * thread, then handed to `TaskCompletions` which reports its progression and
+ * settles a Promise once the audio thread has applied it. No worker thread
+ * is held while the task is pending.
+ */
+class TickTaskWorker : public Napi::AsyncWorker
+{
+  friend class TaskCompletions;
+
+  public:
+    TickTaskWorker(
+        Napi::Env env,
+        const char* resourceName,
+        TickScheduler* tickScheduler,
+        PaWrapper* paWrapper,
+        TaskCompletions* completions,
+        std::shared_ptr<TickTask> task);
+    virtual ~TickTaskWorker();
+
+    Napi::Promise GetPromise();
+
+    /**
+     * function called with the progression of the task (between 0 and 1)
+     */
+    void SetProgressCallback(Napi::Function callback);
+
+    /**
+     * keep a js object alive until the task is done, the Promise is resolved
+     * with this object
+     */
+    void Retain(Napi::Object object);
+
+    // This code will be executed on the worker thread
+    void Execute();
+    void OnOK();
+    void OnError(const Napi::Error& e);
+
+  protected:
+    /**
+     * executed in the worker thread before the task is scheduled, e.g. to
+     * prepare data, must call `SetError` and return false on failure
+     */
+    virtual bool Prepare_();
+
+    /**
+     * value the Promise is resolved with, executed in the js thread
+     */
+    virtual Napi::Value Result_(Napi::Env env);
+
+    std::shared_ptr<TickTask> task_;
+
+  private:
+    // called by `TaskCompletions` in the js thread
+    void ReportProgress_(Napi::Env env, float progress);
+    void Settle_(Napi::Env env, const std::string& error);
+
+    TickScheduler* tickScheduler_;
+    PaWrapper* paWrapper_;
+    TaskCompletions* completions_;
+    Napi::Promise::Deferred deferred_;
+    Napi::FunctionReference progressCallback_;
+    Napi::ObjectReference retained_;
+    // last progression given to the callback, guarded by `completions_`
+    float reportedProgress_;
+};
+
+}; // namespace
@@ -2,17 +2,43 @@
 
 #include "libpd/PdBase.hpp"
 #include "portaudio.h"
+#include "./LockedQueue.h"
+#include "./ThreadSettings.h"
 
 namespace node_lib_pd {
 
+typedef struct queue_config_s {
+  size_t capacity;       // 0 for unbounded
+  OverflowPolicy policy; // applied when capacity is reached
+} queue_config_t;
+
+// audio driver of the pd instance, the offline backend processes silent
+// buffers from a plain thread, i.e. without any audio device
+enum { BACKEND_PORTAUDIO = 0, BACKEND_OFFLINE = 1 };
+
 typedef struct audio_config_s {
   int numInputChannels;
   int numOutputChannels;
   int sampleRate;
   int blockSize;
   int ticks;
-  int framesPerBuffer; // blockSize * ticks
+  int framesPerBuffer; // host buffer size, 0 for paFramesPerBufferUnspecified
   double bufferDuration;
+  int inputDevice;            // -1 for default device
+  int outputDevice;           // -1 for default device
+  int hostApi;                // -1 for default host API
+  double inputLatency;        // in seconds, < 0 for device default low latency
+  double outputLatency;       // in seconds, < 0 for device default low latency
+  unsigned long streamFlags;  // PaStreamFlags
+  bool processRaw;            // use libpd_process_raw and simd conversions
+  thread_settings_t dspThread;     // portaudio callback thread
+  thread_settings_t messageThread; // background process thread
+  int lockMemory; // 0: no locking, 1: current pages, 2: current and future
+  bool xrunEvents; // push xrun events to js
+  int backend;   // BACKEND_PORTAUDIO or BACKEND_OFFLINE
+  bool realtime; // offline backend runs at the pace of the sample rate
+  queue_config_t receiveQueue; // messages from pd to js
+  queue_config_t sendQueue;    // scheduled messages from js to pd
 } audio_config_t;
 
 typedef struct patch_infos_s {
@@ -22,6 +48,15 @@ typedef struct patch_infos_s {
   int dollarZero = 0;
 } patch_infos_t;
 
+// one entry of a batched array read
+typedef struct array_read_s {
+  std::string name;
+  float *dest = NULL;
+  int offset = 0;
+  int length = 0;
+  bool result = false;
+} array_read_t;
+
 /**
  * Pack all messages in the same struct. This is kind of brute force
  * but using derived struct leads to weird (and not understood) behavior
@@ -62,6 +97,12 @@ struct pd_msg_t {
   float num;
   std::string symbol = ""; // should be a ref, but crashes at compile time
   pd::List list; // should be a ref, but crash at compile time
+  // LatencyTracer time at which the message was sent from js or received
+  // from pd, 0 if not traced
+  uint64_t timestamp = 0;
+  // slot and generation of the channel in the SubscriptionTable
+  int channelId = -1;
+  uint32_t generation = 0;
 };
 
 // for time
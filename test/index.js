@@ -1,5 +1,7 @@
 const path = require("path");
 const fs = require("fs");
+const os = require("os");
+const { execFile } = require("child_process");
 const assert = require("chai").assert;
 const pd = require("../");
 // debug
@@ -12,7 +14,55 @@ const patchesPath = path.join(process.cwd(), "test", "pd");
 const GUI_POLLING_INTERVAL = 200;
 let pollInterval;
 
+// pd can only be initialized once per process, configurations that need
+// their own instance run `script` in a fresh node process, where `pd` and
+// `patchesPath` are defined. The script must print its result as JSON.
+function runIsolated(script) {
+  const source = `
+    const pd = require(${JSON.stringify(path.join(__dirname, ".."))});
+    const patchesPath = ${JSON.stringify(patchesPath)};
+
+    (async () => { ${script} })()
+      .then((result) => {
+        console.log(JSON.stringify(result));
+        pd.destroy();
+        process.exit(0);
+      })
+      .catch((err) => {
+        console.error(err);
+        process.exit(1);
+      });
+  `;
+
+  return new Promise((resolve, reject) => {
+    execFile(process.execPath, ["-e", source], (err, stdout, stderr) => {
+      if (err) {
+        reject(new Error(stderr || err.message));
+        return;
+      }
+
+      const lines = stdout.trim().split("\n");
+      resolve(JSON.parse(lines[lines.length - 1]));
+    });
+  });
+}
+
 describe("node-libpd", () => {
+  it("pd.refreshDevices() - stream stopped", function () {
+    const devices = pd.listDevices();
+
+    assert.isTrue(pd.refreshDevices(), "should succeed before the stream is started");
+
+    const refreshed = pd.listDevices();
+    assert.isArray(refreshed);
+    assert.equal(refreshed.length, pd.getDevicesCount());
+    // same devices are plugged
+    assert.deepEqual(
+      refreshed.map((device) => device.name),
+      devices.map((device) => device.name)
+    );
+  });
+
   it("pd.init(config)", () => {
     // start worker thread, launch pd and portaudio
     // @todo - fix the race condition between the js and the worker thread
@@ -30,6 +80,206 @@ describe("node-libpd", () => {
     assert.isTrue(initialized);
   });
 
+  it("pd.getInitTimings()", function () {
+    const timings = pd.getInitTimings();
+    console.log(timings);
+
+    ["pdInit", "paInitialize", "streamOpen", "firstCallback"].forEach((key) => {
+      assert.isNumber(timings[key]);
+      assert.isAtLeast(timings[key], 0);
+    });
+  });
+
+  it("pd.getStreamInfo()", function () {
+    const info = pd.getStreamInfo();
+    console.log(info);
+
+    assert.isObject(info);
+    assert.isAtLeast(info.outputLatency, 0);
+    assert.equal(info.totalLatency, info.inputLatency + info.outputLatency);
+    assert.isAbove(info.sampleRate, 0);
+    assert.isNumber(info.hostApi);
+    // whole pd blocks are processed in place
+    assert.equal(info.framesPerBuffer, 64);
+    assert.isFalse(info.blockAdapter);
+  });
+
+  it("pd.getStreamInfo() - block adapter", async function () {
+    this.timeout(10000);
+
+    const result = await runIsolated(`
+      pd.init({
+        numInputChannels: 0,
+        numOutputChannels: 1,
+        sampleRate: 48000,
+        // not a multiple of the pd block size
+        framesPerBuffer: 100,
+      });
+
+      const info = pd.getStreamInfo();
+      const startTime = pd.currentTime;
+      const patch = pd.openPatch("echo-msg.pd", patchesPath);
+      const echo = new Promise((resolve) => {
+        pd.subscribe(\`\${patch.$0}-float-echo\`, resolve);
+      });
+
+      pd.send(\`\${patch.$0}-float\`, 42);
+      await new Promise((resolve) => setTimeout(resolve, 200));
+
+      return {
+        info,
+        stats: pd.getAudioStats(),
+        load: pd.getDspLoad(),
+        elapsed: pd.currentTime - startTime,
+        echo: await echo,
+      };
+    `);
+
+    assert.equal(result.info.framesPerBuffer, 100);
+    assert.isTrue(result.info.blockAdapter);
+    // audio still flows
+    assert.isAbove(result.stats.callbacks, 0);
+    assert.isAbove(result.stats.frames, 0);
+    assert.isAbove(result.load.callbacks, 0);
+    assert.isAbove(result.elapsed, 0);
+    // and messages too
+    assert.equal(result.echo, 42);
+  });
+
+  it("pd.getThreadSettings()", function () {
+    const settings = pd.getThreadSettings();
+    console.log(settings);
+
+    // applied by the first audio callback, which `init` waits for
+    assert.isObject(settings.dsp);
+    assert.isNumber(settings.dsp.priority);
+    assert.isArray(settings.dsp.cpus);
+  });
+
+  it("pd.getThreadSettings() - config.threads", async function () {
+    this.timeout(10000);
+
+    const result = await runIsolated(`
+      pd.init({
+        numInputChannels: 0,
+        numOutputChannels: 1,
+        sampleRate: 48000,
+        threads: {
+          message: { policy: "other", priority: 0, cpus: [0] },
+        },
+      });
+
+      // applied once the message thread is running
+      await new Promise((resolve) => setTimeout(resolve, 100));
+
+      return pd.getThreadSettings();
+    `);
+
+    const message = result.message;
+    assert.isObject(message);
+    assert.equal(message.policy, "other");
+    assert.equal(message.priority, 0);
+    assert.isNull(message.priorityError);
+
+    if (os.platform() === "linux") {
+      assert.deepEqual(message.cpus, [0]);
+      assert.isNull(message.affinityError);
+    }
+  });
+
+  it("pd.getMemoryLock()", function () {
+    const memoryLock = pd.getMemoryLock();
+
+    // not requested at init
+    assert.isFalse(memoryLock.locked);
+    assert.isNumber(memoryLock.lockedBytes);
+    assert.isNull(memoryLock.error);
+  });
+
+  it("pd.getAudioStats()", function () {
+    const stats = pd.getAudioStats();
+    console.log(stats);
+
+    assert.isAbove(stats.callbacks, 0);
+    assert.equal(stats.frames % 64, 0);
+    assert.isAtMost(stats.events.length, stats.xruns);
+    assert.isAtMost(stats.events.length, 64);
+
+    stats.events.forEach((event) => {
+      assert.isNumber(event.frame);
+      assert.isArray(event.flags);
+    });
+  });
+
+  it("pd.getDspLoad()", async function () {
+    // count enough callbacks for the reset to be observable
+    await new Promise((resolve) => setTimeout(resolve, 300));
+
+    const load = pd.getDspLoad();
+    console.log(load);
+
+    assert.isAbove(load.callbacks, 0);
+    assert.isAtLeast(load.current, 0);
+    assert.isAtMost(load.average, load.max);
+    assert.isAtMost(load.p50, load.p99);
+    assert.isAtMost(load.p99, load.p999);
+    assert.isAtMost(load.p999, load.maxDuration);
+
+    // applied by the next audio callback
+    pd.resetDspLoad();
+    const resetTime = Date.now();
+    await new Promise((resolve) => setTimeout(resolve, 50));
+
+    const reset = pd.getDspLoad();
+    const elapsed = Date.now() - resetTime;
+    // 64 frames per callback at 48kHz, with some slack for the scheduling
+    const maxCallbacks = Math.ceil((elapsed / (64 / 48000 * 1000)) * 2) + 2;
+
+    assert.isBelow(reset.callbacks, load.callbacks);
+    assert.isAtMost(reset.callbacks, maxCallbacks);
+  });
+
+  it("pd.initAsync(config)", async function () {
+    let rejected = false;
+
+    try {
+      await pd.initAsync({ timeout: 100 });
+    } catch (err) {
+      rejected = true;
+    }
+
+    assert.isTrue(rejected, "should reject when already initialized");
+  });
+
+  it("pd.initAsync(config) - fresh instance", async function () {
+    this.timeout(10000);
+
+    const result = await runIsolated(`
+      const timings = await pd.initAsync({
+        numInputChannels: 0,
+        numOutputChannels: 1,
+        sampleRate: 48000,
+        ticks: 1,
+      });
+
+      const patch = pd.openPatch("echo-msg.pd", patchesPath);
+      const echo = new Promise((resolve) => {
+        pd.subscribe(\`\${patch.$0}-float-echo\`, resolve);
+      });
+
+      pd.send(\`\${patch.$0}-float\`, 42);
+
+      return { timings, echo: await echo };
+    `);
+
+    ["pdInit", "paInitialize", "streamOpen", "firstCallback"].forEach((key) => {
+      assert.isNumber(result.timings[key]);
+      assert.isAtLeast(result.timings[key], 0);
+    });
+
+    assert.equal(result.echo, 42);
+  });
+
   it("pd.listDevices()", function () {
     console.log("list PortAudio devices");
     const devicesCount = pd.getDevicesCount();
@@ -58,6 +308,11 @@ describe("node-libpd", () => {
     console.log(devices);
   });
 
+  it("pd.refreshDevices()", function () {
+    assert.isFalse(pd.refreshDevices(), "should fail while stream is running");
+    assert.deepEqual(pd.listDevices(), pd.listDevices());
+  });
+
   it("pd.getDefaultInputDevice()", function () {
     const device = pd.getDefaultInputDevice();
     if (typeof device !== "undefined") {
@@ -248,6 +503,226 @@ describe("node-libpd", () => {
     assert.equal(openClosePatch2.$0, 0);
   });
 
+  it(`
+    pd.openPatchAsync(pathname)
+    pd.closePatchAsync(patch)
+  `, async function () {
+    const patch = await pd.openPatchAsync(
+      path.join(patchesPath, "open-close.pd")
+    );
+
+    assert.isTrue(patch.isValid);
+    assert.equal(patch.filename, "open-close.pd");
+    assert.equal(patch.path, patchesPath);
+    assert.isFinite(patch.$0);
+
+    const invalid = await pd.openPatchAsync("abcd.pd", patchesPath);
+    assert.isFalse(invalid.isValid);
+
+    const closed = await pd.closePatchAsync(patch);
+    assert.strictEqual(closed, patch);
+    assert.isFalse(patch.isValid);
+    assert.equal(patch.$0, 0);
+
+    console.log("closing twice should resolve");
+    await pd.closePatchAsync(patch);
+  });
+
+  it("pd.openPatchAsync(pathname) - parsed by the patch cache", async function () {
+    pd.enablePatchCache();
+
+    const patch = await pd.openPatchAsync("echo-msg-nolog.pd", patchesPath);
+    assert.isTrue(patch.isValid);
+    assert.notEqual(patch.$0, 0);
+
+    const echo = await new Promise((resolve) => {
+      pd.subscribe(`${patch.$0}-float-echo`, resolve);
+      pd.send(`${patch.$0}-float`, 42);
+    });
+
+    assert.equal(echo, 42);
+
+    pd.unsubscribe(`${patch.$0}-float-echo`);
+    await pd.closePatchAsync(patch);
+    pd.clearPatchCache();
+    pd.enablePatchCache(false);
+  });
+
+  it("pd.createPatchPool(pathname, size, options)", async function () {
+    const pathname = path.join(patchesPath, "poly-like.pd");
+    const pool = pd.createPatchPool(pathname, 4);
+
+    assert.equal(pool.size, 4);
+    assert.equal(pool.available, 4);
+
+    const voices = [];
+    for (let i = 0; i < 4; i++) voices.push(pool.acquire());
+
+    voices.forEach((voice) => assert.isTrue(voice.isValid));
+    assert.equal(new Set(voices.map((voice) => voice.$0)).size, 4);
+    assert.isNull(pool.acquire());
+    assert.equal(pool.available, 0);
+
+    assert.isTrue(pool.release(voices[0]));
+    assert.isFalse(pool.release(voices[0]), "can't release twice");
+    assert.strictEqual(pool.acquire(), voices[0]);
+
+    const size = await pool.grow(2);
+    assert.equal(size, 6);
+    assert.equal(pool.available, 2);
+
+    // closing a pooled instance directly removes it from the pool
+    pd.closePatch(voices[1]);
+    assert.equal(pool.size, 5);
+    assert.isFalse(pool.release(voices[1]));
+
+    const free = pool.acquire();
+    pd.closePatch(free);
+    assert.equal(pool.size, 4);
+    assert.equal(pool.available, 1);
+
+    pool.destroy();
+    voices.forEach((voice) => assert.isFalse(voice.isValid));
+
+    assert.isNull(pd.createPatchPool(path.join(patchesPath, "abcd.pd"), 4));
+
+    [-1, NaN, 1.5, "4"].forEach((invalid) => {
+      assert.throws(() => pd.createPatchPool(pathname, invalid));
+      assert.throws(() => pd.createPatchPool(pathname, 1, { grow: invalid }));
+    });
+
+    const other = pd.createPatchPool(pathname, 1);
+    let error = null;
+
+    try {
+      await other.grow(-2);
+    } catch (err) {
+      error = err;
+    }
+
+    assert.instanceOf(error, Error);
+    assert.equal(other.size, 1);
+    other.destroy();
+  });
+
+  it("pd.createPatchPool() - pooled instances should be functional", async function () {
+    // work on a copy, removed to make `grow` fail
+    const tmpPath = fs.mkdtempSync(path.join(os.tmpdir(), "node-libpd-"));
+    const pathname = path.join(tmpPath, "echo-msg-nolog.pd");
+    fs.copyFileSync(path.join(patchesPath, "echo-msg-nolog.pd"), pathname);
+
+    const echo = (patch, value) => {
+      return new Promise((resolve) => {
+        pd.subscribe(`${patch.$0}-float-echo`, (result) => {
+          pd.unsubscribe(`${patch.$0}-float-echo`);
+          resolve(result);
+        });
+
+        pd.send(`${patch.$0}-float`, value);
+      });
+    };
+
+    const pool = pd.createPatchPool(pathname, 1);
+    assert.isNotNull(pool);
+
+    const voice = pool.acquire();
+    assert.isTrue(voice.isValid);
+    assert.notEqual(voice.$0, 0);
+    assert.equal(await echo(voice, 42), 42);
+
+    assert.equal(await pool.grow(1), 2);
+    const grown = pool.acquire();
+    assert.notEqual(grown.$0, voice.$0);
+    assert.equal(await echo(grown, 43), 43);
+
+    fs.unlinkSync(pathname);
+    fs.rmdirSync(tmpPath);
+
+    let error = null;
+
+    try {
+      await pool.grow(2);
+    } catch (err) {
+      error = err;
+    }
+
+    assert.instanceOf(error, Error);
+    assert.equal(pool.size, 2);
+    pool.destroy();
+  });
+
+  it("pd.enablePatchCache()", function () {
+    pd.enablePatchCache();
+
+    // work on a copy, the fixture itself must not be touched
+    const tmpPath = fs.mkdtempSync(path.join(os.tmpdir(), "node-libpd-"));
+    const filename = path.join(tmpPath, "open-close.pd");
+    fs.copyFileSync(path.join(patchesPath, "open-close.pd"), filename);
+
+    const patches = [];
+    for (let i = 0; i < 3; i++) {
+      patches.push(pd.openPatch("open-close.pd", tmpPath));
+    }
+
+    patches.forEach((patch) => {
+      assert.isTrue(patch.isValid);
+      assert.notEqual(patch.$0, 0);
+    });
+    assert.equal(new Set(patches.map((patch) => patch.$0)).size, 3);
+
+    let stats = pd.getPatchCacheStats();
+    assert.isTrue(stats.enabled);
+    assert.equal(stats.entries, 1);
+    assert.equal(stats.misses, 1);
+    assert.equal(stats.hits, 2);
+
+    console.log("modified files should be read again");
+    const now = new Date();
+    fs.utimesSync(filename, now, new Date(now.getTime() + 1000));
+    patches.push(pd.openPatch("open-close.pd", tmpPath));
+
+    stats = pd.getPatchCacheStats();
+    assert.equal(stats.invalidations, 1);
+    assert.equal(stats.misses, 2);
+
+    assert.isFalse(pd.openPatch("abcd.pd", patchesPath).isValid);
+
+    patches.forEach((patch) => pd.closePatch(patch));
+    fs.unlinkSync(filename);
+    fs.rmdirSync(tmpPath);
+
+    pd.clearPatchCache();
+    assert.equal(pd.getPatchCacheStats().entries, 0);
+
+    pd.enablePatchCache(false);
+    assert.isFalse(pd.getPatchCacheStats().enabled);
+  });
+
+  it("pd.enablePatchCache() - cached instances should be functional", function (done) {
+    pd.enablePatchCache();
+
+    const miss = pd.openPatch("echo-msg-nolog.pd", patchesPath);
+    const hit = pd.openPatch("echo-msg-nolog.pd", patchesPath);
+
+    assert.isAtLeast(pd.getPatchCacheStats().hits, 1);
+    assert.isTrue(hit.isValid);
+    assert.notEqual(hit.$0, 0);
+    assert.notEqual(hit.$0, miss.$0);
+
+    pd.subscribe(`${hit.$0}-float-echo`, (value) => {
+      assert.equal(value, 42);
+
+      pd.unsubscribe(`${hit.$0}-float-echo`);
+      pd.closePatch(miss);
+      pd.closePatch(hit);
+      pd.clearPatchCache();
+      pd.enablePatchCache(false);
+      done();
+    });
+
+    pd.send(`${hit.$0}-float`, 42);
+  });
+
   it("pd.currentTime", function (done) {
     this.timeout(2000);
     let lastTime = pd.currentTime;
@@ -435,6 +910,318 @@ describe("node-libpd", () => {
     }, 10);
   });
 
+  it("pd.mailbox()", function (done) {
+    const patch = pd.openPatch("echo-msg-nolog.pd", patchesPath);
+    const mailbox = pd.mailbox(`${patch.$0}-float-echo`);
+    let received = 0;
+
+    assert.equal(mailbox.read(), null);
+    assert.equal(mailbox.count, 0);
+
+    // subscriptions of the channel are left untouched
+    pd.subscribe(`${patch.$0}-float-echo`, () => (received += 1));
+
+    for (let i = 1; i <= 10; i++) {
+      pd.send(`${patch.$0}-float`, i);
+    }
+
+    setTimeout(() => {
+      assert.equal(mailbox.read(), 10);
+      assert.equal(mailbox.count, 10);
+      assert.equal(received, 10);
+
+      mailbox.close();
+      pd.unsubscribe(`${patch.$0}-float-echo`);
+      pd.closePatch(patch);
+      done();
+    }, 200);
+  });
+
+  it("pd.unsubscribe() should skip messages in flight", function (done) {
+    const patch = pd.openPatch("echo-msg-nolog.pd", patchesPath);
+    const channel = `${patch.$0}-float-echo`;
+    let received = 0;
+
+    const callback = (value, name) => {
+      received += 1;
+      assert.equal(name, channel);
+      pd.unsubscribe(channel, callback);
+    };
+
+    pd.subscribe(channel, callback);
+
+    for (let i = 0; i < 100; i++) {
+      pd.send(`${patch.$0}-float`, i);
+    }
+
+    setTimeout(() => {
+      assert.equal(received, 1);
+      pd.closePatch(patch);
+      done();
+    }, 200);
+  });
+
+  it("pd.subscribe(channel, callback, options)", function (done) {
+    const patch = pd.openPatch("echo-msg-nolog.pd", patchesPath);
+    const received = [];
+
+    pd.subscribe(
+      `${patch.$0}-float-echo`,
+      (value) => received.push(value),
+      { coalesce: "latest", deadband: 10 }
+    );
+
+    for (let i = 0; i < 100; i++) {
+      pd.send(`${patch.$0}-float`, i);
+    }
+
+    setTimeout(() => {
+      console.log(`received ${received.length} messages`);
+
+      assert.isAbove(received.length, 0);
+      assert.isAtMost(received.length, 10);
+      assert.equal(received[received.length - 1], 90);
+
+      received.forEach((value, index) => {
+        assert.equal(value % 10, 0);
+
+        if (index > 0) {
+          assert.isAbove(value, received[index - 1]);
+        }
+      });
+
+      pd.unsubscribe(`${patch.$0}-float-echo`);
+      pd.closePatch(patch);
+      done();
+    }, 200);
+  });
+
+  it("pd.PdInternalMessages.Log | pd.getLogStats()", function (done) {
+    const patch = pd.openPatch("echo-msg.pd", patchesPath);
+    const before = pd.getLogStats();
+    let printed = 0;
+    let logged = 0;
+
+    const onPrint = (msg) => {
+      if (msg.startsWith("float:")) {
+        printed += 1;
+      }
+    };
+
+    const onLog = (entries) => {
+      assert.isArray(entries);
+
+      entries.forEach((entry) => {
+        if (entry.source === "pd:float") {
+          assert.equal(entry.level, "info");
+          assert.isNumber(entry.time);
+          logged += 1;
+        }
+      });
+    };
+
+    pd.subscribe(pd.PdInternalMessages.Print, onPrint);
+    pd.subscribe(pd.PdInternalMessages.Log, onLog);
+
+    // above the default rate limit of 50 lines per second
+    for (let i = 0; i < 200; i++) {
+      pd.send(`${patch.$0}-float`, i);
+    }
+
+    setTimeout(() => {
+      const stats = pd.getLogStats();
+      console.log(stats);
+
+      assert.isAbove(logged, 0);
+      assert.isBelow(logged, 200);
+      assert.equal(printed, logged);
+      assert.isAbove(stats.suppressed, before.suppressed);
+
+      pd.unsubscribe(pd.PdInternalMessages.Print, onPrint);
+      pd.unsubscribe(pd.PdInternalMessages.Log, onLog);
+      pd.closePatch(patch);
+      done();
+    }, 200);
+  });
+
+  it("pd.getQueueStats()", function (done) {
+    const patch = pd.openPatch("echo-msg-nolog.pd", patchesPath);
+    const before = pd.getQueueStats();
+    const numMessages = 20;
+    let received = 0;
+
+    ["receive", "send"].forEach((direction) => {
+      const stats = before[direction];
+      assert.equal(stats.capacity, null);
+      assert.equal(stats.policy, "dropNewest");
+      assert.isAtMost(stats.depth, stats.highWater);
+      assert.equal(stats.dropped, 0);
+      assert.equal(stats.coalesced, 0);
+    });
+
+    pd.subscribe(`${patch.$0}-float-echo`, () => {
+      received += 1;
+
+      if (received === numMessages) {
+        const stats = pd.getQueueStats();
+        console.log(stats);
+
+        assert.equal(stats.send.pushed - before.send.pushed, numMessages);
+        assert.isAtLeast(stats.receive.pushed - before.receive.pushed, numMessages);
+        assert.isAtLeast(stats.send.highWater, 1);
+        assert.equal(stats.send.dropped, 0);
+
+        pd.unsubscribe(`${patch.$0}-float-echo`);
+        pd.closePatch(patch);
+        done();
+      }
+    });
+
+    for (let i = 0; i < numMessages; i++) {
+      pd.send(`${patch.$0}-float`, i);
+    }
+  });
+
+  // queues bounded to 4 messages, overflowed with the event loop blocked
+  [
+    {
+      policy: "dropNewest",
+      // the messages pushed once the queue is full are discarded
+      sent: [0, 1, 2, 3],
+      received: [["float", 0], ["float", 1], ["symbol", "a"], ["float", 2]],
+      send: { dropped: 2, coalesced: 0 },
+      receive: { dropped: 5, coalesced: 0 },
+    },
+    {
+      policy: "dropOldest",
+      sent: [2, 3, 4, 5],
+      received: [["float", 4], ["float", 5], ["symbol", "b"], ["list", [1, 2]]],
+      send: { dropped: 2, coalesced: 0 },
+      receive: { dropped: 5, coalesced: 0 },
+    },
+    {
+      policy: "coalesce",
+      // the last queued message of the channel is replaced in place, the
+      // list is dropped as no list is queued
+      sent: [0, 1, 2, 5],
+      received: [["float", 0], ["float", 1], ["symbol", "b"], ["float", 5]],
+      send: { dropped: 0, coalesced: 2 },
+      receive: { dropped: 1, coalesced: 4 },
+    },
+  ].forEach((expected) => {
+    it(`pd.getQueueStats() - ${expected.policy} overflow`, async function () {
+      this.timeout(10000);
+
+      const result = await runIsolated(`
+        const queue = { capacity: 4, policy: "${expected.policy}" };
+        pd.init({
+          numInputChannels: 0,
+          numOutputChannels: 1,
+          sampleRate: 48000,
+          receiveQueue: queue,
+          sendQueue: queue,
+        });
+
+        const patch = pd.openPatch("echo-msg-nolog.pd", patchesPath);
+        const received = [];
+        const sleep = (ms) => new Promise((resolve) => setTimeout(resolve, ms));
+        const block = (ms) => {
+          const end = Date.now() + ms;
+          while (Date.now() < end) {}
+        };
+
+        ["float", "symbol", "list"].forEach((type) => {
+          pd.subscribe(\`\${patch.$0}-\${type}-echo\`, (value) => {
+            received.push([type, value]);
+          });
+        });
+
+        // send queue: scheduled messages stay queued until they are due
+        const time = pd.currentTime + 0.2;
+
+        for (let i = 0; i < 6; i++) {
+          pd.send(\`\${patch.$0}-float\`, i, time);
+        }
+
+        await sleep(500);
+
+        const sent = received.splice(0).map(([type, value]) => value);
+
+        // receive queue: pd replies while the event loop is blocked, each
+        // message is delivered before the next one is sent
+        const messages = [
+          ["float", 0], ["float", 1], ["symbol", "a"], ["float", 2],
+          ["float", 3], ["float", 4], ["float", 5], ["symbol", "b"],
+          ["list", [1, 2]],
+        ];
+
+        messages.forEach(([type, value]) => {
+          pd.send(\`\${patch.$0}-\${type}\`, value);
+          block(20);
+        });
+
+        await sleep(200);
+
+        return { sent, received, ...pd.getQueueStats() };
+      `);
+
+      assert.deepEqual(result.sent, expected.sent);
+      assert.deepEqual(result.received, expected.received);
+
+      ["send", "receive"].forEach((direction) => {
+        const stats = result[direction];
+
+        assert.equal(stats.capacity, 4);
+        assert.equal(stats.policy, expected.policy);
+        assert.equal(stats.highWater, 4);
+        assert.equal(stats.dropped, expected[direction].dropped);
+        assert.equal(stats.coalesced, expected[direction].coalesced);
+      });
+
+      assert.equal(result.send.pushed, 6 + 9);
+      assert.equal(result.receive.pushed, 4 + 9);
+    });
+  });
+
+  it("pd.enableLatencyTracing() | pd.getLatencyStats()", function (done) {
+    const patch = pd.openPatch("echo-msg-nolog.pd", patchesPath);
+    const numMessages = 100;
+    let received = 0;
+
+    pd.enableLatencyTracing();
+    pd.resetLatencyStats();
+
+    pd.subscribe(`${patch.$0}-float-echo`, () => {
+      received += 1;
+
+      if (received === numMessages) {
+        const stats = pd.getLatencyStats();
+        console.log(stats);
+
+        ["send", "inject"].forEach((stage) => {
+          assert.equal(stats[stage].count, numMessages);
+          assert.isAtMost(stats[stage].p50, stats[stage].max);
+        });
+
+        // each reply is matched with the message it answers
+        assert.equal(stats.pd.count, numMessages);
+        assert.isAtMost(stats.pd.p50, stats.pd.max);
+
+        // the last dispatch is recorded right before this callback
+        assert.isAtLeast(stats.dispatch.count, numMessages);
+
+        pd.enableLatencyTracing(false);
+        pd.unsubscribe(`${patch.$0}-float-echo`);
+        pd.closePatch(patch);
+        done();
+      }
+    });
+
+    for (let i = 0; i < numMessages; i++) {
+      pd.send(`${patch.$0}-float`, i);
+    }
+  });
+
   it("pd.addToSearchPath(absPath)", function () {
     console.log("> should not log errors");
     pd.addToSearchPath(path.join(patchesPath, "rj"));
@@ -487,6 +1274,321 @@ describe("node-libpd", () => {
     console.log(dest);
   });
 
+  it("pd.writeArrayAtomic(name, data, { offset, time })", function (done) {
+    const patch = pd.openPatch("array-test.pd", patchesPath);
+    const size = pd.arraySize("my-array");
+    pd.clearArray("my-array", 0);
+
+    const source = new Float32Array(10);
+    for (let i = 0; i < source.length; i++) source[i] = i + 1;
+
+    assert.isFalse(pd.writeArrayAtomic("do-not-exists", source));
+    assert.isFalse(pd.writeArrayAtomic("my-array", source, { offset: size }));
+
+    const time = pd.currentTime + 0.1;
+    const scheduled = pd.writeArrayAtomic("my-array", source, { offset: 10, time });
+    assert.isTrue(scheduled);
+
+    const dest = new Float32Array(size);
+    pd.readArray("my-array", dest);
+    assert.equal(dest[10], 0, "values should not be applied before time");
+
+    setTimeout(() => {
+      pd.readArray("my-array", dest);
+      assert.deepEqual(dest.subarray(10, 20), source);
+      pd.closePatch(patch);
+      done();
+    }, 300);
+  });
+
+  it("pd.readArrays(reads)", function () {
+    const patch = pd.openPatch("array-test.pd", patchesPath);
+    const size = pd.arraySize("my-array");
+    const source = new Float32Array(size);
+    for (let i = 0; i < size; i++) source[i] = i;
+    pd.writeArray("my-array", source);
+
+    const full = new Float32Array(size);
+    const part = new Float32Array(4);
+    const missing = new Float32Array(4);
+
+    const results = pd.readArrays([
+      { name: "my-array", target: full },
+      { name: "my-array", target: part, offset: 10 },
+      { name: "do-not-exists", target: missing },
+      { name: "my-array", target: missing, offset: size - 2 },
+    ]);
+
+    assert.deepEqual(results, [true, true, false, false]);
+    assert.deepEqual(full, source);
+    assert.deepEqual(Array.from(part), [10, 11, 12, 13]);
+
+    pd.closePatch(patch);
+  });
+
+  it(`
+    pd.writeArrayAsync(name, data, options)
+    pd.readArrayAsync(name, dest, options)
+  `, async function () {
+    const patch = pd.openPatch("array-test.pd", patchesPath);
+    const size = pd.arraySize("my-array");
+    const source = new Float32Array(size);
+    for (let i = 0; i < size; i++) source[i] = Math.random();
+
+    let lastProgress = 0;
+    const written = await pd.writeArrayAsync("my-array", source, {
+      chunkSize: 16,
+      onProgress: (progress) => {
+        assert.isAtLeast(progress, lastProgress);
+        lastProgress = progress;
+      },
+    });
+    assert.strictEqual(written, source);
+
+    const dest = await pd.readArrayAsync("my-array", new Float32Array(size), {
+      chunkSize: 16,
+    });
+    assert.deepEqual(dest, source);
+
+    let rejected = false;
+    try {
+      await pd.writeArrayAsync("do-not-exists", source);
+    } catch (err) {
+      rejected = true;
+    }
+    assert.isTrue(rejected);
+
+    pd.closePatch(patch);
+  });
+
+  it("pd.readArrayAsync() should not hold the libuv threadpool", async function () {
+    const patch = pd.openPatch("array-test.pd", patchesPath);
+    const size = pd.arraySize("my-array");
+    let settled = 0;
+
+    // one element per tick, i.e. pending for a while
+    const transfers = [];
+    for (let i = 0; i < 8; i++) {
+      const promise = pd.readArrayAsync("my-array", new Float32Array(size), {
+        chunkSize: 1,
+      });
+      transfers.push(promise.then(() => (settled += 1)));
+    }
+
+    // would wait for a transfer to finish if they were polled from the pool
+    await fs.promises.stat(patchesPath);
+    assert.equal(settled, 0);
+
+    await Promise.all(transfers);
+    assert.equal(settled, 8);
+
+    pd.closePatch(patch);
+  });
+
+  it("pd.arrayView(name)", function () {
+    const patch = pd.openPatch("array-test.pd", patchesPath);
+    const size = pd.arraySize("my-array");
+
+    assert.isNull(pd.arrayView("do-not-exists"));
+
+    const view = pd.arrayView("my-array");
+    assert.equal(view.length, size);
+    assert.isTrue(view.isValid);
+    assert.equal(view.data.length, size * view.stride);
+
+    console.log("write through the view, read back with readArray");
+    for (let i = 0; i < size; i++) view.set(i, i / size);
+
+    const dest = new Float32Array(size);
+    pd.readArray("my-array", dest);
+
+    for (let i = 0; i < size; i++) {
+      assert.equal(dest[i], view.get(i));
+    }
+
+    console.log("view should be detached when the patch is closed");
+    pd.closePatch(patch);
+    assert.isFalse(view.isValid);
+    assert.equal(view.data.length, 0);
+  });
+
+  it("pd.arrayView(name) - resized by pd", function (done) {
+    const patch = pd.openPatch("array-resize.pd", patchesPath);
+    const view = pd.arrayView("resize-array");
+    assert.equal(view.length, 10);
+
+    // [array size] reallocates the array when the message is delivered
+    pd.send("resize-array-size", 20);
+
+    setTimeout(() => {
+      // detached by the background process, `isValid` would check again
+      assert.equal(view.data.length, 0);
+      assert.isFalse(view.isValid);
+      assert.equal(pd.arraySize("resize-array"), 20);
+
+      pd.closePatch(patch);
+      done();
+    }, 100);
+  });
+
+  it("pd.loadSoundfile(arrayName, pathname, options)", async function () {
+    const patch = pd.openPatch("array-test.pd", patchesPath);
+    const size = pd.arraySize("my-array");
+
+    // write a stereo 16 bits wav file, left channel is a ramp
+    const numFrames = size * 2;
+    const buffer = Buffer.alloc(44 + numFrames * 4);
+    buffer.write("RIFF", 0);
+    buffer.writeUInt32LE(36 + numFrames * 4, 4);
+    buffer.write("WAVEfmt ", 8);
+    buffer.writeUInt32LE(16, 16);
+    buffer.writeUInt16LE(1, 20); // PCM
+    buffer.writeUInt16LE(2, 22); // channels
+    buffer.writeUInt32LE(44100, 24);
+    buffer.writeUInt32LE(44100 * 4, 28);
+    buffer.writeUInt16LE(4, 32);
+    buffer.writeUInt16LE(16, 34);
+    buffer.write("data", 36);
+    buffer.writeUInt32LE(numFrames * 4, 40);
+
+    for (let i = 0; i < numFrames; i++) {
+      buffer.writeInt16LE(i, 44 + i * 4);
+      buffer.writeInt16LE(-1000, 44 + i * 4 + 2);
+    }
+
+    const filename = path.join(os.tmpdir(), "node-libpd-test.wav");
+    fs.writeFileSync(filename, buffer);
+
+    console.log("load first channel, soundfile is truncated");
+    const infos = await pd.loadSoundfile("my-array", filename);
+    assert.equal(infos.numChannels, 2);
+    assert.equal(infos.sampleRate, 44100);
+    assert.equal(infos.numFrames, size);
+    assert.equal(pd.arraySize("my-array"), size);
+
+    const dest = new Float32Array(size);
+    pd.readArray("my-array", dest);
+    for (let i = 0; i < size; i++) assert.equal(dest[i], i / 32768);
+
+    console.log("load second channel and resize the array");
+    const view = pd.arrayView("my-array");
+    const loading = pd.loadSoundfile("my-array", filename, { channel: 1, resize: true });
+    // detached as soon as the load starts, the storage is reallocated
+    assert.isFalse(view.isValid);
+    assert.equal(view.data.length, 0);
+    assert.isNull(pd.arrayView("my-array"));
+    await loading;
+    assert.equal(pd.arraySize("my-array"), numFrames);
+    assert.equal(pd.arrayView("my-array").length, numFrames);
+
+    const resized = new Float32Array(numFrames);
+    pd.readArray("my-array", resized);
+    for (let i = 0; i < numFrames; i++) assert.equal(resized[i], -1000 / 32768);
+
+    let rejected = false;
+    try {
+      await pd.loadSoundfile("my-array", filename, { channel: 2 });
+    } catch (err) {
+      rejected = true;
+    }
+    assert.isTrue(rejected);
+
+    console.log("malformed headers should reject instead of crashing");
+    const malformed = [
+      buffer.subarray(0, 30), // truncated format chunk
+      Buffer.from(buffer), // no channel
+      Buffer.from(buffer), // 4 bits samples
+    ];
+    malformed[1].writeUInt16LE(0, 22);
+    malformed[2].writeUInt16LE(4, 34);
+
+    const malformedFilename = path.join(os.tmpdir(), "node-libpd-malformed.wav");
+
+    for (const content of malformed) {
+      fs.writeFileSync(malformedFilename, content);
+      let error = null;
+
+      try {
+        await pd.loadSoundfile("my-array", malformedFilename);
+      } catch (err) {
+        error = err;
+      }
+
+      assert.instanceOf(error, Error);
+    }
+
+    fs.unlinkSync(malformedFilename);
+
+    console.log("8 bit AIFC (sowt) samples are signed");
+    const aiff = Buffer.alloc(12 + 32 + 16 + 4);
+    aiff.write("FORM", 0);
+    aiff.writeUInt32BE(aiff.length - 8, 4);
+    aiff.write("AIFCCOMM", 8);
+    aiff.writeUInt32BE(24, 16);
+    aiff.writeUInt16BE(1, 20); // channels
+    aiff.writeUInt32BE(4, 22); // frames
+    aiff.writeUInt16BE(8, 26); // bits
+    Buffer.from([0x40, 0x0e, 0xac, 0x44, 0, 0, 0, 0, 0, 0]).copy(aiff, 28); // 44100
+    aiff.write("sowt", 38);
+    aiff.write("SSND", 44);
+    aiff.writeUInt32BE(8 + 4, 48);
+    aiff.writeInt8(-64, 60);
+    aiff.writeInt8(64, 61);
+    aiff.writeInt8(-128, 62);
+    aiff.writeInt8(0, 63);
+
+    const aiffFilename = path.join(os.tmpdir(), "node-libpd-test.aif");
+    fs.writeFileSync(aiffFilename, aiff);
+
+    await pd.loadSoundfile("my-array", aiffFilename, { resize: true });
+    const signed = new Float32Array(4);
+    pd.readArray("my-array", signed);
+    assert.deepEqual(Array.from(signed), [-0.5, 0.5, -1, 0]);
+
+    fs.unlinkSync(aiffFilename);
+    fs.unlinkSync(filename);
+    pd.closePatch(patch);
+  });
+
+  it(`
+    pd.trackArrayChanges(name, options)
+    pd.readArrayChanges(name, dest)
+  `, function () {
+    const patch = pd.openPatch("array-test.pd", patchesPath);
+    const size = pd.arraySize("my-array");
+    const dest = new Float32Array(size);
+
+    assert.isNull(pd.readArrayChanges("my-array", dest));
+
+    pd.trackArrayChanges("my-array");
+    assert.deepEqual(pd.readArrayChanges("my-array", dest), [[0, size]]);
+    assert.deepEqual(pd.readArrayChanges("my-array", dest), []);
+
+    console.log("writes from js should be reported");
+    pd.writeArray("my-array", new Float32Array([1, 2, 3]));
+    assert.deepEqual(pd.readArrayChanges("my-array", dest), [[0, 3]]);
+    assert.deepEqual(Array.from(dest.subarray(0, 3)), [1, 2, 3]);
+
+    console.log("writes through a view should be reported in compare mode");
+    const view = pd.arrayView("my-array");
+    view.set(10, 0.5);
+    view.set(11, 0.5);
+    assert.deepEqual(pd.readArrayChanges("my-array", dest), [[10, 2]]);
+    assert.equal(dest[11], 0.5);
+
+    console.log("...and not reported without compare");
+    pd.trackArrayChanges("my-array", { compare: false });
+    assert.deepEqual(pd.readArrayChanges("my-array", dest), [[0, size]]);
+    view.set(20, 0.5);
+    assert.deepEqual(pd.readArrayChanges("my-array", dest), []);
+
+    assert.isNull(pd.readArrayChanges("my-array", new Float32Array(1)));
+
+    pd.untrackArrayChanges("my-array");
+    assert.isNull(pd.readArrayChanges("my-array", dest));
+    pd.closePatch(patch);
+  });
+
   // // --------------------------------------------------------
   // // AUDIO
   // // --------------------------------------------------------